@@ -1,8 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "interner.h"
+
+/* Kinds of AST nodes (replaces the old string "type" field) */
+enum class NodeKind : std::uint8_t {
+    Program, Definitions, Instructions,
+    FunctionDefinition, FormalParameterList, FunctionBody,
+    // Statements and suites
+    Affect, Return, Print, If, IfBody, ElseBody, For, ForBody, While, WhileBody,
+    // Expressions
+    Identifier, Integer, String, True, False, None, List, ListCall,
+    FunctionCall, ParameterList, Or, And, Not, Compare, ArithOp, TermOp, UnaryOp, Negative,
+    // Parser scaffolding, retyped once the enclosing rule is done
+    Suite
+};
+
+const char* nodeKindName(NodeKind kind);
+
+/* Type résolu d'une expression, posé sur le noeud par la passe de typage (TypeAnnotator) */
+enum class ValueType : std::uint8_t {
+    Auto,       // pas encore connu
+    AutoFun,    // retour de fonction que l'inférence n'a pas pu résoudre
+    Integer, String, List, Boolean,
+    Void        // print()
+};
+
+const char* valueTypeName(ValueType type);
+// Inverse de valueTypeName pour les types stockés en texte dans la table des symboles
+ValueType valueTypeOf(std::string_view name);
+
+struct ASTNode;
+
+/* Span of child pointers living in the arena; grows by reallocation inside the arena */
+class NodeList {
+public:
+    using iterator = ASTNode**;
+    using reverse_iterator = std::reverse_iterator<ASTNode**>;
+
+    iterator begin() const { return m_data; }
+    iterator end() const { return m_data + m_size; }
+    reverse_iterator rbegin() const { return reverse_iterator(end()); }
+    reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    ASTNode*& operator[](std::size_t i) const { return m_data[i]; }
+    ASTNode* front() const { return m_data[0]; }
+    ASTNode* back() const { return m_data[m_size - 1]; }
+
+    // Removes the child at index, shifting the following ones (no reallocation)
+    void erase(std::size_t index);
+
+private:
+    friend class ASTArena;
+    ASTNode** m_data = nullptr;
+    std::uint32_t m_size = 0;
+    std::uint32_t m_capacity = 0;
+};
+
+/* AST node, allocated in an ASTArena and never freed individually */
 struct ASTNode {
-    std::string type;
-    std::string value;
-    std::vector<std::shared_ptr<ASTNode>> children;
-    std::string line = ""; // Changed from "0" to an empty string
+    NodeKind kind;
+    ValueType type = ValueType::Auto;        // Set by the typing pass, read by the code generator
+    int line = 0;                            // Line number for error reporting
+    Interner::Id nameId = Interner::kNoId;   // Interned name (Identifier, FunctionDefinition)
+    std::string_view value;                  // Name, literal or operator text (arena/interner storage)
+    NodeList children;
+
+    bool hasName() const { return nameId != Interner::kNoId; }
+};
+
+/* Bump allocator owning every node, child span and literal of one compilation */
+class ASTArena {
+public:
+    explicit ASTArena(Interner& names) : m_names(names) {}
+    ASTArena(const ASTArena&) = delete;
+    ASTArena& operator=(const ASTArena&) = delete;
+
+    ASTNode* make(NodeKind kind, int line = 0, std::string_view value = {});
+    ASTNode* makeName(NodeKind kind, std::string_view name, int line = 0); // interns the name
+    ASTNode* makeName(NodeKind kind, Interner::Id id, int line = 0);       // name already interned (lexer)
+    void rename(ASTNode* node, std::string_view name);
+    void rename(ASTNode* node, Interner::Id id);
+
+    void append(ASTNode* parent, ASTNode* child);
+    // Inserts child before the child at index (appends if index is past the end)
+    void insert(ASTNode* parent, std::size_t index, ASTNode* child);
+    // Deep copy of a subtree (names and literals are shared, not copied)
+    ASTNode* clone(const ASTNode* node);
+
+    Interner& names() { return m_names; }
+    const Interner& names() const { return m_names; }
+
+    // Statistics (benchmarks)
+    std::size_t nodeCount() const { return m_nodeCount; }
+    std::size_t bytesUsed() const { return m_bytesUsed; }
+    std::size_t bytesReserved() const { return m_bytesReserved; }
+
+private:
+    static constexpr std::size_t kBlockSize = 64 * 1024;
+
+    Interner& m_names;
+    std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+    std::byte* m_cursor = nullptr;
+    std::size_t m_remaining = 0;
+    std::size_t m_nodeCount = 0;
+    std::size_t m_bytesUsed = 0;
+    std::size_t m_bytesReserved = 0;
 
-    // ...existing fields and member functions...
+    void* allocate(std::size_t size, std::size_t align);
+    std::string_view store(std::string_view text);
 };
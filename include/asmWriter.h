@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* Destination du texte assembleur produit par le générateur */
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+    virtual void write(std::string_view text) = 0;
+    virtual void flush() {}
+};
+
+/* Écriture bufferisée dans un fichier. Le fichier n'est gardé que si close() est appelé :
+ * détruit avant (exception pendant la génération), le fichier partiel est supprimé. */
+class FileSink final : public OutputSink {
+public:
+    explicit FileSink(const std::string& path);
+    ~FileSink() override;
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    void write(std::string_view text) override;
+    void flush() override;
+    void close();
+
+private:
+    static constexpr std::size_t kBufferSize = 64 * 1024;
+
+    std::string m_path;
+    std::FILE* m_file = nullptr;
+    std::unique_ptr<char[]> m_buffer;
+    std::size_t m_used = 0;
+
+    void writeRaw(const char* data, std::size_t size);
+};
+
+/* Sortie en mémoire (tests, outils) */
+class StringSink final : public OutputSink {
+public:
+    void write(std::string_view text) override { m_text.append(text); }
+    const std::string& str() const { return m_text; }
+
+private:
+    std::string m_text;
+};
+
+/* Section assembleur construite par morceaux : un ajout ne recopie jamais le texte déjà écrit,
+ * et la section se vide dans un OutputSink sans être d'abord concaténée en une seule chaîne. */
+class AsmSection {
+public:
+    AsmSection& operator+=(std::string_view text);
+    // Reprend les morceaux d'une autre section, sans copie
+    void append(AsmSection&& other);
+
+    void writeTo(OutputSink& sink) const;
+    void clear();
+    bool empty() const { return m_size == 0; }
+    std::size_t size() const { return m_size; }
+
+private:
+    // Les morceaux grandissent avec la section : petites fonctions sans gros tampons réservés
+    static constexpr std::size_t kMinChunk = 256;
+    static constexpr std::size_t kMaxChunk = 64 * 1024;
+
+    std::vector<std::string> m_chunks;
+    std::size_t m_size = 0;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ASTNode.h"
+#include "callGraph.h"
+#include "symbolTable.h"
+
+/* Questions sur l'AST typé communes aux passes qui analysent ou réécrivent le programme : ce qui
+ * est pur (expressions et fonctions), ce qui peut échouer, et l'ajout de temporaires dans un cadre.
+ * Une seule définition, pour que les passes ne se contredisent pas. */
+
+// Suite d'instructions : programme principal, corps de fonction, de if / else, de boucle
+bool isBlock(const ASTNode* node);
+
+// Arguments d'un appel ; nullptr si l'appel n'en a pas
+const NodeList* argumentsOf(const ASTNode* call);
+bool isCallTo(const ASTNode* node, std::string_view name);
+bool isLen(const ASTNode* node);
+// range(len(L)), L une variable : le générateur en parcourt les indices sans rien évaluer (boucle
+// vectorisée) ; les passes laissent len(L) en place pour qu'il la reconnaisse
+bool isIndexRange(const ASTNode* iterable);
+// len, list, range : fournies par le générateur, jamais définies par le programme
+bool isBuiltin(std::string_view name);
+// Appel d'une fonction du programme (ni len, ni list, ni range) : peut afficher ou échouer
+bool isUserCall(const ASTNode* node);
+/* Fonctions pures, indexées comme le graphe d'appels : une fonction est pure si elle n'affiche rien,
+ * ne lit ni n'écrit aucune variable globale, ne modifie aucun élément de liste et n'appelle que des
+ * fonctions pures ou des builtins. Son résultat ne dépend que de ses arguments. */
+std::vector<bool> analysePurity(const SymbolTable& globals, const CallGraph& callGraph);
+// Appel d'une fonction du programme qui n'est pas pure au sens de analysePurity
+bool isImpureCall(const ASTNode* node, const CallGraph& callGraph, const std::vector<bool>& pure);
+
+// Opération qui peut arrêter le programme : indice hors bornes, division par zéro
+bool canFail(const ASTNode* node);
+// canFail pour l'un des noeuds de l'expression
+bool mayFail(const ASTNode* node);
+// Le noeud lui-même peut afficher ou arrêter le programme : appel de fonction du programme, ou canFail
+bool mayPrintOrStop(const ASTNode* node);
+
+// Aucun effet, aucune allocation, aucune écriture dans concat_buffer : la valeur ne dépend que des
+// variables et des éléments de liste lus
+bool isPureExpression(const ASTNode* node);
+// Opération pure dont le calcul vaut d'être gardé dans une temporaire (ni feuille, ni -<littéral>)
+bool isReusableExpression(const ASTNode* node);
+
+// Variables et éléments de liste lus, ou écrits, par un fragment du programme. Les listes pouvant
+// être partagées, toute écriture d'élément change toutes les lectures d'éléments.
+struct Accesses {
+    std::vector<Interner::Id> variables;
+    bool lists = false;
+};
+// Clé de structure, type compris : deux expressions pures de même clé ont la même valeur tant
+// qu'aucune de leurs lectures ne change. Relève ces lectures dans reads s'il est donné.
+void structureKey(const ASTNode* node, std::string& key, Accesses* reads = nullptr);
+// Écritures de node : variables affectées (ou de for), éléments affectés, appels de fonctions impures
+void collectWrites(const ASTNode* node, const CallGraph& callGraph, const std::vector<bool>& pure, Accesses& writes);
+// Les écritures writes changent-elles une des lectures reads ?
+bool changes(const Accesses& writes, const Accesses& reads);
+
+// visit(opérande, conditional) pour chaque opérande de node, dans l'ordre où le générateur les
+// évalue ; conditional : opérande droit d'un and / or, qui peut ne pas être évalué
+template <typename Visit>
+void forEachOperand(ASTNode* node, Visit&& visit) {
+    NodeList& children = node->children;
+    if (node->kind == NodeKind::And || node->kind == NodeKind::Or) {
+        if (!children.empty()) visit(children[0], false);
+        for (std::size_t c = 1; c < children.size(); ++c) visit(children[c], true);
+    } else if (node->kind == NodeKind::ListCall) {
+        for (std::size_t c = children.size(); c-- > 0;) visit(children[c], false); // indice d'abord
+    } else if (node->kind == NodeKind::FunctionCall) {
+        if (const NodeList* args = argumentsOf(node)) {
+            for (std::size_t i = args->size(); i-- > 0;) visit((*args)[i], false); // empilés à l'envers
+        }
+    } else {
+        for (ASTNode*& child : children) visit(child, false);
+    }
+}
+
+// Fonction (ou programme principal) qui reçoit des temporaires
+struct FrameScope {
+    SymbolTable* scope = nullptr;
+    FunctionSymbol* function = nullptr;     // nullptr : programme principal, temporaires globales
+    int nextOffset = -8;                    // prochain local libre sous rbp
+};
+
+// Cadre de la fonction def, les temporaires placées sous les locaux déjà attribués ; faux sans table
+bool enterFunction(FrameScope& frame, SymbolTable& globals, const ASTNode* def);
+// Nouvelle variable <prefix><n> (n à partir de counter, jamais un nom du source) : un local de plus
+// dans le cadre, ou une globale pour le programme principal
+Interner::Id addTemporary(FrameScope& frame, const Interner& names, std::string_view prefix, std::size_t& counter);
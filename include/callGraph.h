@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "ASTNode.h"
+
+/* Graphe d'appels du programme aplati par SemanticAnalyzer::firstPass : un sommet par fonction
+ * (nom décoré), une arête par appelé distinct. Le programme principal n'est pas un sommet ; ses
+ * appels sont les racines de l'accessibilité. Sert à l'élimination des fonctions mortes, et aux
+ * analyses qui ont besoin de savoir qui appelle qui (récursivité, inlining). */
+class CallGraph {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    void build(const ASTNode* root);
+
+    std::size_t size() const { return m_functions.size(); }
+    std::size_t indexOf(Interner::Id name) const;                // npos si ce n'est pas une fonction définie
+    const ASTNode* definition(std::size_t f) const { return m_functions[f].definition; }
+
+    // Appelés distincts, dans l'ordre du premier appel
+    const std::vector<std::size_t>& callees(std::size_t f) const { return m_functions[f].callees; }
+    const std::vector<std::size_t>& mainCallees() const { return m_mainCallees; }
+    // Nombre de sites d'appel visant f, programme principal compris
+    std::size_t callSites(std::size_t f) const { return m_functions[f].callSites; }
+
+    bool reachable(std::size_t f) const { return m_functions[f].reachable; }
+    bool reachable(Interner::Id name) const;                      // faux pour un nom inconnu
+    // f appartient à un cycle du graphe (appel direct à elle-même compris)
+    bool recursive(std::size_t f) const { return m_functions[f].recursive; }
+
+    std::size_t reachableCount() const;
+    std::size_t recursiveCount() const;
+
+private:
+    struct Function {
+        const ASTNode* definition = nullptr;
+        std::vector<std::size_t> callees;
+        std::size_t callSites = 0;
+        bool reachable = false;
+        bool recursive = false;
+    };
+
+    std::vector<Function> m_functions;
+    std::vector<std::size_t> m_mainCallees;
+    std::unordered_map<Interner::Id, std::size_t> m_index;
+
+    void collectCalls(const ASTNode* body, std::vector<std::size_t>& callees);
+    void markReachable();
+    void markRecursive();
+};
@@ -1,26 +1,54 @@
 #pragma once
 
+#include <exception>
 #include <memory>
 #include <string>
 #include <set>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "asmWriter.h"
+#include "callGraph.h"
 #include "parser.h"
+#include "runtime.h"
 #include "symbolTable.h"  // Ensure this is included
 #include "errorManager.h"
 
+// Unrolling of `for i in range(K)` loops with a literal K
+struct UnrollLimits {
+    unsigned factor = 4;        // body copies per iteration of a partially unrolled loop (< 2: never partially)
+    std::size_t maxSize = 64;   // AST nodes copied at most, all copies together (0: no unrolling)
+};
+
 class CodeGenerator {
 public:
-    explicit CodeGenerator(ErrorManager& errorManager) : m_errorManager(errorManager), symbolTable(nullptr), currentSymbolTable(nullptr), rootNode(nullptr), labelCounter(0), loopLabelCounter(0), ifLabelCounter(0), stringLabelCounter(0) {}
+    explicit CodeGenerator(ErrorManager& errorManager) : m_errorManager(errorManager), symbolTable(nullptr), currentSymbolTable(nullptr), labelCounter(0), loopLabelCounter(0), ifLabelCounter(0), m_jobs(1) {}
     
     // Updated to accept symbol table parameter
-    void generateCode(const std::shared_ptr<ASTNode>& root, const std::string& filename, 
-                      SymbolTable* symTable); // Made symTable non-optional for clarity
-	static inline bool isNumeric(const std::string& t) {
-    return t == "Integer" || t == "Boolean" || t == "auto" || t == "autoFun";
+    // The AST must have been annotated by TypeAnnotator: expression types are read from ASTNode::type.
+    // Neither the AST types nor the symbol table are modified here, so the output does not depend on
+    // the order in which functions are emitted.
+    void generateCode(ASTNode* root, const std::string& filename, 
+                      const SymbolTable* symTable); // Made symTable non-optional for clarity
+    // Same, streamed to any sink (file, memory)
+    void generateCode(ASTNode* root, OutputSink& out, const SymbolTable* symTable);
+    // Number of threads generating functions concurrently (1 = serial)
+    void setJobs(unsigned jobs) { m_jobs = jobs ? jobs : 1; }
+    // Library: runtime helpers are left to the pyasm_rt library the program is linked with
+    void setRuntimeLinkage(RuntimeLinkage linkage) { m_runtimeLinkage = linkage; }
+    // Functions unreachable in this call graph are skipped (nullptr: every definition is generated)
+    void setCallGraph(const CallGraph* callGraph) { m_callGraph = callGraph; }
+    // Output already computed at compile time (--partial-eval), written in one syscall when the program starts
+    void setPrerenderedOutput(std::string output) { m_prerenderedOutput = std::move(output); }
+    void setUnrolling(UnrollLimits limits) { m_unroll = limits; }
+    // Integer reductions and element-wise maps over lists are compiled to SSE2 loops
+    void setVectorize(bool vectorize) { m_vectorize = vectorize; }
+    // An if/else assigning one variable from side-effect-free expressions selects the value with cmov
+    void setBranchless(bool branchless) { m_branchless = branchless; }
+	static inline bool isNumeric(ValueType t) {
+    return t == ValueType::Integer || t == ValueType::Boolean || t == ValueType::Auto || t == ValueType::AutoFun;
 }
 
-void updateFunctionParamTypes(const std::string& funcName,
-                              const std::vector<std::shared_ptr<ASTNode>>& actualArgs);
-
 private:
     ErrorManager& m_errorManager;
     
@@ -28,64 +56,100 @@ private:
     // std::string asmCode; // This can be removed if textSection and dataSection are used to build final output
 
     // Accumulated code for different sections.
-    std::string dataSection;
-    std::string textSection; // Will also contain function definitions
-    std::string bssSection; // Added for completeness, though not explicitly requested to be fixed.
+    AsmSection dataSection;
+    AsmSection textSection; // Will also contain function definitions
+    AsmSection bssSection; // Added for completeness, though not explicitly requested to be fixed.
     // Set to track variables already declared in the .data section (for true globals).
     std::set<std::string> declaredVars;
+    // Runtime helpers and data referenced by the code emitted so far
+    RuntimeUsage m_runtime;
+    RuntimeLinkage m_runtimeLinkage = RuntimeLinkage::Inline;
+    const CallGraph* m_callGraph = nullptr;
+    std::string m_prerenderedOutput;
+    UnrollLimits m_unroll;
+    bool m_vectorize = true;
+    bool m_branchless = true;
+
+    // Interned string literals: contents -> label, filled before generation and read-only afterwards
+    using StringLabels = std::unordered_map<std::string_view, std::string>;
+    StringLabels m_stringPool;
+    std::vector<std::string_view> m_stringOrder;    // emission order (first occurrence)
+    const StringLabels* m_stringLabels = nullptr;   // the pool of the generator that owns the file
+    // Constant list literals of this unit: "dq" image -> label
+    std::unordered_map<std::string, std::string> m_listConstants;
     
     // Symbol table pointers
-    SymbolTable* symbolTable;       // Points to the global symbol table
-    SymbolTable* currentSymbolTable; // Points to the symbol table of the current scope (e.g., function)
+    const SymbolTable* symbolTable;       // Points to the global symbol table
+    const SymbolTable* currentSymbolTable; // Points to the symbol table of the current scope (e.g., function)
     
-    std::shared_ptr<ASTNode> rootNode; // Root of the AST, useful for some lookups
     std::string currentFunction; // Name of the function currently being generated
 
     // Counters for generating unique labels
     int labelCounter;
     int loopLabelCounter;
     int ifLabelCounter;
-    int stringLabelCounter;
+    // For loops over a list enclosing the code being generated; the first two keep their
+    // element pointer and end pointer in r12/r13 and r14/r15 (preserved by every call)
+    int m_listLoopDepth = 0;
 
-	FunctionSymbol* currentFuncSym;
+    unsigned m_jobs;
+    static constexpr std::size_t kUnitsPerThread = 16; // units generated per thread before streaming them out
+
+    // Output of one function (or of the main instructions), generated with its own label counters
+    struct GeneratedUnit {
+        AsmSection text;
+        AsmSection data;               // unit data, appended to .data
+        RuntimeUsage runtime;          // runtime helpers it references
+        ErrorManager errors;
+        std::exception_ptr failure;    // rethrown at merge time, in program order
+    };
+    void generateUnit(ASTNode* node, GeneratedUnit& unit) const;
 
     // Code generation routines.
     void startAssembly();
-    void visitNode(const std::shared_ptr<ASTNode>& node);
+    void internStrings(const std::vector<ASTNode*>& units);
+    static std::string stringDirective(const std::string& label, std::string_view value);
+    static std::string bytesDirective(const std::string& label, std::string_view bytes);
+    void visitNode(ASTNode* node);
     void endAssembly();
-    void writeToFile(const std::string &filename);
 
     // Specific AST node type generators
     void genPrint(const std::string& type); // Assuming type is for the expression to print
-    void genAffect(const std::shared_ptr<ASTNode>& node);
-    void genFor(const std::shared_ptr<ASTNode>& node);
-    void genIf(const std::shared_ptr<ASTNode>& node);
-    void genWhile(const std::shared_ptr<ASTNode>& node);
-    void genFunction(const std::shared_ptr<ASTNode>& node);
-    void genFunctionCall(const std::shared_ptr<ASTNode>& node);
-    void genReturn(const std::shared_ptr<ASTNode>& node);
-    void genList(const std::shared_ptr<ASTNode>& node); // For list literals or operations
+    void genAffect(ASTNode* node);
+    void genFor(ASTNode* node);
+    bool genUnrolledRange(ASTNode* loopVarNode, ASTNode* limitNode, ASTNode* bodyNode);
+    // For loop whose body is a single integer reduction or element-wise list operation
+    struct VectorLoop {
+        enum class Kind { Sum, Count, Min, Max, Map };
+        Kind kind = Kind::Sum;
+        ASTNode* list = nullptr;               // L of range(len(L)); nullptr: for x in <list>
+        ASTNode* accumulator = nullptr;        // Sum, Count, Min, Max
+        std::string_view compare;              // Count, Min, Max: element <compare> operand
+        ASTNode* operand = nullptr;            // Count: value compared with each element
+        ASTNode* target = nullptr;             // Map: M of M[i] = left op right
+        ASTNode* left = nullptr;               // Map: A[i] or a scalar
+        ASTNode* right = nullptr;
+        std::string_view op;                   // Map: + or -
+    };
+    bool matchVectorLoop(const ASTNode* node, VectorLoop& loop) const;
+    std::string genVectorLoop(ASTNode* node, const VectorLoop& loop);
+    bool generatesCleanly(ASTNode* node) const;
+    void genIf(ASTNode* node);
+    bool genBranchlessIf(ASTNode* node);
+    void genTruthValue(ValueType type);
+    void genWhile(ASTNode* node);
+    void genFunction(ASTNode* node);
+    void genFunctionCall(ASTNode* node);
+    void genReturn(ASTNode* node);
+    void genList(ASTNode* node); // For list literals or operations
+    std::string constantElement(const ASTNode* element) const;
 
     
     // Helper functions
     std::string getIdentifierMemoryOperand(const std::string& name); // Crucial for var access
-    std::string getIdentifierType(const std::string& name); // To get type from SymbolTable
-    std::string getExpressionType(const std::shared_ptr<ASTNode>& node); // To determine type of an expression node
-    
-    // Type system related helpers (review if still needed in this exact form or if SymbolTable handles more)
-    void updateSymbolType(const std::string& name, const std::string& type); // Updates type in SymbolTable
-    std::string inferFunctionReturnType(const std::shared_ptr<ASTNode>& astRoot, const std::string& funcName);
-    // The following might be simplified or removed if SymbolTable directly provides this info
-    //
-	 bool isIntVariable(const std::string& name); // Can be: getIdentifierType(name) == "Integer"
-     bool isStringVariable(const std::string& name); // Can be: getIdentifierType(name) == "String"
-     void resetFunctionVarTypes(const std::string& funcName); // May not be needed with proper scoping
-    
-    void updateFunctionReturnType(const std::string& funcName, const std::string& returnType); // Semantic analysis phase?
-    std::string getFunctionReturnType(const std::string& funcName); // Get from FunctionSymbol in SymbolTable
 
     std::string newLabel(const std::string& base);
     void toBool(const std::string& reg); // Converts value in reg to 0 or 1
 
-	void emitGlobals(SymbolTable* globalScope);
+	void emitGlobals(const SymbolTable* globalScope);
 };
\ No newline at end of file
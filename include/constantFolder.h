@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ASTNode.h"
+#include "astQueries.h"
+#include "callGraph.h"
+#include "evaluator.h"
+#include "symbolTable.h"
+
+// Un appel remplacé par sa valeur
+struct FoldedCall {
+    std::string callee;
+    std::string caller;          // "main" pour le programme principal
+    int line = 0;
+    std::string value;
+};
+
+/* Évaluation à la compilation des appels de fonctions pures dont tous les arguments sont des
+ * littéraux. Une fonction est pure si elle n'affiche rien, ne lit ni n'écrit aucune variable
+ * globale, ne modifie aucun élément de liste et n'appelle que des fonctions pures (ou len, list,
+ * range) : son résultat ne dépend que de ses arguments. L'appel est évalué par Evaluator, dans ses
+ * limites de pas et de profondeur ; un résultat entier ou booléen remplace l'appel par un littéral
+ * du même type statique. Modifie l'AST annoté : à lancer après TypeAnnotator, puis reconstruire le
+ * graphe d'appels (les fonctions qui ne sont plus appelées meurent). */
+class ConstantFolder {
+public:
+    ConstantFolder(ASTArena& arena, const SymbolTable& globals, const CallGraph& callGraph)
+        : m_arena(arena), m_globals(globals), m_callGraph(callGraph), m_evaluator(globals, callGraph) {}
+
+    void setLimits(Evaluator::Limits limits) { m_evaluator.setLimits(limits); }
+    void run(ASTNode* root);
+
+    // Fonctions pures (analysePurity), indexées comme le graphe d'appels
+    const std::vector<bool>& pure() const { return m_pure; }
+    std::size_t pureCount() const;
+    const std::vector<FoldedCall>& folded() const { return m_folded; }
+    std::size_t steps() const { return m_evaluator.steps(); }
+    // Une ligne par appel remplacé, puis le total
+    void report(std::ostream& out) const;
+
+private:
+    ASTArena& m_arena;
+    const SymbolTable& m_globals;
+    const CallGraph& m_callGraph;
+    Evaluator m_evaluator;
+    std::vector<bool> m_pure;
+    std::vector<FoldedCall> m_folded;
+
+    void fold(ASTNode*& slot, const std::string& caller);
+};
@@ -21,6 +21,9 @@ public:
     // Vérifier si des erreurs existent
     bool hasErrors() const;
 
+    // Déplacer à la suite les erreurs d'un autre gestionnaire (génération parallèle)
+    void append(ErrorManager& other);
+
 private:
     std::queue<Error> errorQueue; // File pour stocker les objets Error
 };
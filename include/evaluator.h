@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ASTNode.h"
+#include "callGraph.h"
+#include "symbolTable.h"
+
+/* Interprète de l'AST typé, fidèle au code que produit CodeGenerator : entiers 64 bits qui
+ * débordent comme imul/add, division tronquée, chaînes concaténées dans l'unique concat_buffer,
+ * listes allouées dans un tas de la taille de list_buffer. Dès qu'une construction sort de ce que
+ * le générateur fait à coup sûr (erreur d'exécution, type inattendu, builtin inconnu), ou qu'une
+ * limite est atteinte, l'évaluation s'arrête et le résultat est absent : l'appelant garde alors le
+ * code normal. */
+class Evaluator {
+public:
+    struct Value;
+    using List = std::vector<Value>;
+
+    struct Value {
+        enum class Kind : std::uint8_t { Integer, String, List } kind = Kind::Integer;
+        std::int64_t integer = 0;                 // Integer et Boolean
+        std::shared_ptr<std::string> string;      // partagé : concat_buffer est réécrit en place
+        std::shared_ptr<List> list;
+
+        static Value ofInteger(std::int64_t v) { return Value{Kind::Integer, v, nullptr, nullptr}; }
+    };
+
+    struct Limits {
+        std::size_t steps = 100000;   // noeuds évalués par évaluation
+        std::size_t depth = 256;      // appels imbriqués
+        std::size_t output = 1 << 20; // octets affichés
+    };
+
+    Evaluator(const SymbolTable& globals, const CallGraph& callGraph) : m_globals(globals), m_callGraph(callGraph) {}
+
+    void setLimits(Limits limits) { m_limits = limits; }
+    // Fonctions sans effet (indexées comme le graphe d'appels) : leurs appels sur des entiers sont mémoïsés
+    void setPureFunctions(const std::vector<bool>* pure) { m_pure = pure; }
+    // Appel de la fonction f du graphe d'appels ; absent si l'évaluation s'est arrêtée
+    std::optional<Value> call(std::size_t f, const std::vector<Value>& args);
+    // Valeur d'un littéral constant (entier, booléen, chaîne, -entier) ; absent pour toute autre expression
+    static std::optional<Value> literal(const ASTNode* node);
+
+    // Programme principal : les print écrivent dans output (sans sortie, un print arrête l'évaluation)
+    void setOutput(std::string* output) { m_output = output; }
+    // Nouvel état vide, budget de pas compris, pour une suite d'executeStatement
+    void beginProgram() { begin(); }
+    // Instruction du programme principal ; faux si l'évaluation s'est arrêtée (état alors incomplet)
+    bool executeStatement(const ASTNode* statement);
+    const std::unordered_map<Interner::Id, Value>& globalValues() const { return m_globalValues; }
+    // La chaîne est le contenu courant de concat_buffer, que la prochaine concaténation réécrira
+    bool inConcatBuffer(const Value& value) const {
+        return value.kind == Value::Kind::String && m_concatBuffer && value.string == m_concatBuffer;
+    }
+
+    std::size_t steps() const { return m_totalSteps; }
+
+private:
+    static constexpr std::size_t kListHeapWords = 8192; // list_buffer
+    static constexpr std::size_t kConcatBufferSize = 2048; // concat_buffer
+
+    struct Stop {};                            // évaluation abandonnée
+    struct Frame {
+        const SymbolTable* scope = nullptr;    // portée de la fonction appelée
+        std::unordered_map<Interner::Id, Value> locals;
+    };
+
+    const SymbolTable& m_globals;
+    const CallGraph& m_callGraph;
+    Limits m_limits;
+    const std::vector<bool>* m_pure = nullptr;
+    std::string* m_output = nullptr;
+    std::size_t m_steps = 0;
+    std::size_t m_totalSteps = 0;
+    std::size_t m_depth = 0;
+    std::size_t m_heapWords = 0;
+    std::shared_ptr<std::string> m_concatBuffer;
+    std::unordered_map<Interner::Id, Value> m_globalValues;
+    std::vector<Frame> m_frames;
+    bool m_returning = false;
+    Value m_returnValue;
+    // Appels de fonctions pures sur des entiers déjà évalués : même résultat à chaque fois
+    std::map<std::pair<std::size_t, std::vector<std::int64_t>>, std::int64_t> m_memo;
+
+    [[noreturn]] static void stop() { throw Stop{}; }
+    void step();
+    void begin();
+
+    void execute(const ASTNode* node);
+    void executeAffect(const ASTNode* node);
+    void executeFor(const ASTNode* node);
+    void print(const ASTNode* node);
+    void write(const Value& value, ValueType type);
+    Value evaluate(const ASTNode* node);
+    Value evaluateCall(const ASTNode* node);
+    Value invoke(std::size_t f, const std::vector<Value>& args);
+    Value& variable(const ASTNode* identifier, bool assign);
+    Value allocateList(std::size_t size);
+    bool truth(const Value& value, ValueType staticType) const;
+    static ValueType staticType(const ASTNode* node);
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ASTNode.h"
+#include "astQueries.h"
+#include "callGraph.h"
+#include "symbolTable.h"
+
+// Un site d'appel remplacé par le corps de la fonction appelée
+struct InlinedCall {
+    std::string callee;
+    std::string caller;          // "main" pour le programme principal
+    int line = 0;
+    std::size_t cost = 0;        // noeuds de l'expression recopiée
+    std::size_t temporaries = 0; // arguments passés par une variable du cadre de l'appelant
+};
+
+/* Inlining des petites fonctions non récursives dont le corps est un seul `return <expression>`.
+ * L'appel est remplacé par une copie typée de l'expression, où chaque paramètre devient :
+ *   - l'argument lui-même s'il est un littéral ou une variable (rien à évaluer, aucun effet) ;
+ *   - sinon une variable temporaire de l'appelant (local du cadre, ou globale pour le programme
+ *     principal), affectée juste avant l'instruction. Seul l'appel qui forme à lui seul la valeur
+ *     d'une affectation, d'un return ou d'une instruction peut en recevoir : l'ordre d'évaluation
+ *     des arguments est alors conservé.
+ * Modèle de coût : une copie pas plus grosse que la séquence d'appel est toujours faite ; au-delà
+ * (jusqu'à maxCalleeSize noeuds), la croissance de l'AST est prise sur un budget proportionnel à
+ * la taille du programme. Modifie l'AST annoté et la table des symboles : à lancer après
+ * TypeAnnotator, puis reconstruire le graphe d'appels (les fonctions entièrement inlinées meurent). */
+class Inliner {
+public:
+    Inliner(ASTArena& arena, SymbolTable& globals, const CallGraph& callGraph)
+        : m_arena(arena), m_globals(globals), m_callGraph(callGraph) {}
+
+    // Taille maximale de l'expression recopiée, en noeuds (0 : pas d'inlining)
+    void setMaxCalleeSize(std::size_t nodes) { m_maxCalleeSize = nodes; }
+    void run(ASTNode* root);
+
+    const std::vector<InlinedCall>& inlined() const { return m_inlined; }
+    std::size_t growth() const { return m_growth; }
+    std::size_t budget() const { return m_budget; }
+    // Une ligne par site inliné, puis le total
+    void report(std::ostream& out) const;
+
+private:
+    static constexpr std::size_t kCallNodes = 3;     // FunctionCall, nom, ParameterList remplacés
+    static constexpr std::size_t kMinBudget = 64;    // noeuds ajoutables, même pour un petit programme
+    static constexpr std::size_t kBudgetShare = 8;   // puis 1/8 de la taille du programme
+    static constexpr int kMaxDepth = 8;              // copies inlinées dans une copie
+
+    // Fonction candidate, analysée une fois
+    struct Candidate {
+        bool analysed = false;
+        bool eligible = false;
+        const ASTNode* expression = nullptr;    // valeur du return
+        const SymbolTable* scope = nullptr;
+        std::vector<Interner::Id> params;
+        std::vector<std::size_t> uses;          // occurrences de chaque paramètre dans l'expression
+        std::vector<ValueType> paramTypes;      // type de chaque paramètre dans l'expression
+        std::vector<Interner::Id> freeNames;    // autres variables lues : doivent désigner le même symbole chez l'appelant
+        std::size_t cost = 0;
+    };
+
+    // Fonction (ou programme principal) dans laquelle on inline
+    struct Caller : FrameScope {
+        std::string name;
+        std::vector<Interner::Id> temporaries;  // réutilisés d'une instruction à l'autre
+    };
+
+    ASTArena& m_arena;
+    SymbolTable& m_globals;
+    const CallGraph& m_callGraph;
+    std::size_t m_maxCalleeSize = 16;
+    std::size_t m_budget = 0;
+    std::size_t m_growth = 0;
+    std::size_t m_nextTemporary = 0;
+    std::vector<Candidate> m_candidates;
+    std::vector<InlinedCall> m_inlined;
+
+    const Candidate& candidate(std::size_t f);
+    void inlineBlock(ASTNode* block, Caller& caller);
+    void inlineExpression(ASTNode*& slot, Caller& caller, int depth);
+    // Remplace l'appel *slot ; les temporaires éventuels sont insérés dans block avant index
+    bool inlineCall(ASTNode*& slot, Caller& caller, ASTNode* block, std::size_t* index);
+    Interner::Id temporary(Caller& caller, std::size_t n);
+    ASTNode* substitute(const ASTNode* node, const Candidate& callee, const std::vector<ASTNode*>& values);
+};
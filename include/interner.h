@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/* Table d'internement des identificateurs : chaque nom distinct reçoit un entier stable */
+class Interner {
+public:
+    using Id = std::uint32_t;
+    static constexpr Id kNoId = UINT32_MAX;
+
+    // Retourne l'identifiant du nom, en le créant si nécessaire
+    Id intern(std::string_view name);
+
+    // Retourne l'identifiant du nom s'il existe déjà, kNoId sinon
+    Id find(std::string_view name) const;
+
+    // Nom associé à un identifiant (la référence reste valide tant que l'Interner existe)
+    const std::string& name(Id id) const { return m_names[id]; }
+
+    std::size_t size() const { return m_names.size(); }
+
+private:
+    std::deque<std::string> m_names;                   // stockage stable des noms
+    std::unordered_map<std::string_view, Id> m_ids;    // clés = vues sur m_names
+};
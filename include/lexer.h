@@ -5,6 +5,7 @@
 #include <stack>
 #include <iostream>
 #include "errorManager.h"
+#include "interner.h"
 
 
 /* Enumeration for token types */
@@ -28,12 +29,13 @@ struct Token {
     TokenType type;
     std::string value;
     int line = 0;
+    Interner::Id id = Interner::kNoId;   // Interned name (IDF only)
 };
 
 /* Lexer class declaration */
 class Lexer {
 public:
-    explicit Lexer(std::string src, ErrorManager& errorManager);
+    Lexer(std::string src, ErrorManager& errorManager, Interner& names);
 
     std::vector<Token> tokenize();
     void displayTokens(const std::vector<Token>& tokens);
@@ -43,6 +45,7 @@ public:
 private:
     std::string m_src;
     ErrorManager& m_errorManager;
+    Interner& m_names;
     int m_pos = -1;
     int m_line = 1;
     std::stack<int> m_scope;
@@ -75,4 +78,4 @@ private:
     // Utility functions
     bool isDoubleOperatorStart(char ch) const;
     
-};
\ No newline at end of file
+};
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "ASTNode.h"
+#include "astQueries.h"
+#include "callGraph.h"
+#include "symbolTable.h"
+
+/* Sortie des calculs invariants des boucles while et for, sur l'AST typé. Une expression sans effet
+ * est invariante si la boucle n'affecte aucune des variables qu'elle lit et, si elle lit un élément
+ * de liste, si la boucle n'écrit aucun élément (affectation L[i] = ..., appel d'une fonction
+ * impure) : les listes pouvant être partagées, toute écriture rend variantes toutes les lectures.
+ * Une expression invariante est calculée une fois, dans une temporaire (local du cadre, ou globale
+ * pour le programme principal) affectée dans l'en-tête de la boucle, juste avant elle ; ses
+ * occurrences dans la boucle lisent la temporaire.
+ * L'en-tête s'exécute même si le corps ne s'exécute jamais : seules en sortent les expressions qui
+ * ne peuvent pas échouer (ni lecture d'élément, ni division par autre chose qu'un littéral non
+ * nul), sauf dans la condition d'un while, évaluée au moins une fois, pour ce qu'elle calcule
+ * avant tout effet et toute erreur possible. Les boucles internes sont traitées d'abord ; les
+ * affectations de leur en-tête invariantes dans la boucle englobante remontent dans son en-tête.
+ * Modifie l'AST annoté et la table des symboles : à lancer après TypeAnnotator. */
+class LoopInvariantMotion {
+public:
+    LoopInvariantMotion(ASTArena& arena, SymbolTable& globals, const CallGraph& callGraph)
+        : m_arena(arena), m_globals(globals), m_callGraph(callGraph) {}
+
+    void run(ASTNode* root);
+
+    std::size_t hoisted() const { return m_hoisted; } // expressions calculées dans un en-tête
+    std::size_t loops() const { return m_loops; }     // boucles dotées d'un en-tête
+
+private:
+    // Variables affectées et écriture d'éléments de liste dans une boucle
+    using Effects = Accesses;
+
+    // Boucle traitée : l'en-tête s'insère dans block, juste avant statement
+    struct Loop {
+        ASTNode* block = nullptr;
+        ASTNode* statement = nullptr;
+        Effects effects;
+        std::unordered_map<std::string, Interner::Id> temporaries; // structure -> temporaire
+        bool preheader = false;
+    };
+
+    // Fonction (ou programme principal) traitée
+    using Unit = FrameScope;
+
+    // Position dans l'expression en cours
+    struct Context {
+        bool guaranteed = false;   // condition du while traité : évaluée au moins une fois
+        bool clean = true;         // rien d'évalué avant n'a d'effet ni ne peut échouer
+        bool conditional = false;  // opérande droit d'un and / or
+    };
+
+    ASTArena& m_arena;
+    SymbolTable& m_globals;
+    const CallGraph& m_callGraph;
+    std::vector<bool> m_pure;
+    std::unordered_set<Interner::Id> m_ownTemporaries;
+    std::size_t m_hoisted = 0;
+    std::size_t m_loops = 0;
+    std::size_t m_nextTemporary = 0;
+
+    void walk(ASTNode* block, Unit& unit);
+    void hoistFrom(ASTNode* statement, ASTNode* block, Unit& unit);
+    void visitBody(ASTNode* block, Loop& loop, Unit& unit);
+    void visitStatement(ASTNode* statement, Loop& loop, Unit& unit);
+    void visitExpression(ASTNode*& slot, Loop& loop, Context& context, Unit& unit);
+    void insertBefore(Loop& loop, ASTNode* assign);
+    bool isInvariant(const ASTNode* node, const Effects& effects) const;
+};
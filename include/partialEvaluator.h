@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ASTNode.h"
+#include "callGraph.h"
+#include "evaluator.h"
+#include "symbolTable.h"
+
+/* Mode --partial-eval : un programme MiniPython ne lit aucune entrée, sa sortie est donc connue à
+ * la compilation. Les instructions du programme principal sont exécutées dans l'ordre par
+ * Evaluator, dans un budget de pas global. Le plus long préfixe exécuté après lequel l'état se
+ * réécrit en littéraux est retiré de l'AST ; il est remplacé par :
+ *   - sa sortie, écrite d'un seul write au démarrage (CodeGenerator::setPrerenderedOutput) ;
+ *   - des affectations qui redonnent aux globales leur valeur à ce point, si des instructions
+ *     restent à générer normalement.
+ * Un état se réécrit si chaque liste n'est tenue que par une globale et ne contient que des entiers
+ * et des chaînes, et si aucune chaîne n'est le contenu de concat_buffer. Modifie l'AST annoté : à
+ * lancer après TypeAnnotator, puis reconstruire le graphe d'appels. */
+class PartialEvaluator {
+public:
+    PartialEvaluator(ASTArena& arena, const SymbolTable& globals, const CallGraph& callGraph)
+        : m_arena(arena), m_globals(globals), m_callGraph(callGraph) {}
+
+    // Noeuds évalués au plus pour tout le programme
+    void setFuel(std::size_t steps) { m_fuel = steps; }
+    void run(ASTNode* root);
+
+    const std::string& output() const { return m_output; }
+    std::size_t statements() const { return m_statements; }
+    std::size_t executed() const { return m_executed; }         // instructions retirées du programme principal
+    std::size_t materialized() const { return m_materialized; } // globales réaffectées
+    std::size_t steps() const { return m_steps; }
+
+private:
+    // Globale et sa valeur (listes recopiées : l'évaluation continue de les modifier)
+    using State = std::vector<std::pair<const VariableSymbol*, Evaluator::Value>>;
+
+    ASTArena& m_arena;
+    const SymbolTable& m_globals;
+    const CallGraph& m_callGraph;
+    std::size_t m_fuel = 1000000;
+    std::string m_output;
+    std::size_t m_statements = 0;
+    std::size_t m_executed = 0;
+    std::size_t m_materialized = 0;
+    std::size_t m_steps = 0;
+
+    bool snapshot(const Evaluator& evaluator, State& state) const;
+    ASTNode* literal(const Evaluator::Value& value, ValueType type, int line);
+};
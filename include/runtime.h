@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "asmWriter.h"
+
+/* Routines et données du runtime. Le générateur note ce que le code émis référence ;
+ * seuls ces éléments (et leurs dépendances) sont écrits dans le fichier assembleur,
+ * ou bien référencés en extern dans la bibliothèque pyasm_rt (--runtime-lib).
+ *
+ * ABI de pyasm_rt (x86-64, appels par `call`, pile alignée non requise) :
+ *   print_number            rax = entier signé 64 bits, écrit en décimal sur stdout (sans fin de ligne).
+ *                           Préserve rbx, r12 ; détruit rax, rcx, rdx, rsi, rdi, r11.
+ *   print_string            rax = chaîne terminée par 0, écrite sur stdout.
+ *                           Détruit rax, rcx, rdx, rsi, rdi, r11.
+ *   print_not_string        rax = liste, écrite sous la forme [a, b, c] (print_list : alias).
+ *                           Préserve rbx, rdx, rsi, rdi, r8, r9, r12 ; détruit rax, rcx, r11.
+ *   list_concat             rdi, rsi = listes ; rax = nouvelle liste allouée dans le tas des listes.
+ *                           Détruit rcx, rdx, rsi.
+ *   str_concat              rdi, rsi = chaînes ; rax = concat_buffer, réécrit à chaque appel.
+ *                           Détruit rdx, rsi.
+ *   list_range              rax = n ; rax = nouvelle liste [0, ..., n-1]. Détruit rcx.
+ *   str_equals              rdi, rsi = chaînes ; rax = 1 si même contenu, 0 sinon (comparaison des
+ *                           pointeurs d'abord). Détruit rdi, rsi.
+ *   division_by_zero_error  cible de saut (pas d'appel) : message d'erreur puis exit(1).
+ *   list_buffer, list_offset  tas des listes (8192 qwords) et décalage de la prochaine allocation,
+ *                           partagés avec les littéraux de liste du code généré.
+ * Une liste est un qword de taille suivi de ses éléments (un qword chacun). */
+enum class RuntimeItem : std::uint8_t {
+    // Routines (.text)
+    DivisionByZero,   // division_by_zero_error
+    PrintNumber,      // print_number
+    ListConcat,       // list_concat
+    StrConcat,        // str_concat
+    PrintString,      // print_string
+    ListRange,        // list_range
+    PrintList,        // print_not_string (+ alias print_list)
+    StrEquals,        // str_equals
+    // Données (.data / .bss)
+    DivZeroMessage,   // div_zero_msg, div_zero_len
+    IndexErrorMessage, // index_error_msg, index_error_len
+    ListHeap,         // list_buffer, list_offset
+    ConcatBuffer,     // concat_buffer, concat_offset
+    NumberBuffer,     // buffer
+    ListPunctuation,  // open_bracket, close_bracket, comma_space
+    Newline,          // newline
+    Space,            // space
+    MinusSign,        // minus_sign
+    Count
+};
+
+// Routines recopiées dans chaque programme, ou fournies par la bibliothèque pyasm_rt liée à part
+enum class RuntimeLinkage { Inline, Library };
+
+class RuntimeUsage {
+public:
+    void use(RuntimeItem item) { m_mask |= bit(item); }
+    bool uses(RuntimeItem item) const { return (m_mask & bit(item)) != 0; }
+    void merge(const RuntimeUsage& other) { m_mask |= other.m_mask; }
+    bool empty() const { return m_mask == 0; }
+    std::size_t count() const;
+
+    // Ajoute les dépendances transitives des éléments utilisés
+    RuntimeUsage closure() const;
+
+private:
+    static_assert(static_cast<unsigned>(RuntimeItem::Count) <= 32, "RuntimeUsage mask is 32 bits");
+    static std::uint32_t bit(RuntimeItem item) { return std::uint32_t{1} << static_cast<unsigned>(item); }
+
+    std::uint32_t m_mask = 0;
+};
+
+// Écrit les routines et les données des éléments utilisés (Inline), ou leurs déclarations extern (Library)
+void emitRuntime(const RuntimeUsage& usage, RuntimeLinkage linkage,
+                 AsmSection& textSection, AsmSection& dataSection, AsmSection& bssSection);
+
+// Source NASM complète de pyasm_rt, avec les symboles de l'ABI exportés
+void emitRuntimeLibrary(OutputSink& out);
@@ -1,40 +1,69 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include "parser.h"
 #include "errorManager.h"
 #include "symbolTable.h"
 
 class SemanticAnalyzer {
 public:
-    explicit SemanticAnalyzer(ErrorManager& errMgr)
-        : m_errorManager(errMgr) {}
+    SemanticAnalyzer(ErrorManager& errMgr, ASTArena& arena)
+        : m_errorManager(errMgr), m_arena(arena) {}
 
     // Points d’entrée de l’analyse
-    const std::shared_ptr<ASTNode>& firstPass(const std::shared_ptr<ASTNode>& root);
-    void checkSemantics(const std::shared_ptr<ASTNode>& root, SymbolTable* globalTable);
+    ASTNode* firstPass(ASTNode* root);
+    void checkSemantics(ASTNode* root, SymbolTable* globalTable);
 
 private:
     const std::unordered_set<std::string> kForbiddenNames = {"range", "len", "list", "print"};
 
     ErrorManager& m_errorManager;
+    ASTArena& m_arena;   // nouveaux noeuds et renommages de firstPass
 
-    void smallhelpR(const std::shared_ptr<ASTNode>& node, const std::shared_ptr<ASTNode>& defnode, const std::shared_ptr<ASTNode>& parentnode, const int n, std::string suffixe);
-    void bighelpR(const std::shared_ptr<ASTNode>& defnode, const std::shared_ptr<ASTNode>& parentnode, const int n, std::string suffixe);
+    // ---- firstPass : aplatissement des fonctions imbriquées ----
+    // Nom décoré d'une fonction et son rang parmi les définitions de sa portée
+    struct MangledName {
+        Interner::Id id;
+        std::uint32_t order;
+    };
+    using NameScope = std::unordered_map<Interner::Id, MangledName>;
+    // Définition dont on résout le corps
+    struct DefinitionContext {
+        Interner::Id name;      // nom d'origine
+        Interner::Id mangled;   // nom après aplatissement
+        std::uint32_t order;    // rang parmi les définitions de la portée parente
+    };
+
+    // [0] = fonctions globales, puis les fonctions imbriquées de chaque définition englobante
+    std::vector<NameScope> m_scopes;
+    std::uint32_t m_visibleGlobals = 0;      // fonctions globales déjà définies (rang < m_visibleGlobals)
+    ASTNode* m_flatDefinitions = nullptr;    // nouvelle liste Definitions, sans imbrication
+
+    void flattenDefinition(ASTNode* defnode, const std::string& prefix, const DefinitionContext& self);
+    void resolveCalls(ASTNode* node, const DefinitionContext* self);
+    Interner::Id resolveCall(Interner::Id callee, const DefinitionContext* self) const; // kNoId si inaccessible
+
+    // ---- checkSemantics ----
+    std::vector<Interner::Id> m_loopVariables;          // variables des boucles for ouvertes
+    std::unordered_set<Interner::Id> m_definedFunctions; // fonctions déjà définies
 
     // Visite récursive des nœuds de l'AST
-    void visit(const std::shared_ptr<ASTNode>& node, SymbolTable* currentScope);
+    void visit(ASTNode* node, SymbolTable* currentScope);
 
     // Vérifications spécifiques
-    void checkFunctionRedefinition(const std::shared_ptr<ASTNode>& node);
-    void checkFunctionCall(const std::shared_ptr<ASTNode>& node, SymbolTable* currentScope);
-    void checkReturnPlacement(SymbolTable* scope, std::string line);
+    void checkFunctionRedefinition(ASTNode* node);
+    void checkFunctionCall(ASTNode* node, SymbolTable* currentScope);
+    void checkReturnPlacement(SymbolTable* scope, int line);
 
     // Recherche d'un symbole dans la portée courante ou ses ancêtres
     Symbol* findSymbol(const std::string& name, SymbolTable* table);
     // Vérifie que la portée courante est une fonction
     bool insideFunction(SymbolTable* tbl);
-    void checkIdentifierInitialization(const std::shared_ptr<ASTNode>& node, SymbolTable* scope);
+    void checkIdentifierInitialization(ASTNode* node, SymbolTable* scope);
 
 };
@@ -1,38 +1,48 @@
 #pragma once
 
+#include <cstdint>
+#include <deque>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <ostream>
 #include <set> // Required for std::set
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include "interner.h"
 #include "parser.h" // Assuming ASTNode is defined here
 #include "errorManager.h" // Assuming ErrorManager is defined here
 
 // Forward declaration if ASTNode is not fully included via parser.h for some reason
 // struct ASTNode; 
 
+class SymbolTable;
+
+// Tag of the concrete symbol class; passes switch on it instead of using RTTI
+enum class SymbolKind : std::uint8_t { Variable, Function, Array };
+
 // Base Symbol class with common attributes
 class Symbol {
 public:
     std::string name;        // Name of the symbol
     std::string category;    // General category (e.g., "variable", "function", "parameter")
     int offset;              // Memory offset (stack-relative or data segment offset)
-    std::string symCat;      // Specific C++ class type identifier (e.g., "variable", "function")
-    
-    // Default constructor
-    Symbol() : name(""), category("unknown"), offset(0), symCat("symbol") {}
-    
-    // Parameterized constructor
-    Symbol(const std::string& n, const std::string& cat, int off = 0, std::string sCat = "symbol")
-        : name(n), category(cat), offset(off), symCat(sCat) {}
-        
-    // Virtual destructor for polymorphic behavior
-    virtual ~Symbol() = default;
+    SymbolKind kind;         // Concrete class (VariableSymbol, FunctionSymbol, ArraySymbol)
+    Interner::Id id = Interner::kNoId; // Interned name, set when the symbol enters a table
+
+protected:
+    // Only built through a derived class, which sets the tag
+    Symbol(const std::string& n, const std::string& cat, int off, SymbolKind k)
+        : name(n), category(cat), offset(off), kind(k) {}
 };
 
 // Derived class for variables and parameters
 class VariableSymbol : public Symbol {
 public:
+    static constexpr SymbolKind Kind = SymbolKind::Variable;
+
     bool isGlobal;    // True if in .data, false if on stack (local/parameter)
     std::string type; // e.g., "Integer", "String", "List", "Boolean", "auto"
     // std::string assumedType = "auto"; // Retained if used by semantic analysis
@@ -40,62 +50,111 @@ public:
     // Parameterized constructor
     // 'cat' can be "variable" for locals, or "parameter" for function parameters
     VariableSymbol(const std::string& n, const std::string& t, const std::string& cat, bool global = false, int off = 0)
-        : Symbol(n, cat, off, "variable"), isGlobal(global), type(t) {}
-
-    // used when duplicating symbol tables for parameter type inference
-    std::unique_ptr<VariableSymbol> clone() const {
-        return std::make_unique<VariableSymbol>(name, type, category, isGlobal, offset);
-    }
+        : Symbol(n, cat, off, Kind), isGlobal(global), type(t) {}
 };
 
 // Derived class for functions
 class FunctionSymbol : public Symbol {
 public:
+    static constexpr SymbolKind Kind = SymbolKind::Function;
+
     int numParams;
     std::string returnType;
     int tableID;        // ID of the SymbolTable for this function's scope
     int frameSize;      // Total size for local variables on stack, 16-byte aligned
+    SymbolTable* scope = nullptr; // This function's scope (owned by the global table's children)
 
     // Parameterized constructor
     FunctionSymbol(const std::string& n, const std::string& retType, int nParams, int tID, int off = 0, int fSize = 0)
-        : Symbol(n, "function", off, "function"), numParams(nParams), returnType(retType), tableID(tID), frameSize(fSize) {}
-
-    // used when duplicating symbol tables (parameter type inference)
-    std::unique_ptr<FunctionSymbol> clone() const {
-        return std::make_unique<FunctionSymbol>(name, returnType, numParams, tableID, offset, frameSize);
-    }
+        : Symbol(n, "function", off, Kind), numParams(nParams), returnType(retType), tableID(tID), frameSize(fSize) {}
 };
 
+// Frame reserved below rbp for localsTotalSize bytes of locals, padded so that the locals and the
+// five callee-saved pushes of the prologue keep rsp 16-byte aligned
+int frameSizeForLocals(int localsTotalSize);
+
 // Derived class for array/list types
 class ArraySymbol : public Symbol {
 public:
+    static constexpr SymbolKind Kind = SymbolKind::Array;
+
     int size; // Number of elements, or 0 if dynamically sized / pointer
     bool isGlobal;
     std::string elementType; // Type of elements in the array/list
 
     // Parameterized constructor
     ArraySymbol(const std::string& n, std::string eType = "auto", int arraySize = 0, bool global = false, int off = 0)
-        : Symbol(n, "array", off, "array"), size(arraySize), isGlobal(global), elementType(eType) {}
+        : Symbol(n, "array", off, Kind), size(arraySize), isGlobal(global), elementType(eType) {}
 };
 
-class SymbolTable {
+// Checked downcast on the tag: nullptr if the symbol is absent or of another kind
+template <class T>
+T* symbolAs(Symbol* symbol) {
+    return symbol && symbol->kind == T::Kind ? static_cast<T*>(symbol) : nullptr;
+}
+
+template <class T>
+const T* symbolAs(const Symbol* symbol) {
+    return symbol && symbol->kind == T::Kind ? static_cast<const T*>(symbol) : nullptr;
+}
+
+/* Table de hachage à adressage ouvert (sondage linéaire) : nom interné -> symbole d'une portée */
+class SymbolMap {
 public:
-    SymbolTable(const std::string& sName, SymbolTable* parentTable, int tID) 
-        : scopeName(sName), parent(parentTable), nextDataOffset(0), tableID(tID) {} // Initialize nextDataOffset before tableID
+    Symbol* find(Interner::Id id) const;
+    // Insère si absent ; retourne false si l'id est déjà présent (le premier gagne)
+    bool insert(Interner::Id id, Symbol* symbol);
+    std::size_t size() const { return m_size; }
 
-    // Add a symbol to the current scope
-    void addSymbol(const Symbol& symbol);
+private:
+    struct Slot {
+        Interner::Id id = Interner::kNoId;
+        Symbol* symbol = nullptr;
+    };
+    std::vector<Slot> m_slots;   // capacité puissance de 2, facteur de charge <= 1/2
+    std::size_t m_size = 0;
+
+    std::size_t slotOf(Interner::Id id) const;
+    void grow();
+};
+
+class SymbolTable {
+public:
+    // Child scopes share the interner of their parent
+    SymbolTable(const std::string& sName, SymbolTable* parentTable, int tID, Interner* nameTable = nullptr)
+        : scopeName(sName), parent(parentTable), names(nameTable ? nameTable : (parentTable ? parentTable->names : nullptr)),
+          nextDataOffset(0), tableID(tID) {} // Initialize nextDataOffset before tableID
+
+    // Construct a symbol in place in the pool of its kind.
+    // Returns nullptr (and adds nothing) if the name is already declared in this scope.
+    template <class T, class... Args>
+    T* addSymbol(Args&&... args) {
+        std::deque<T>& pool = poolOf<T>();
+        T& symbol = pool.emplace_back(std::forward<Args>(args)...);
+        symbol.id = names->intern(symbol.name);
+        if (!index.insert(symbol.id, &symbol)) {
+            pool.pop_back(); // first declaration wins
+            return nullptr;
+        }
+        symbols.push_back(&symbol);
+        return &symbol;
+    }
 
     // Look up a symbol by name in current and parent scopes
-    bool lookup(const std::string& name) const;
-    Symbol* findSymbol(const std::string& name); // Added to retrieve symbol
+    bool lookup(std::string_view name) const;
+    Symbol* findSymbol(std::string_view name) const; // Added to retrieve symbol
+    Symbol* findSymbol(Interner::Id id) const;
 
     // Look up a symbol by name only in the current scope
-    bool immediateLookup(const std::string& name) const;
-    Symbol* findImmediateSymbol(const std::string& name); // Added to retrieve symbol
+    bool immediateLookup(std::string_view name) const;
+    Symbol* findImmediateSymbol(std::string_view name) const; // Added to retrieve symbol
+    Symbol* findImmediateSymbol(Interner::Id id) const { return index.find(id); }
+
+    // Scope of the function with that name, reached through its FunctionSymbol
+    SymbolTable* findFunctionScope(std::string_view funcName) const;
 
     // Check if a symbol is shadowing a parameter in the current scope
-    bool isShadowingParameter(const std::string& name) const;
+    bool isShadowingParameter(std::string_view name) const;
 
     // Print the symbol table (for debugging)
     void print(std::ostream& out, int indent = 0) const;
@@ -105,36 +164,81 @@ public:
 
     std::string scopeName;
     SymbolTable* parent;
-    std::vector<std::unique_ptr<Symbol>> symbols;
+    Interner* names;        // Shared name table (ids of the AST identifiers)
+    std::vector<Symbol*> symbols;                   // Declaration order (data layout, printing)
+    SymbolMap index;                                // O(1) lookup of `symbols` by interned name
     std::vector<std::unique_ptr<SymbolTable>> children;
     int nextDataOffset; // Used for laying out global variables in .data section
     int tableID;
+
+private:
+    // Per-kind storage: deque keeps addresses stable and elements in contiguous chunks
+    std::deque<VariableSymbol> m_variables;
+    std::deque<FunctionSymbol> m_functions;
+    std::deque<ArraySymbol> m_arrays;
+
+    template <class T>
+    std::deque<T>& poolOf() {
+        if constexpr (std::is_same_v<T, VariableSymbol>) return m_variables;
+        else if constexpr (std::is_same_v<T, FunctionSymbol>) return m_functions;
+        else return m_arrays;
+    }
+};
+
+// Counters of the type inference fixed point (printed with --stats)
+struct InferenceStats {
+    std::size_t statements = 0;   // Work items seeded (top-level statements of each body)
+    std::size_t iterations = 0;   // Work items processed until the fixed point
+    std::size_t specializations = 0;
+    double milliseconds = 0;
 };
 
 class SymbolTableGenerator {
 public:
-    explicit SymbolTableGenerator(ErrorManager& errMgr); // Remove : m_errorManager(errMgr), nextTableIdCounter(0) {}
+    SymbolTableGenerator(ErrorManager& errMgr, ASTArena& arena);
     
     // Generate symbol table from AST root
-    std::unique_ptr<SymbolTable> generate(const std::shared_ptr<ASTNode>& root);
+    std::unique_ptr<SymbolTable> generate(ASTNode* root);
+
+    const InferenceStats& inferenceStats() const { return m_inferenceStats; }
 
 private:
     ErrorManager& m_errorManager;
+    ASTArena& m_arena;   // new FunctionDefinition nodes created by statementInference
     int nextTableIdCounter;
     std::set<std::string> processedFunctionNames; 
 
-    // after initial symbol table is created, loop over AST several time to infer types
-    std::string statementInference(const std::shared_ptr<ASTNode>& def, SymbolTable* globalTable, const std::shared_ptr<ASTNode>& node, SymbolTable* currentTable, std::string type);
-    void inferTypes(const std::shared_ptr<ASTNode>& root, SymbolTable* globalTable);
+    // after initial symbol table is created, infer types with a worklist until nothing changes
+    std::string statementInference(ASTNode* def, SymbolTable* globalTable, ASTNode* node, SymbolTable* currentTable, std::string type);
+    void inferTypes(ASTNode* root, SymbolTable* globalTable);
+
+    // Worklist: one item per top-level statement of a body, re-analysed when a type it read changes
+    struct InferenceItem {
+        ASTNode* statement;
+        SymbolTable* scope;
+    };
+    std::vector<InferenceItem> m_items;
+    std::deque<std::size_t> m_worklist;
+    std::vector<bool> m_queued;
+    std::size_t m_currentItem = 0;
+    std::unordered_map<const Symbol*, std::vector<std::size_t>> m_readers; // symbol -> items that read its type
+    std::unordered_map<Interner::Id, ASTNode*> m_definitions;              // function name -> FunctionDefinition
+    std::unordered_map<std::string, ASTNode*> m_specializations;           // mangled name (generic + argument types) -> clone
+    std::unordered_map<Interner::Id, ASTNode*> m_genericOf;                // specialization -> generic FunctionDefinition
+    InferenceStats m_inferenceStats;
+
+    void enqueueBody(ASTNode* body, SymbolTable* scope);
+    void dependsOn(const Symbol* symbol);   // the current item reads this symbol's type
+    void typeChanged(const Symbol* symbol); // requeue every item that read it
 
     // Main recursive function to build symbol tables and assign layout
-    void buildScopesAndSymbols(const std::shared_ptr<ASTNode>& node, SymbolTable* globalTable, SymbolTable* currentScopeTable);
+    void buildScopesAndSymbols(ASTNode* node, SymbolTable* globalTable, SymbolTable* currentScopeTable);
     
     // Helper to discover local variables within a function body and assign stack offsets
-    void discoverLocalsAndAssignOffsets(const std::shared_ptr<ASTNode>& bodyNode, SymbolTable* functionScopeTable, int& currentLocalOffset);
+    void discoverLocalsAndAssignOffsets(ASTNode* bodyNode, SymbolTable* functionScopeTable, int& currentLocalOffset);
     
     // Kept if still used by other parts of your system, e.g. semantic analysis for return type inference
-    std::shared_ptr<ASTNode> findFunctionDefNode(const std::shared_ptr<ASTNode>& astRoot, const std::string& funcName);
-    std::string inferFunctionReturnType(const std::shared_ptr<ASTNode>& funcDefNode, SymbolTable* functionScope);
+    ASTNode* findFunctionDefNode(ASTNode* astRoot, const std::string& funcName);
+    std::string inferFunctionReturnType(ASTNode* funcDefNode, SymbolTable* functionScope);
 
     };
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/* Pool de threads de taille fixe pour les boucles parallèles du compilateur.
+ * parallelFor(n, task) exécute task(i) pour chaque i de [0, n) et rend la main quand tout est fini ;
+ * le thread appelant travaille aussi. Les indices sont distribués dynamiquement : l'appelant range
+ * chaque résultat à son indice pour obtenir une sortie déterministe. */
+class ThreadPool {
+public:
+    // threads = nombre total de threads, appelant compris (0 ou 1 : tout s'exécute dans l'appelant)
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Relance dans l'appelant la première exception levée par une tâche
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+
+    unsigned size() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+
+    // Nombre de threads par défaut : les coeurs de la machine
+    static unsigned defaultThreads();
+
+private:
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;   // nouveau lot ou arrêt
+    std::condition_variable m_done;   // un worker a fini le lot courant
+    const std::function<void(std::size_t)>* m_task = nullptr;
+    std::size_t m_count = 0;
+    std::atomic<std::size_t> m_next{0};
+    std::uint64_t m_batch = 0;        // numéro du lot courant
+    unsigned m_busy = 0;              // workers encore dans le lot courant
+    std::exception_ptr m_error;
+    bool m_stop = false;
+
+    void workerLoop();
+    void drain();                     // prend des indices jusqu'à épuisement du lot
+};
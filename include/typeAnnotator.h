@@ -0,0 +1,40 @@
+#pragma once
+
+#include <unordered_map>
+#include "ASTNode.h"
+#include "errorManager.h"
+#include "symbolTable.h"
+
+/* Passe de typage : pose sur chaque noeud son ValueType, une seule fois, avant la génération de code.
+ * C'est la seule étape après l'inférence où un type évolue : une variable restée "auto" prend le type
+ * de sa première affectation, un paramètre celui du premier appel rencontré (définitions puis
+ * instructions, dans l'ordre du source). Ces types vivent dans m_types : la table des symboles reste
+ * figée et le générateur ne fait que lire ASTNode::type. */
+class TypeAnnotator {
+public:
+    explicit TypeAnnotator(ErrorManager& errorManager) : m_errorManager(errorManager) {}
+
+    void annotate(ASTNode* root, const SymbolTable* globalTable);
+
+    std::size_t annotatedNodes() const { return m_annotated; }
+
+private:
+    ErrorManager& m_errorManager;
+    const SymbolTable* m_global = nullptr;
+    const SymbolTable* m_scope = nullptr;            // portée de la fonction en cours, sinon m_global
+    Interner::Id m_function = Interner::kNoId; // fonction en cours
+    std::unordered_map<const Symbol*, ValueType> m_types;      // types de variables fixés pendant la passe
+    std::unordered_map<Interner::Id, ValueType> m_firstReturn; // type du premier return de chaque fonction
+    std::size_t m_annotated = 0;
+
+    void visit(ASTNode* node);
+    void visitCall(ASTNode* node);
+    ValueType expressionType(const ASTNode* node);
+    ValueType identifierType(const ASTNode* node);
+    ValueType returnType(const ASTNode* callee);
+
+    ValueType variableType(const VariableSymbol* var) const;
+    Interner::Id idOf(const ASTNode* node) const;
+    void assign(const ASTNode* target, ValueType type);
+    void bindArguments(const FunctionSymbol* callee, const NodeList& args);
+};
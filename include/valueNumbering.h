@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ASTNode.h"
+#include "astQueries.h"
+#include "callGraph.h"
+#include "symbolTable.h"
+
+/* Élimination des sous-expressions communes par numérotation des valeurs, sur l'AST typé. Deux
+ * expressions sans effet de même structure (mêmes opérateurs, mêmes variables, mêmes littéraux) ont
+ * la même valeur tant qu'aucune de leurs variables n'est réaffectée, et, si elles lisent un élément
+ * de liste, tant qu'aucun élément n'est écrit (affectation L[i] = ..., appel d'une fonction impure) :
+ * les listes pouvant être partagées, toute écriture invalide toutes les lectures.
+ * Une valeur est disponible dans la suite de l'instruction qui la calcule, dans les instructions
+ * suivantes du bloc et dans les blocs imbriqués (qu'elle domine) ; un corps de boucle ne garde que
+ * les valeurs que la boucle ne modifie pas. À la première réutilisation, la première occurrence est
+ * sortie dans une variable temporaire (local du cadre, ou globale pour le programme principal)
+ * affectée juste avant son instruction, et chaque occurrence devient une lecture de la temporaire.
+ * Seule une occurrence évaluée à coup sûr, avant tout effet et toute erreur possible de son
+ * instruction, peut être sortie ainsi ; les conditions de while, réévaluées à chaque tour, ne font
+ * que réutiliser. Modifie l'AST annoté et la table des symboles : à lancer après TypeAnnotator. */
+class ValueNumbering {
+public:
+    ValueNumbering(ASTArena& arena, SymbolTable& globals, const CallGraph& callGraph)
+        : m_arena(arena), m_globals(globals), m_callGraph(callGraph) {}
+
+    void run(ASTNode* root);
+
+    std::size_t reused() const { return m_reused; }           // occurrences remplacées par une temporaire
+    std::size_t temporaries() const { return m_temporaries; } // valeurs sorties dans une temporaire
+
+private:
+    // Expression dont la valeur peut resservir
+    struct Value {
+        ASTNode** slot = nullptr;          // première occurrence
+        ASTNode* block = nullptr;          // la temporaire s'affecte dans ce bloc, juste avant anchor
+        ASTNode* anchor = nullptr;
+        Interner::Id temporary = Interner::kNoId;
+        Accesses reads;                    // variables et éléments de liste lus
+        std::vector<std::size_t> inner;    // valeurs enregistrées à l'intérieur de la première occurrence
+    };
+    using Available = std::unordered_map<std::string, std::size_t>; // structure -> indice dans m_values
+
+    // Effets d'une instruction sur les valeurs disponibles
+    using Kills = Accesses;
+
+    // Fonction (ou programme principal) traitée
+    using Unit = FrameScope;
+
+    // Position dans l'instruction en cours
+    struct Context {
+        ASTNode* block = nullptr;
+        ASTNode* anchor = nullptr;
+        bool clean = true;         // rien d'évalué avant n'a d'effet ni ne peut échouer
+        bool conditional = false;  // opérande droit d'un and / or
+        bool hoistable = true;     // faux dans une condition de while
+    };
+
+    ASTArena& m_arena;
+    SymbolTable& m_globals;
+    const CallGraph& m_callGraph;
+    std::vector<bool> m_pure;
+    std::vector<Value> m_values;
+    std::vector<std::size_t> m_open;   // valeurs dont on visite la première occurrence
+    std::size_t m_reused = 0;
+    std::size_t m_temporaries = 0;
+    std::size_t m_nextTemporary = 0;
+
+    void numberBlock(ASTNode* block, Available& available, Unit& unit);
+    void numberStatement(ASTNode* statement, ASTNode* block, Available& available, Unit& unit);
+    void numberExpression(ASTNode*& slot, Context& context, Available& available, Unit& unit);
+    void reuse(ASTNode*& slot, std::size_t v, Unit& unit);
+    void kill(Available& available, const Kills& kills) const;
+};
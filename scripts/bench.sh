@@ -0,0 +1,20 @@
+#!/bin/bash
+
+# Mesure le temps de chaque phase et la mémoire de l'AST sur un gros programme généré
+# Usage: ./scripts/bench.sh [nombre_de_fonctions] [nombre_de_globales]
+
+N=${1:-2000}
+G=${2:-$N}
+BENCH_DIR=build/bench
+mkdir -p "$BENCH_DIR"
+
+if [ ! -x build/bin/pyasm ]; then
+    ./scripts/build.sh
+fi
+
+echo "Generating a program with $N functions and $G globals..."
+python3 ./scripts/gen_bench.py "$N" "$G" > "$BENCH_DIR/large.mpy"
+wc -l "$BENCH_DIR/large.mpy"
+
+cd "$BENCH_DIR"
+../bin/pyasm --stats large.mpy > /dev/null
@@ -0,0 +1,45 @@
+#!/bin/bash
+
+# Mesure le coût des sauts mal prédits : un if/else sur des valeurs pseudo-aléatoires, compilé
+# avec cmov puis avec des sauts (--no-cmov)
+# Usage: ./scripts/bench_branches.sh [nombre_de_tours]
+
+N=${1:-20000000}
+BENCH_DIR=build/bench
+mkdir -p "$BENCH_DIR"
+
+if [ ! -x build/bin/pyasm ]; then
+    ./scripts/build.sh
+fi
+
+# Générateur congruentiel : x suit une suite que le prédicteur de branchement ne devine pas
+cat > "$BENCH_DIR/branches.mpy" <<EOF
+seed = 42
+hi = 0
+lo = 0
+k = 0
+while k < $N:
+    seed = (seed * 1103515245 + 12345) % 2147483648
+    x = seed // 65536 % 1000
+    if x > hi:
+        hi = x
+    else:
+        hi = hi - 1
+    if x < 500:
+        lo = lo + x
+    else:
+        lo = lo - x
+    k = k + 1
+print(hi, lo)
+EOF
+
+cd "$BENCH_DIR"
+TIMEFORMAT="%R s"
+for mode in cmov jumps; do
+    flags=""
+    [ "$mode" = jumps ] && flags="--no-cmov"
+    ../bin/pyasm $flags branches.mpy > /dev/null || exit 1
+    nasm -f elf64 output.asm -o "branches_$mode.o" && ld -nostdlib "branches_$mode.o" -o "branches_$mode" || exit 1
+    echo "$mode ($N tours):"
+    time "./branches_$mode"
+done
@@ -0,0 +1,31 @@
+#!/usr/bin/env python3
+# Génère un programme MiniPython de grande taille pour mesurer le compilateur
+# Usage: ./scripts/gen_bench.py [nombre_de_fonctions] [nombre_de_globales] > data/bench/large.mpy
+import sys
+
+n = int(sys.argv[1]) if len(sys.argv) > 1 else 2000
+g = int(sys.argv[2]) if len(sys.argv) > 2 else n
+out = []
+for i in range(n):
+    out.append(f"def f{i}(a, b):")
+    out.append(f"    x = a * {i % 7 + 1} + b - (a // 3) % 5")
+    out.append(f"    y = [a, b, x, {i}]")
+    out.append(f"    if x > b and not (a == {i}) or b <= 2:")
+    out.append(f"        x = x + y[2] - y[0]")
+    out.append(f"    else:")
+    out.append(f"        x = x - 1")
+    out.append(f"    while x > 100:")
+    out.append(f"        x = x // 2")
+    out.append(f"    return x + len(y)")
+    out.append("")
+out.append("s = 0")
+# Beaucoup de globales : stresse la table des symboles (recherche par nom)
+for i in range(g):
+    out.append(f"g{i} = {i} + s")
+for i in range(n):
+    arg = f"g{i % g}" if g else str(i % 13)
+    out.append(f"s = s + f{i}({i}, {arg})")
+for i in range(g):
+    out.append(f"s = s - g{i}")
+out.append("print(s)")
+print("\n".join(out))
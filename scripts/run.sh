@@ -8,7 +8,14 @@ fi
 
 echo "Running pyasm with input: $1"
 
-./build/bin/pyasm "$1"
+# Link against the prebuilt runtime library when it was built (needs NASM at configure time)
+RUNTIME_LIB=./build/lib/libpyasm_rt.a
+if [ -f "$RUNTIME_LIB" ]; then
+    ./build/bin/pyasm --runtime-lib "$1"
+else
+    RUNTIME_LIB=""
+    ./build/bin/pyasm "$1"
+fi
 
 # Convert ast.dot if exists
 if [ -f "ast.dot" ]; then
@@ -32,7 +39,7 @@ fi
 if [ -f "output.asm" ]; then
     echo -e "\nAssembling and executing output.asm..."
     nasm -f elf64 output.asm -o output.o && \
-    ld -nostdlib output.o -o output && \
+    ld -nostdlib output.o $RUNTIME_LIB -o output && \
     echo -e "\nProgram output:" && \
     ./output
     echo -e "\nExecution complete."
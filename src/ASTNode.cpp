@@ -0,0 +1,161 @@
+#include "ASTNode.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+const char* nodeKindName(NodeKind kind) {
+    switch (kind) {
+        case NodeKind::Program: return "Program";
+        case NodeKind::Definitions: return "Definitions";
+        case NodeKind::Instructions: return "Instructions";
+        case NodeKind::FunctionDefinition: return "FunctionDefinition";
+        case NodeKind::FormalParameterList: return "FormalParameterList";
+        case NodeKind::FunctionBody: return "FunctionBody";
+        case NodeKind::Affect: return "Affect";
+        case NodeKind::Return: return "Return";
+        case NodeKind::Print: return "Print";
+        case NodeKind::If: return "If";
+        case NodeKind::IfBody: return "IfBody";
+        case NodeKind::ElseBody: return "ElseBody";
+        case NodeKind::For: return "For";
+        case NodeKind::ForBody: return "ForBody";
+        case NodeKind::While: return "While";
+        case NodeKind::WhileBody: return "WhileBody";
+        case NodeKind::Identifier: return "Identifier";
+        case NodeKind::Integer: return "Integer";
+        case NodeKind::String: return "String";
+        case NodeKind::True: return "True";
+        case NodeKind::False: return "False";
+        case NodeKind::None: return "None";
+        case NodeKind::List: return "List";
+        case NodeKind::ListCall: return "ListCall";
+        case NodeKind::FunctionCall: return "FunctionCall";
+        case NodeKind::ParameterList: return "ParameterList";
+        case NodeKind::Or: return "Or";
+        case NodeKind::And: return "And";
+        case NodeKind::Not: return "Not";
+        case NodeKind::Compare: return "Compare";
+        case NodeKind::ArithOp: return "ArithOp";
+        case NodeKind::TermOp: return "TermOp";
+        case NodeKind::UnaryOp: return "UnaryOp";
+        case NodeKind::Negative: return "Negative";
+        case NodeKind::Suite: return "";
+    }
+    return "Unknown";
+}
+
+const char* valueTypeName(ValueType type) {
+    switch (type) {
+        case ValueType::Auto: return "auto";
+        case ValueType::AutoFun: return "autoFun";
+        case ValueType::Integer: return "Integer";
+        case ValueType::String: return "String";
+        case ValueType::List: return "List";
+        case ValueType::Boolean: return "Boolean";
+        case ValueType::Void: return "void";
+    }
+    return "auto";
+}
+
+ValueType valueTypeOf(std::string_view name) {
+    if (name == "Integer") return ValueType::Integer;
+    if (name == "String") return ValueType::String;
+    if (name == "List") return ValueType::List;
+    if (name == "Boolean") return ValueType::Boolean;
+    if (name == "autoFun") return ValueType::AutoFun;
+    if (name == "void") return ValueType::Void;
+    return ValueType::Auto;
+}
+
+void NodeList::erase(std::size_t index) {
+    if (index >= m_size) return;
+    std::move(m_data + index + 1, m_data + m_size, m_data + index);
+    --m_size;
+}
+
+void* ASTArena::allocate(std::size_t size, std::size_t align) {
+    std::size_t padding = (align - reinterpret_cast<std::uintptr_t>(m_cursor) % align) % align;
+    if (!m_cursor || padding + size > m_remaining) {
+        std::size_t blockSize = std::max(kBlockSize, size + align);
+        m_blocks.push_back(std::make_unique<std::byte[]>(blockSize));
+        m_cursor = m_blocks.back().get();
+        m_remaining = blockSize;
+        m_bytesReserved += blockSize;
+        padding = (align - reinterpret_cast<std::uintptr_t>(m_cursor) % align) % align;
+    }
+    std::byte* p = m_cursor + padding;
+    m_cursor = p + size;
+    m_remaining -= padding + size;
+    m_bytesUsed += padding + size;
+    return p;
+}
+
+std::string_view ASTArena::store(std::string_view text) {
+    if (text.empty()) return {};
+    char* p = static_cast<char*>(allocate(text.size(), 1));
+    std::memcpy(p, text.data(), text.size());
+    return {p, text.size()};
+}
+
+ASTNode* ASTArena::make(NodeKind kind, int line, std::string_view value) {
+    ++m_nodeCount;
+    auto* node = new (allocate(sizeof(ASTNode), alignof(ASTNode))) ASTNode{};
+    node->kind = kind;
+    node->line = line;
+    node->value = store(value);
+    return node;
+}
+
+ASTNode* ASTArena::makeName(NodeKind kind, std::string_view name, int line) {
+    ASTNode* node = make(kind, line);
+    rename(node, name);
+    return node;
+}
+
+ASTNode* ASTArena::makeName(NodeKind kind, Interner::Id id, int line) {
+    ASTNode* node = make(kind, line);
+    node->nameId = id;
+    node->value = m_names.name(id);
+    return node;
+}
+
+void ASTArena::rename(ASTNode* node, std::string_view name) {
+    node->nameId = m_names.intern(name);
+    node->value = m_names.name(node->nameId);
+}
+
+ASTNode* ASTArena::clone(const ASTNode* node) {
+    if (!node) return nullptr;
+    ++m_nodeCount;
+    auto* copy = new (allocate(sizeof(ASTNode), alignof(ASTNode))) ASTNode{};
+    copy->kind = node->kind;
+    copy->type = node->type;
+    copy->line = node->line;
+    copy->nameId = node->nameId;
+    copy->value = node->value;
+    for (const ASTNode* child : node->children) append(copy, clone(child));
+    return copy;
+}
+
+void ASTArena::rename(ASTNode* node, Interner::Id id) {
+    node->nameId = id;
+    node->value = m_names.name(id);
+}
+
+void ASTArena::append(ASTNode* parent, ASTNode* child) {
+    NodeList& list = parent->children;
+    if (list.m_size == list.m_capacity) {
+        std::uint32_t capacity = list.m_capacity ? list.m_capacity * 2 : 2;
+        auto** data = static_cast<ASTNode**>(allocate(capacity * sizeof(ASTNode*), alignof(ASTNode*)));
+        std::copy(list.m_data, list.m_data + list.m_size, data);
+        list.m_data = data;       // the old span stays in the arena until it is released
+        list.m_capacity = capacity;
+    }
+    list.m_data[list.m_size++] = child;
+}
+
+void ASTArena::insert(ASTNode* parent, std::size_t index, ASTNode* child) {
+    append(parent, child);
+    NodeList& list = parent->children;
+    if (index < list.m_size) std::rotate(list.m_data + index, list.m_data + list.m_size - 1, list.m_data + list.m_size);
+}
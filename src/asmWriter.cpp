@@ -0,0 +1,86 @@
+#include "asmWriter.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+FileSink::FileSink(const std::string& path) : m_path(path), m_buffer(std::make_unique<char[]>(kBufferSize)) {
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        throw std::runtime_error("Failed to open output file: " + path);
+    }
+    std::setvbuf(m_file, nullptr, _IONBF, 0); // le tampon est le nôtre
+}
+
+FileSink::~FileSink() {
+    if (m_file) {
+        std::fclose(m_file);
+        std::remove(m_path.c_str());
+    }
+}
+
+void FileSink::write(std::string_view text) {
+    if (m_used + text.size() > kBufferSize) {
+        flush();
+        if (text.size() >= kBufferSize) { // gros bloc : pas de détour par le tampon
+            writeRaw(text.data(), text.size());
+            return;
+        }
+    }
+    std::memcpy(m_buffer.get() + m_used, text.data(), text.size());
+    m_used += text.size();
+}
+
+void FileSink::flush() {
+    writeRaw(m_buffer.get(), m_used);
+    m_used = 0;
+}
+
+void FileSink::close() {
+    if (!m_file) return;
+    flush();
+    bool failed = std::fclose(m_file) != 0;
+    m_file = nullptr;
+    if (failed) {
+        throw std::runtime_error("Failed to write output file: " + m_path);
+    }
+}
+
+void FileSink::writeRaw(const char* data, std::size_t size) {
+    if (size && std::fwrite(data, 1, size, m_file) != size) {
+        throw std::runtime_error("Failed to write output file: " + m_path);
+    }
+}
+
+AsmSection& AsmSection::operator+=(std::string_view text) {
+    m_size += text.size();
+    while (!text.empty()) {
+        if (m_chunks.empty() || m_chunks.back().size() == m_chunks.back().capacity()) {
+            m_chunks.emplace_back().reserve(std::clamp(m_size, kMinChunk, kMaxChunk));
+        }
+        std::string& chunk = m_chunks.back();
+        std::size_t n = std::min(text.size(), chunk.capacity() - chunk.size());
+        chunk.append(text.data(), n);
+        text.remove_prefix(n);
+    }
+    return *this;
+}
+
+void AsmSection::append(AsmSection&& other) {
+    if (m_chunks.empty()) {
+        m_chunks = std::move(other.m_chunks);
+    } else {
+        std::move(other.m_chunks.begin(), other.m_chunks.end(), std::back_inserter(m_chunks));
+    }
+    m_size += other.m_size;
+    other.clear();
+}
+
+void AsmSection::writeTo(OutputSink& sink) const {
+    for (const std::string& chunk : m_chunks) sink.write(chunk);
+}
+
+void AsmSection::clear() {
+    m_chunks.clear();
+    m_size = 0;
+}
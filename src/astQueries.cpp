@@ -0,0 +1,249 @@
+#include "astQueries.h"
+#include <algorithm>
+#include <string>
+
+namespace {
+
+// Pure à elle seule : ni print, ni globale, ni élément de liste affecté, ni appel inconnu
+bool locallyPure(const ASTNode* def, const SymbolTable& globals, const CallGraph& callGraph) {
+    const FunctionSymbol* function = symbolAs<FunctionSymbol>(globals.findImmediateSymbol(def->nameId));
+    if (!function || !function->scope || def->children.size() < 2) return false;
+    const SymbolTable* scope = function->scope;
+
+    std::vector<const ASTNode*> stack{def->children[1]};
+    while (!stack.empty()) {
+        const ASTNode* node = stack.back();
+        stack.pop_back();
+        if (!node) continue;
+        switch (node->kind) {
+        case NodeKind::Print:
+        case NodeKind::FunctionDefinition:
+            return false;
+        case NodeKind::Affect:
+            if (!node->children.empty() && node->children[0] && node->children[0]->kind == NodeKind::ListCall) return false;
+            break;
+        case NodeKind::FunctionCall: {
+            if (node->children.empty() || !node->children[0]) return false;
+            const ASTNode* name = node->children[0];
+            if (callGraph.indexOf(name->nameId) == CallGraph::npos && !isBuiltin(name->value)) return false;
+            // Le nom de l'appelé n'est pas une variable lue
+            for (std::size_t i = 1; i < node->children.size(); ++i) stack.push_back(node->children[i]);
+            continue;
+        }
+        case NodeKind::Identifier:
+            // Ni local ni paramètre : une globale, lue ou écrite
+            if (!scope->findImmediateSymbol(node->nameId)) return false;
+            break;
+        default:
+            break;
+        }
+        for (const ASTNode* child : node->children) stack.push_back(child);
+    }
+    return true;
+}
+
+} // namespace
+
+bool isBlock(const ASTNode* node) {
+    switch (node->kind) {
+        case NodeKind::Instructions: case NodeKind::FunctionBody: case NodeKind::IfBody:
+        case NodeKind::ElseBody: case NodeKind::ForBody: case NodeKind::WhileBody:
+            return true;
+        default:
+            return false;
+    }
+}
+
+const NodeList* argumentsOf(const ASTNode* call) {
+    if (call->children.size() > 1 && call->children[1] && call->children[1]->kind == NodeKind::ParameterList) {
+        return &call->children[1]->children;
+    }
+    return nullptr;
+}
+
+bool isCallTo(const ASTNode* node, std::string_view name) {
+    return node->kind == NodeKind::FunctionCall && !node->children.empty() && node->children[0]
+           && node->children[0]->value == name;
+}
+
+bool isLen(const ASTNode* node) {
+    const NodeList* args = isCallTo(node, "len") ? argumentsOf(node) : nullptr;
+    return args && args->size() == 1;
+}
+
+bool isIndexRange(const ASTNode* iterable) {
+    const NodeList* args = isCallTo(iterable, "range") ? argumentsOf(iterable) : nullptr;
+    if (!args || args->size() != 1 || !(*args)[0] || !isLen((*args)[0])) return false;
+    const ASTNode* list = (*argumentsOf((*args)[0]))[0];
+    return list && list->kind == NodeKind::Identifier;
+}
+
+bool isBuiltin(std::string_view name) {
+    return name == "len" || name == "list" || name == "range";
+}
+
+bool isUserCall(const ASTNode* node) {
+    if (node->kind != NodeKind::FunctionCall) return false;
+    return node->children.empty() || !node->children[0] || !isBuiltin(node->children[0]->value);
+}
+
+// Pureté locale de chaque fonction, puis propagation : un appelé impur rend l'appelant impur
+std::vector<bool> analysePurity(const SymbolTable& globals, const CallGraph& callGraph) {
+    std::vector<bool> pure(callGraph.size(), false);
+    for (std::size_t f = 0; f < callGraph.size(); ++f) pure[f] = locallyPure(callGraph.definition(f), globals, callGraph);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (std::size_t f = 0; f < callGraph.size(); ++f) {
+            if (!pure[f]) continue;
+            const std::vector<std::size_t>& callees = callGraph.callees(f);
+            if (std::all_of(callees.begin(), callees.end(), [&pure](std::size_t g) { return pure[g]; })) continue;
+            pure[f] = false;
+            changed = true;
+        }
+    }
+    return pure;
+}
+
+bool isImpureCall(const ASTNode* node, const CallGraph& callGraph, const std::vector<bool>& pure) {
+    if (!isUserCall(node) || node->children.empty() || !node->children[0]) return false;
+    std::size_t f = callGraph.indexOf(node->children[0]->nameId);
+    return f == CallGraph::npos || !pure[f];
+}
+
+bool canFail(const ASTNode* node) {
+    if (node->kind == NodeKind::ListCall) return true;
+    if (node->kind != NodeKind::TermOp || node->value == "*") return false;
+    const ASTNode* divisor = node->children.size() > 1 ? node->children[1] : nullptr;
+    return !divisor || divisor->kind != NodeKind::Integer || divisor->value.find_first_not_of('0') == std::string_view::npos;
+}
+
+bool mayFail(const ASTNode* node) {
+    if (!node) return false;
+    if (canFail(node)) return true;
+    return std::any_of(node->children.begin(), node->children.end(), mayFail);
+}
+
+bool mayPrintOrStop(const ASTNode* node) {
+    return canFail(node) || isUserCall(node);
+}
+
+bool isPureExpression(const ASTNode* node) {
+    if (!node) return false;
+    switch (node->kind) {
+    case NodeKind::Identifier: case NodeKind::Integer: case NodeKind::String:
+    case NodeKind::True: case NodeKind::False:
+        return true;
+    case NodeKind::ArithOp:
+        if (node->value == "+") {
+            for (const ASTNode* operand : node->children) {
+                if (operand && (operand->type == ValueType::String || operand->type == ValueType::List)) return false;
+            }
+        }
+        break;
+    case NodeKind::TermOp: case NodeKind::Compare: case NodeKind::UnaryOp:
+    case NodeKind::Not: case NodeKind::And: case NodeKind::Or:
+        break;
+    case NodeKind::ListCall:
+        if (node->children.size() != 2 || !node->children[0] || node->children[0]->kind != NodeKind::Identifier) return false;
+        break;
+    case NodeKind::FunctionCall:
+        return isLen(node) && isPureExpression((*argumentsOf(node))[0]);
+    default:
+        return false;
+    }
+    if (node->children.empty()) return false;
+    return std::all_of(node->children.begin(), node->children.end(), isPureExpression);
+}
+
+bool isReusableExpression(const ASTNode* node) {
+    switch (node->kind) {
+    case NodeKind::ArithOp: case NodeKind::TermOp: case NodeKind::Compare: case NodeKind::Not:
+    case NodeKind::And: case NodeKind::Or: case NodeKind::ListCall:
+        break;
+    case NodeKind::UnaryOp:
+        if (node->children.size() == 1 && node->children[0] && node->children[0]->kind == NodeKind::Integer) return false; // -5
+        break;
+    case NodeKind::FunctionCall:
+        if (!isLen(node)) return false;
+        break;
+    default:
+        return false;
+    }
+    return isPureExpression(node);
+}
+
+void structureKey(const ASTNode* node, std::string& key, Accesses* reads) {
+    if (!node) {
+        key += '_';
+        return;
+    }
+    key += static_cast<char>('A' + static_cast<int>(node->kind));
+    key += static_cast<char>('a' + static_cast<int>(node->type));
+    if (node->kind == NodeKind::Identifier) {
+        key += std::to_string(node->nameId);
+        if (reads && std::find(reads->variables.begin(), reads->variables.end(), node->nameId) == reads->variables.end()) {
+            reads->variables.push_back(node->nameId);
+        }
+        return;
+    }
+    key += std::to_string(node->value.size());
+    key += ':';
+    key += node->value;
+    if (reads && node->kind == NodeKind::ListCall) reads->lists = true;
+    key += '(';
+    for (std::size_t c = 0; c < node->children.size(); ++c) {
+        // Le nom de la fonction appelée (len) n'est pas une variable lue
+        if (node->kind == NodeKind::FunctionCall && c == 0) continue;
+        structureKey(node->children[c], key, reads);
+        key += ',';
+    }
+    key += ')';
+}
+
+void collectWrites(const ASTNode* node, const CallGraph& callGraph, const std::vector<bool>& pure, Accesses& writes) {
+    if (!node) return;
+    if (node->kind == NodeKind::Affect || node->kind == NodeKind::For) {
+        const ASTNode* target = node->children.empty() ? nullptr : node->children[0];
+        if (target && target->kind == NodeKind::Identifier) writes.variables.push_back(target->nameId);
+        else if (target && target->kind == NodeKind::ListCall) writes.lists = true;
+    }
+    if (isImpureCall(node, callGraph, pure)) writes.lists = true;
+    for (const ASTNode* child : node->children) collectWrites(child, callGraph, pure, writes);
+}
+
+bool changes(const Accesses& writes, const Accesses& reads) {
+    if (writes.lists && reads.lists) return true;
+    return std::any_of(reads.variables.begin(), reads.variables.end(), [&](Interner::Id read) {
+        return std::find(writes.variables.begin(), writes.variables.end(), read) != writes.variables.end();
+    });
+}
+
+bool enterFunction(FrameScope& frame, SymbolTable& globals, const ASTNode* def) {
+    frame.function = symbolAs<FunctionSymbol>(globals.findImmediateSymbol(def->nameId));
+    frame.scope = frame.function ? frame.function->scope : nullptr;
+    if (!frame.scope) return false;
+    // Sous les locaux trouvés par discoverLocalsAndAssignOffsets et ceux des passes précédentes
+    for (const Symbol* symbol : frame.scope->symbols) {
+        if (symbol->kind == SymbolKind::Variable && symbol->category != "parameter") {
+            frame.nextOffset = std::min(frame.nextOffset, symbol->offset - 8);
+        }
+    }
+    return true;
+}
+
+Interner::Id addTemporary(FrameScope& frame, const Interner& names, std::string_view prefix, std::size_t& counter) {
+    std::string name;
+    do {
+        name = std::string(prefix) + std::to_string(counter++);
+    } while (names.find(name) != Interner::kNoId); // jamais un nom du source
+    VariableSymbol* symbol = nullptr;
+    if (frame.function) {
+        symbol = frame.scope->addSymbol<VariableSymbol>(name, "auto", "variable", false, frame.nextOffset);
+        frame.nextOffset -= 8;
+        frame.function->frameSize = frameSizeForLocals(-(frame.nextOffset + 8));
+    } else {
+        symbol = frame.scope->addSymbol<VariableSymbol>(name, "auto", "global", true, 0);
+    }
+    return symbol->id;
+}
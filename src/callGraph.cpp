@@ -0,0 +1,132 @@
+#include "callGraph.h"
+#include <algorithm>
+
+void CallGraph::build(const ASTNode* root) {
+    m_functions.clear();
+    m_mainCallees.clear();
+    m_index.clear();
+    if (!root) return;
+
+    // Sommets : les définitions aplaties (une redéfinition garde le sommet de la première)
+    std::vector<const ASTNode*> mainBody;
+    for (const ASTNode* child : root->children) {
+        if (!child) continue;
+        if (child->kind != NodeKind::Definitions) {
+            mainBody.push_back(child);
+            continue;
+        }
+        for (const ASTNode* def : child->children) {
+            if (!def || def->kind != NodeKind::FunctionDefinition || !def->hasName()) continue;
+            if (m_index.emplace(def->nameId, m_functions.size()).second) {
+                m_functions.push_back(Function{def, {}, 0, false, false});
+            }
+        }
+    }
+
+    // Arêtes
+    for (std::size_t f = 0; f < m_functions.size(); ++f) {
+        std::vector<std::size_t> callees;
+        collectCalls(m_functions[f].definition, callees);
+        m_functions[f].callees = std::move(callees);
+    }
+    for (const ASTNode* node : mainBody) collectCalls(node, m_mainCallees);
+
+    markReachable();
+    markRecursive();
+}
+
+std::size_t CallGraph::indexOf(Interner::Id name) const {
+    auto it = m_index.find(name);
+    return it != m_index.end() ? it->second : npos;
+}
+
+bool CallGraph::reachable(Interner::Id name) const {
+    std::size_t f = indexOf(name);
+    return f != npos && m_functions[f].reachable;
+}
+
+std::size_t CallGraph::reachableCount() const {
+    return static_cast<std::size_t>(std::count_if(m_functions.begin(), m_functions.end(),
+                                                  [](const Function& fn) { return fn.reachable; }));
+}
+
+std::size_t CallGraph::recursiveCount() const {
+    return static_cast<std::size_t>(std::count_if(m_functions.begin(), m_functions.end(),
+                                                  [](const Function& fn) { return fn.recursive; }));
+}
+
+// Appels (résolus par firstPass vers les noms décorés) contenus dans body ; les builtins n'ont pas de sommet
+void CallGraph::collectCalls(const ASTNode* body, std::vector<std::size_t>& callees) {
+    std::vector<const ASTNode*> stack{body};
+    while (!stack.empty()) {
+        const ASTNode* node = stack.back();
+        stack.pop_back();
+        if (!node) continue;
+        if (node->kind == NodeKind::FunctionCall && !node->children.empty() && node->children[0]) {
+            std::size_t callee = indexOf(node->children[0]->nameId);
+            if (callee != npos) {
+                ++m_functions[callee].callSites;
+                if (std::find(callees.begin(), callees.end(), callee) == callees.end()) callees.push_back(callee);
+            }
+        }
+        for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) stack.push_back(*it);
+    }
+}
+
+void CallGraph::markReachable() {
+    std::vector<std::size_t> worklist(m_mainCallees.begin(), m_mainCallees.end());
+    while (!worklist.empty()) {
+        std::size_t f = worklist.back();
+        worklist.pop_back();
+        if (m_functions[f].reachable) continue;
+        m_functions[f].reachable = true;
+        for (std::size_t callee : m_functions[f].callees) {
+            if (!m_functions[callee].reachable) worklist.push_back(callee);
+        }
+    }
+}
+
+// Composantes fortement connexes (Tarjan, itératif : pas de récursion sur de longues chaînes d'appels)
+void CallGraph::markRecursive() {
+    constexpr std::size_t unvisited = npos;
+    std::vector<std::size_t> index(m_functions.size(), unvisited), low(m_functions.size(), 0);
+    std::vector<bool> onStack(m_functions.size(), false);
+    std::vector<std::size_t> sccStack;
+    std::vector<std::pair<std::size_t, std::size_t>> dfs; // (sommet, prochain appelé à explorer)
+    std::size_t counter = 0;
+
+    for (std::size_t start = 0; start < m_functions.size(); ++start) {
+        if (index[start] != unvisited) continue;
+        dfs.emplace_back(start, 0);
+        while (!dfs.empty()) {
+            auto& [f, next] = dfs.back();
+            if (next == 0 && index[f] == unvisited) {
+                index[f] = low[f] = counter++;
+                sccStack.push_back(f);
+                onStack[f] = true;
+            }
+            const std::vector<std::size_t>& callees = m_functions[f].callees;
+            if (next < callees.size()) {
+                std::size_t callee = callees[next++];
+                if (callee == f) m_functions[f].recursive = true;
+                if (index[callee] == unvisited) dfs.emplace_back(callee, 0);
+                else if (onStack[callee]) low[f] = std::min(low[f], index[callee]);
+                continue;
+            }
+            // f est terminé : racine d'une composante ?
+            if (low[f] == index[f]) {
+                std::size_t first = sccStack.size();
+                while (sccStack[--first] != f) {}
+                bool cycle = sccStack.size() - first > 1;
+                for (std::size_t i = first; i < sccStack.size(); ++i) {
+                    onStack[sccStack[i]] = false;
+                    if (cycle) m_functions[sccStack[i]].recursive = true;
+                }
+                sccStack.resize(first);
+            }
+            std::size_t done = f;
+            dfs.pop_back();
+            if (!dfs.empty()) low[dfs.back().first] = std::min(low[dfs.back().first], low[done]);
+        }
+    }
+}
@@ -1,37 +1,151 @@
 #include "codeGenerator.h"
-#include <fstream>
+#include <algorithm>
+#include <charconv>
+#include <limits>
 #include <stdexcept>
 #include <cstdlib>
-#include <sstream>
-#include <functional>
 #include <unordered_set>
+#include "runtime.h"
+#include "threadPool.h"
 
-static std::string asmCode; // Stores the final assembly code
 
-SymbolTable* currentSymbolTable = nullptr;
-std::string currentFunction; // Keep track of the current function for return
+// Type posé par la passe de typage ; un noeud absent (AST partiel après une erreur) reste "auto"
+static ValueType typeOf(const ASTNode* node) {
+    return node ? node->type : ValueType::Auto;
+}
+
+static std::size_t nodeCount(const ASTNode* node) {
+    if (!node) return 0;
+    std::size_t count = 1;
+    for (const ASTNode* child : node->children) count += nodeCount(child);
+    return count;
+}
+
+static bool isIntegral(const ASTNode* node) {
+    return node && (node->type == ValueType::Integer || node->type == ValueType::Auto);
+}
+
+static bool sameVariable(const ASTNode* a, const ASTNode* b) {
+    return a && b && a->kind == NodeKind::Identifier && b->kind == NodeKind::Identifier && a->nameId == b->nameId;
+}
+
+// L[i] : élément entier d'une variable liste, à l'indice index
+static bool isIndexed(const ASTNode* node, const ASTNode* index) {
+    return node && node->kind == NodeKind::ListCall && node->children.size() == 2 && node->children[0]
+           && node->children[0]->kind == NodeKind::Identifier && typeOf(node->children[0]) == ValueType::List
+           && sameVariable(node->children[1], index) && isIntegral(node);
+}
+
+// a + b que visitNode traduit par un add entier (les deux opérandes du même type)
+static bool isIntegerAdd(const ASTNode* node) {
+    return node && node->kind == NodeKind::ArithOp && node->value == "+" && node->children.size() == 2
+           && node->children[0] && node->children[1] && typeOf(node->children[0]) == typeOf(node->children[1])
+           && isIntegral(node->children[0]);
+}
+
+// a < b <=> b > a
+static std::string_view flipped(std::string_view compare) {
+    if (compare == "<") return ">";
+    if (compare == ">") return "<";
+    if (compare == "<=") return ">=";
+    if (compare == ">=") return "<=";
+    return compare;
+}
+
+static std::string conditionCode(std::string_view compare) {
+    if (compare == "<") return "l";
+    if (compare == ">") return "g";
+    if (compare == "<=") return "le";
+    if (compare == ">=") return "ge";
+    if (compare == "==") return "e";
+    return "ne";
+}
+
+// La variable est-elle affectée (ou variable d'un for) quelque part sous node ?
+static bool assigns(const ASTNode* node, Interner::Id name) {
+    if (!node) return false;
+    if ((node->kind == NodeKind::Affect || node->kind == NodeKind::For) && !node->children.empty() && node->children[0]
+        && node->children[0]->kind == NodeKind::Identifier && node->children[0]->nameId == name) {
+        return true;
+    }
+    return std::any_of(node->children.begin(), node->children.end(), [name](const ASTNode* child) { return assigns(child, name); });
+}
+
+// Plus grande expression calculée sans condition par un if/else sans saut
+static constexpr std::size_t kMaxSpeculatedSize = 8;
+
+/* Expression que l'on peut calculer même si sa branche ne s'exécute pas : sans effet ni erreur
+ * possible (ni appel, ni lecture d'élément, ni division, ni allocation) et traduite par visitNode en
+ * quelques instructions sur rax / rbx */
+static bool isSpeculable(const ASTNode* node) {
+    if (!node) return false;
+    switch (node->kind) {
+    case NodeKind::Identifier:
+    case NodeKind::Integer:
+    case NodeKind::String:
+    case NodeKind::True:
+    case NodeKind::False:
+        return true;
+    case NodeKind::ArithOp:
+        if (node->children.size() != 2 || !isIntegral(node->children[0]) || !isIntegral(node->children[1])) return false;
+        if (node->value == "+" && !isIntegerAdd(node)) return false;
+        if (node->value != "+" && node->value != "-") return false;
+        break;
+    case NodeKind::TermOp:
+        if (node->value != "*" || node->children.size() != 2 || !isIntegral(node->children[0]) || !isIntegral(node->children[1])) return false;
+        break;
+    case NodeKind::UnaryOp:
+        if (node->value != "-" || node->children.size() != 1 || typeOf(node->children[0]) != ValueType::Integer) return false;
+        break;
+    case NodeKind::Compare:
+        if (node->children.size() != 2 || !isIntegral(node->children[0]) || !isIntegral(node->children[1])) return false;
+        break;
+    case NodeKind::Not:
+        if (node->children.size() != 1) return false;
+        break;
+    default:
+        return false;
+    }
+    return std::all_of(node->children.begin(), node->children.end(), isSpeculable);
+}
+
+// Unique instruction d'un corps de if / else, si c'est l'affectation d'une variable
+static const ASTNode* singleAffect(const ASTNode* body) {
+    if (!body || body->children.size() != 1) return nullptr;
+    const ASTNode* statement = body->children[0];
+    if (!statement || statement->kind != NodeKind::Affect || statement->children.size() != 2 || !statement->children[0]
+        || statement->children[0]->kind != NodeKind::Identifier) {
+        return nullptr;
+    }
+    return statement;
+}
 
 std::string CodeGenerator::getIdentifierMemoryOperand(const std::string& name) {
-    Symbol* sym = nullptr;
-    SymbolTable* lookupScope = currentSymbolTable ? currentSymbolTable : symbolTable; // Start with current, fallback to global
+    const Symbol* sym = nullptr;
+    const SymbolTable* lookupScope = currentSymbolTable ? currentSymbolTable : symbolTable; // Start with current, fallback to global
 
     if (lookupScope) {
         sym = lookupScope->findSymbol(name); // findSymbol searches current then parent scopes
     }
 
     if (sym) {
-        if (auto vs = dynamic_cast<VariableSymbol*>(sym)) {
-            if (vs->isGlobal) {
-                return "qword [" + name + "]";
-            } else if (vs->category == "parameter") {
-                // Parameters are at positive offsets from rbp
-                return "qword [rbp + " + std::to_string(vs->offset) + "]";
-            } else { // Catches "variable" (locals, loop vars with negative offsets)
-                return std::string("qword [rbp") + (vs->offset < 0 ? " - " : " + ") 
-                       + std::to_string(std::abs(vs->offset)) + "]";
+        switch (sym->kind) {
+            case SymbolKind::Variable: {
+                auto vs = static_cast<const VariableSymbol*>(sym);
+                if (vs->isGlobal) {
+                    return "qword [" + name + "]";
+                } else if (vs->category == "parameter") {
+                    // Parameters are at positive offsets from rbp
+                    return "qword [rbp + " + std::to_string(vs->offset) + "]";
+                } else { // Catches "variable" (locals, loop vars with negative offsets)
+                    return std::string("qword [rbp") + (vs->offset < 0 ? " - " : " + ") 
+                           + std::to_string(std::abs(vs->offset)) + "]";
+                }
             }
-        } else if (dynamic_cast<FunctionSymbol*>(sym)) { // Check type without assigning to unused fs
-            return name; // Function name used as a label
+            case SymbolKind::Function:
+                return name; // Function name used as a label
+            case SymbolKind::Array:
+                break;
         }
     }
 
@@ -41,11 +155,11 @@ std::string CodeGenerator::getIdentifierMemoryOperand(const std::string& name) {
 }
 
 
-void CodeGenerator::emitGlobals(SymbolTable* globalScope)
+void CodeGenerator::emitGlobals(const SymbolTable* globalScope)
 {
     if (!globalScope) return;
-    for (auto& sp : globalScope->symbols)
-        if (auto *vs = dynamic_cast<VariableSymbol*>(sp.get());
+    for (Symbol* sp : globalScope->symbols)
+        if (auto *vs = symbolAs<VariableSymbol>(sp);
             vs && vs->isGlobal)                       // <-- only globals
         {
             // Avoid duplicate emission 
@@ -54,10 +168,15 @@ void CodeGenerator::emitGlobals(SymbolTable* globalScope)
         }
 }
 
-void CodeGenerator::generateCode(const std::shared_ptr<ASTNode>& root, const std::string& filename, SymbolTable* symTable) {
+void CodeGenerator::generateCode(ASTNode* root, const std::string& filename, const SymbolTable* symTable) {
+    FileSink sink(filename);
+    generateCode(root, sink, symTable);
+    sink.close();
+}
+
+void CodeGenerator::generateCode(ASTNode* root, OutputSink& out, const SymbolTable* symTable) {
     this->symbolTable = symTable;
     this->currentSymbolTable = symbolTable; // Initially global
-    this->rootNode = root;
     this->declaredVars.clear();
 
     // Call startAssembly to initialize .data, .bss sections and get initial .text headers.
@@ -65,51 +184,176 @@ void CodeGenerator::generateCode(const std::shared_ptr<ASTNode>& root, const std
     startAssembly();
     emitGlobals(symTable);                     
 
-    std::string functionDefinitionsContent = ""; // Buffer for all function definitions
-    std::string mainInstructionsContent = "";  // Buffer for main program instructions
+    // Globals do not depend on the units: stream them right away
+    this->bssSection.writeTo(out);
+    this->bssSection.clear();
+    out.write("global _start\n");
+    out.write("\nsection .text\n");
+
+    AsmSection mainInstructionsContent;  // Main program instructions, written after the functions with _start
+    AsmSection literals;                 // Data emitted by the units, written last in a .data section
 
-    // First pass: Generate code for functions and main instructions into separate buffers.
+    // Independent units, in program order: each function definition, then the main instructions
+    std::vector<ASTNode*> units;
     for (const auto& childNodeOfProgram : root->children) {
-        if (childNodeOfProgram->type == "Definitions") {
+        if (childNodeOfProgram->kind == NodeKind::Definitions) {
             for (const auto& definitionNode : childNodeOfProgram->children) {
-                if (definitionNode->type == "FunctionDefinition") {
-                    this->textSection = ""; 
-                    visitNode(definitionNode); 
-                    functionDefinitionsContent += this->textSection; 
+                if (definitionNode->kind != NodeKind::FunctionDefinition) continue;
+                // Functions the main program can never reach are not generated
+                if (m_callGraph && !m_callGraph->reachable(definitionNode->nameId)) continue;
+                units.push_back(definitionNode);
+            }
+        } else {
+            units.push_back(childNodeOfProgram);
+        }
+    }
+    internStrings(units);
+
+    // Units only read the typed AST and the frozen symbol table: generate them concurrently, one
+    // window at a time, so that only a window of generated units is held before being streamed out
+    const std::size_t window = std::max(m_jobs, 1u) * kUnitsPerThread;
+    std::vector<GeneratedUnit> generated(std::min(window, units.size()));
+    ThreadPool pool(static_cast<unsigned>(std::min<std::size_t>(m_jobs, units.size())));
+    bool functionsHeader = false;
+
+    for (std::size_t base = 0; base < units.size(); base += window) {
+        std::size_t count = std::min(window, units.size() - base);
+        pool.parallelFor(count, [&](std::size_t i) { generateUnit(units[base + i], generated[i]); });
+
+        // Deterministic merge, in program order (errors included)
+        for (std::size_t i = 0; i < count; ++i) {
+            GeneratedUnit& unit = generated[i];
+            m_errorManager.append(unit.errors);
+            if (unit.failure) std::rethrow_exception(unit.failure);
+            literals.append(std::move(unit.data));
+            m_runtime.merge(unit.runtime);
+            if (units[base + i]->kind == NodeKind::FunctionDefinition) {
+                if (!functionsHeader) {
+                    out.write("\n; Functions\n");
+                    functionsHeader = true;
                 }
+                unit.text.writeTo(out);
+            } else {
+                mainInstructionsContent.append(std::move(unit.text));
             }
-        } else { 
-            this->textSection = ""; 
-            visitNode(childNodeOfProgram);
-            mainInstructionsContent += this->textSection; 
+            unit = GeneratedUnit{};
         }
     }
 
-    this->textSection = ""; 
-    this->textSection += "global _start\n";
-    this->textSection += "\nsection .text\n";
+    this->textSection.clear(); 
     this->textSection += "_start:\n";                 
     this->textSection += "    push rbp\n";
     this->textSection += "    mov rbp, rsp\n";
-    this->textSection += mainInstructionsContent;     
+    if (!m_prerenderedOutput.empty()) {
+        this->textSection += "    ; output of the statements evaluated at compile time\n";
+        this->textSection += "    mov rax, 1\n";
+        this->textSection += "    mov rdi, 1\n";
+        this->textSection += "    mov rsi, prerendered_output\n";
+        this->textSection += "    mov rdx, prerendered_output_len\n";
+        this->textSection += "    syscall\n";
+    }
+    this->textSection.append(std::move(mainInstructionsContent));
     
-    // endAssembly appends runtime helper functions (like print_number, exit syscall)
-    // to the *end* of the current this->textSection.
+    // endAssembly appends the exit syscall and the runtime helpers used by the program
+    // to the *end* of the current this->textSection, and their data to data/bss.
     endAssembly(); 
+    this->textSection.writeTo(out);
 
-    // Build the final assembly file content
-    std::stringstream finalAsm;
-    finalAsm << this->dataSection;      
-    finalAsm << this->bssSection;       
-    finalAsm << this->textSection;      
-    
-    if (!functionDefinitionsContent.empty()) {
-        finalAsm << "\n; Functions\n";
-        finalAsm << functionDefinitionsContent; 
+    if (!this->dataSection.empty() || !literals.empty()) {
+        out.write("\nsection .data\n");
+        this->dataSection.writeTo(out);
+        literals.writeTo(out);
     }
-    
-    asmCode = finalAsm.str();
-    writeToFile(filename);
+    if (!m_stringOrder.empty() || !m_prerenderedOutput.empty()) {
+        out.write("\nsection .rodata\n");
+        for (std::string_view value : m_stringOrder) out.write(stringDirective(m_stringPool.at(value), value));
+        if (!m_prerenderedOutput.empty()) out.write(bytesDirective("prerendered_output", m_prerenderedOutput));
+    }
+    if (!this->bssSection.empty()) {
+        out.write("\nsection .bss\n");
+        this->bssSection.writeTo(out);
+    }
+    out.flush();
+}
+
+/* Génère une unité (fonction ou instructions principales) dans un générateur qui lui est propre :
+ * compteurs de labels, tampons et erreurs locaux, aucun état partagé en écriture. */
+void CodeGenerator::generateUnit(ASTNode* node, GeneratedUnit& unit) const {
+    CodeGenerator unitGenerator(unit.errors);
+    unitGenerator.symbolTable = symbolTable;
+    unitGenerator.currentSymbolTable = symbolTable;
+    unitGenerator.m_stringLabels = m_stringLabels;
+    unitGenerator.m_unroll = m_unroll;
+    unitGenerator.m_vectorize = m_vectorize;
+    unitGenerator.m_branchless = m_branchless;
+    try {
+        unitGenerator.visitNode(node);
+    } catch (...) {
+        unit.failure = std::current_exception();
+    }
+    unit.text = std::move(unitGenerator.textSection);
+    unit.data = std::move(unitGenerator.dataSection);
+    unit.runtime = unitGenerator.m_runtime;
+}
+
+/* Interne les littéraux chaîne de tout le programme, dans l'ordre de première apparition. La table
+ * est remplie avant la génération parallèle, puis seulement lue par les unités. */
+void CodeGenerator::internStrings(const std::vector<ASTNode*>& units) {
+    m_stringPool.clear();
+    m_stringOrder.clear();
+    m_stringLabels = &m_stringPool;
+    std::vector<const ASTNode*> stack(units.rbegin(), units.rend());
+    while (!stack.empty()) {
+        const ASTNode* node = stack.back();
+        stack.pop_back();
+        if (!node) continue;
+        if (node->kind == NodeKind::String) {
+            // '$' n'entre dans aucun identificateur MiniPython : pas de collision avec une variable
+            std::string label = "str$" + std::to_string(m_stringOrder.size());
+            if (m_stringPool.emplace(node->value, std::move(label)).second) m_stringOrder.push_back(node->value);
+        }
+        // Enfants empilés à l'envers : parcours préfixe, de gauche à droite
+        for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) stack.push_back(*it);
+    }
+}
+
+std::string CodeGenerator::stringDirective(const std::string& label, std::string_view value) {
+    std::string strValue(value);
+    size_t pos = 0;
+    while ((pos = strValue.find('"', pos)) != std::string::npos) {
+        strValue.replace(pos, 1, "\", '\"', \""); // NASM way to include a quote
+        pos += 9; 
+    }
+    return label + ": db \"" + strValue + "\", 0\n";
+}
+
+/* Octets quelconques (sans 0 final) : les caractères imprimables entre guillemets, les autres en
+ * nombres, quelques dizaines par ligne */
+std::string CodeGenerator::bytesDirective(const std::string& label, std::string_view bytes) {
+    constexpr std::size_t kBytesPerLine = 64;
+    std::string directive = label + ":";
+    for (std::size_t start = 0; start < bytes.size(); start += kBytesPerLine) {
+        std::string_view line = bytes.substr(start, kBytesPerLine);
+        directive += "    db ";
+        bool quoted = false;
+        for (std::size_t i = 0; i < line.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(line[i]);
+            bool printable = c >= 32 && c <= 126 && c != '"' && c != '`';
+            if (printable != quoted) {
+                if (quoted) directive += "\"";
+                if (i > 0) directive += ", ";
+                if (printable) directive += "\"";
+                quoted = printable;
+            } else if (!printable && i > 0) {
+                directive += ", ";
+            }
+            if (printable) directive += static_cast<char>(c);
+            else directive += std::to_string(c);
+        }
+        if (quoted) directive += "\"";
+        directive += "\n";
+    }
+    return directive + label + "_len: equ $ - " + label + "\n";
 }
 
 void CodeGenerator::startAssembly() {
@@ -120,31 +364,12 @@ void CodeGenerator::startAssembly() {
     this->labelCounter = 0;
     this->loopLabelCounter = 0;
     this->ifLabelCounter = 0;
-    this->stringLabelCounter = 0;
     this->currentFunction.clear();
+    this->m_listConstants.clear();
+    this->m_runtime = RuntimeUsage{};
 
-
-    this->dataSection += "section .data\n";
-    this->dataSection += "    concat_buffer: times 2048 db 0\n";
-    this->dataSection += "    concat_offset: dq 0\n";
-    this->dataSection += "    div_zero_msg: db 'Error: Division by zero', 10, 0\n";
-    this->dataSection += "    div_zero_len: equ $ - div_zero_msg\n";
-    this->dataSection += "    list_buffer: times 8192 dq 0\n"; 
-    this->dataSection += "    list_offset: dq 0\n";
-    this->dataSection += "    open_bracket: db '['\n";
-    this->dataSection += "    close_bracket: db ']'\n";
-    this->dataSection += "    comma_space: db ',', 32\n";
-    this->dataSection += "    index_error_msg: db 'Error: Index out of bounds', 10, 0\n";
-    this->dataSection += "    index_error_len: equ $ - index_error_msg\n";
-    this->dataSection += "    newline: db 10\n";
-    this->dataSection += "    space: db 32\n";
-    this->dataSection += "    minus_sign: db '-'\n";
-
-
-    this->bssSection += "\nsection .bss\n";
-    this->bssSection += "    buffer: resb 32 ; For print_number\n";
-
-
+    // Runtime data is only emitted at the end, for the helpers the program uses (see endAssembly)
+    this->bssSection += "section .bss\n";
 }
 
 
@@ -160,78 +385,71 @@ void CodeGenerator::toBool(const std::string& reg) {
     textSection += "    movzx " + reg + ", al\n"; // reg = 0/1
 }
 
-void CodeGenerator::visitNode(const std::shared_ptr<ASTNode>& node) {
+void CodeGenerator::visitNode(ASTNode* node) {
     if (!node) return;
     
-    if (node->type == "Affect") {
+    if (node->kind == NodeKind::Affect) {
         genAffect(node);
-    } else if (node->type == "FunctionDefinition") {
-        SymbolTable* previousTable = currentSymbolTable;
+    } else if (node->kind == NodeKind::FunctionDefinition) {
+        const SymbolTable* previousTable = currentSymbolTable;
         if (symbolTable) { 
-            for (const auto& childScope : symbolTable->children) { 
-                if (childScope->scopeName == "function " + node->value) {
-                    currentSymbolTable = childScope.get();
-                    break;
-                }
+            if (SymbolTable* scope = symbolTable->findFunctionScope(node->value)) {
+                currentSymbolTable = scope;
             }
         }
         currentFunction = node->value; 
         genFunction(node); 
         currentFunction.clear(); 
         currentSymbolTable = previousTable; 
-        resetFunctionVarTypes(node->value);
-    } else if (node->type == "FunctionCall") {
+    } else if (node->kind == NodeKind::FunctionCall) {
         genFunctionCall(node);
-    } else if (node->type == "Return") {
+    } else if (node->kind == NodeKind::Return) {
         genReturn(node);
-    } else if (node->type == "Identifier") {
-        std::string name = node->value;
+    } else if (node->kind == NodeKind::Identifier) {
+        std::string name(node->value);
         textSection += "    mov rax, " + getIdentifierMemoryOperand(name) + "\n";
-    } else if (node->type == "Integer") {
-        textSection += "    mov rax, " + node->value + "\n";
-    } else if (node->type == "String") {
-        std::string strLabel = "str_" + std::to_string(this->stringLabelCounter++); 
-        std::string strValue = node->value;
-        
-        size_t pos = 0;
-        while ((pos = strValue.find('"', pos)) != std::string::npos) {
-            strValue.replace(pos, 1, "\", '\"', \""); // NASM way to include a quote
-            pos += 9; 
-        }
-        this->dataSection += strLabel + ": db \"" + strValue + "\", 0\n";
-        this->textSection += "    mov rax, " + strLabel + "\n";
-    } else if (node->type == "List") {
+    } else if (node->kind == NodeKind::Integer) {
+        textSection += "    mov rax, " + std::string(node->value) + "\n";
+    } else if (node->kind == NodeKind::String) {
+        // Literals are interned before generation: identical contents share one label in .rodata
+        this->textSection += "    mov rax, " + m_stringLabels->at(node->value) + "\n";
+    } else if (node->kind == NodeKind::List) {
         genList(node); // genList should put the list address in rax
-    } else if (node->type == "True") {
+    } else if (node->kind == NodeKind::True) {
         textSection += "    mov rax, 1\n";
-    } else if (node->type == "False") {
+    } else if (node->kind == NodeKind::False) {
         textSection += "    mov rax, 0\n";
-    } else if (node->type == "If") { 
+    } else if (node->kind == NodeKind::If) { 
         genIf(node);
-    } else if (node->type == "For") {
+    } else if (node->kind == NodeKind::For) {
         genFor(node);
-    } else if (node->type == "While") {
+    } else if (node->kind == NodeKind::While) {
         genWhile(node);
-    } else if (node->type == "Print") {
+    } else if (node->kind == NodeKind::Print) {
         if (!node->children.empty()) {
             for (size_t i = 0; i < node->children.size(); ++i) {
                 const auto& argNode = node->children[i];
                 visitNode(argNode); // Evaluate argument, result in RAX
-                std::string argType = getExpressionType(argNode);
-				if (argType == "auto" || argType == "autoFun")
-    argType = "Integer";
-                if (argType == "Integer" || argType == "Boolean" || argType == "autoFun" ) {
+                ValueType argType = typeOf(argNode);
+				if (argType == ValueType::Auto || argType == ValueType::AutoFun)
+    argType = ValueType::Integer;
+                if (argType == ValueType::Integer || argType == ValueType::Boolean) {
                     this->textSection += "    call print_number\n";
-                } else if (argType == "String") {
+                    m_runtime.use(RuntimeItem::PrintNumber);
+                } else if (argType == ValueType::String) {
                     this->textSection += "    call print_string\n";
-                } else if (argType == "List") {
+                    m_runtime.use(RuntimeItem::PrintString);
+                } else if (argType == ValueType::List) {
                     this->textSection += "    call print_not_string\n"; 
+                    m_runtime.use(RuntimeItem::PrintList);
                 } else {
-                    m_errorManager.addError({"Unhandled type for print: ", argType, "CodeGeneration", std::stoi(node->line)});
+                    m_errorManager.addError({"Unhandled type for print: ", valueTypeName(argType), "CodeGeneration", node->line});
                     this->textSection += "    call print_number ; Fallback: prints RAX as number\n";
+                    m_runtime.use(RuntimeItem::PrintNumber);
                 }
 
                 if (i < node->children.size() - 1) {
+                    m_runtime.use(RuntimeItem::Space);
                     textSection += "    mov rax, 1\n";
                     textSection += "    mov rdi, 1\n";
                     textSection += "    mov rsi, space\n"; 
@@ -241,19 +459,33 @@ void CodeGenerator::visitNode(const std::shared_ptr<ASTNode>& node) {
             }
         }
         // Print newline after all arguments
+        m_runtime.use(RuntimeItem::Newline);
         this->textSection += "    mov rax, 1\n";
         this->textSection += "    mov rdi, 1\n";
         this->textSection += "    mov rsi, newline\n"; 
         this->textSection += "    mov rdx, 1\n";
         this->textSection += "    syscall\n";
 
-    } else if (node->type == "Compare") {
+    } else if (node->kind == NodeKind::Compare) {
         visitNode(node->children[0]); 
         textSection += "    push rax\n";  
         visitNode(node->children[1]); 
         textSection += "    mov rbx, rax\n";
         textSection += "    pop rax\n";
         
+        // String equality compares contents. Two literals are interned, so their pointers already
+        // tell; otherwise str_equals tries the pointer compare first, then the bytes.
+        bool stringEquality = (node->value == "==" || node->value == "!=")
+                              && typeOf(node->children[0]) == ValueType::String
+                              && typeOf(node->children[1]) == ValueType::String;
+        bool literalOperands = node->children[0]->kind == NodeKind::String && node->children[1]->kind == NodeKind::String;
+        if (stringEquality && !literalOperands) {
+            textSection += "    mov rdi, rax\n";
+            textSection += "    mov rsi, rbx\n";
+            textSection += "    call str_equals\n";
+            textSection += "    mov rbx, 1      ; rax == 1 <=> equal contents\n";
+            m_runtime.use(RuntimeItem::StrEquals);
+        }
         textSection += "    cmp rax, rbx\n";
         
         if (node->value == "==") textSection += "    sete al\n";  
@@ -263,13 +495,13 @@ void CodeGenerator::visitNode(const std::shared_ptr<ASTNode>& node) {
         else if (node->value == "<=") textSection += "    setle al\n"; 
         else if (node->value == ">=") textSection += "    setge al\n"; 
         else {
-            m_errorManager.addError({"Unknown comparison operator: ", node->value, "CodeGeneration", std::stoi(node->line)});
+            m_errorManager.addError({"Unknown comparison operator: ", std::string(node->value), "CodeGeneration", node->line});
             textSection += "    mov al, 0 ; Error case\n";
         }
         textSection += "    movzx rax, al\n";
-    } else if (node->type == "ArithOp") { // Handles + and -
+    } else if (node->kind == NodeKind::ArithOp) { // Handles + and -
         if (node->children.size() < 2) {
-             m_errorManager.addError({"ArithOp requires two children", node->value, "CodeGeneration", std::stoi(node->line)});
+             m_errorManager.addError({"ArithOp requires two children", std::string(node->value), "CodeGeneration", node->line});
              return;
         }
         visitNode(node->children[0]); // Left operand in rax
@@ -278,49 +510,51 @@ void CodeGenerator::visitNode(const std::shared_ptr<ASTNode>& node) {
         textSection += "    mov rbx, rax\n";   // Right operand in rbx
         textSection += "    pop rax\n";      // Left operand in rax
 
-        std::string typeL = getExpressionType(node->children[0]);
-        std::string typeR = getExpressionType(node->children[1]);
+        ValueType typeL = typeOf(node->children[0]);
+        ValueType typeR = typeOf(node->children[1]);
 
 		
 
         if (node->value == "+") {
             if (typeL != typeR) {
-                m_errorManager.addError({"Type mismatch for '+': ", typeL + ", " + typeR, "CodeGeneration", std::stoi(node->line)});
+                m_errorManager.addError({"Type mismatch for '+': ", std::string(valueTypeName(typeL)) + ", " + valueTypeName(typeR), "CodeGeneration", node->line});
                 textSection += "    mov rax, 0 ; Error for + op\n";
                 return;
             }
-			if (typeL == "auto")  typeL = "Integer";
-if (typeR == "auto")  typeR = "Integer";
-            if (typeL == "List" || typeR == "List") { 
+			if (typeL == ValueType::Auto)  typeL = ValueType::Integer;
+if (typeR == ValueType::Auto)  typeR = ValueType::Integer;
+            if (typeL == ValueType::List || typeR == ValueType::List) { 
 
                  textSection += "    mov rdi, rax\n";
                  textSection += "    mov rsi, rbx\n";
                  textSection += "    call list_concat\n"; 
-            } else if (typeL == "String" || typeR == "String") {
+                 m_runtime.use(RuntimeItem::ListConcat);
+            } else if (typeL == ValueType::String || typeR == ValueType::String) {
 
                  textSection += "    mov rdi, rax\n";
                  textSection += "    mov rsi, rbx\n";
                  textSection += "    call str_concat\n"; // rax will contain result address
-            } else if (typeL == "Integer" && typeR == "Integer") {
+                 m_runtime.use(RuntimeItem::StrConcat);
+            } else if (typeL == ValueType::Integer && typeR == ValueType::Integer) {
                 textSection += "    add rax, rbx\n";
             } else {
-                 m_errorManager.addError({"Type mismatch or unsupported types for '+': ", typeL + ", " + typeR, "CodeGeneration", std::stoi(node->line)});
+                 m_errorManager.addError({"Type mismatch or unsupported types for '+': ", std::string(valueTypeName(typeL)) + ", " + valueTypeName(typeR), "CodeGeneration", node->line});
                  textSection += "    mov rax, 0 ; Error for + op\n";
             }
         } else if (node->value == "-") {
     auto left  = node->children[0];
     auto right = node->children[1];
 
-    std::string tL = getExpressionType(left);
-    std::string tR = getExpressionType(right);
+    ValueType tL = typeOf(left);
+    ValueType tR = typeOf(right);
 
     // auto ➜ Integer upgrade
-    if (tL == "auto") tL = "Integer";
-    if (tR == "auto") tR = "Integer";
+    if (tL == ValueType::Auto) tL = ValueType::Integer;
+    if (tR == ValueType::Auto) tR = ValueType::Integer;
 
     if (!isNumeric(tL) || !isNumeric(tR)) {
-        m_errorManager.addError({"Type mismatch for '-': ", tL + ", " + tR,
-                                 "CodeGeneration", std::stoi(node->line)});
+        m_errorManager.addError({"Type mismatch for '-': ", std::string(valueTypeName(tL)) + ", " + valueTypeName(tR),
+                                 "CodeGeneration", node->line});
         textSection += "    mov rax, 0\n";
     } else {
         visitNode(left);              // → rax
@@ -331,11 +565,11 @@ if (typeR == "auto")  typeR = "Integer";
         textSection += "    sub rax, rbx\n";
     }
 } else {
-            m_errorManager.addError({"Unknown ArithOp: ", node->value, "CodeGeneration", std::stoi(node->line)});
+            m_errorManager.addError({"Unknown ArithOp: ", std::string(node->value), "CodeGeneration", node->line});
         }
-    } else if (node->type == "TermOp") { // Handles *, //, /, %
+    } else if (node->kind == NodeKind::TermOp) { // Handles *, //, /, %
         if (node->children.size() < 2) {
-             m_errorManager.addError({"TermOp requires two children", node->value, "CodeGeneration", std::stoi(node->line)});
+             m_errorManager.addError({"TermOp requires two children", std::string(node->value), "CodeGeneration", node->line});
              return;
         }
         visitNode(node->children[0]);
@@ -344,14 +578,14 @@ if (typeR == "auto")  typeR = "Integer";
         textSection += "    mov rbx, rax\n"; // Denominator/second operand
         textSection += "    pop rax\n";      // Numerator/first operand
 
-        std::string typeL = getExpressionType(node->children[0]);
-        std::string typeR = getExpressionType(node->children[1]);
+        ValueType typeL = typeOf(node->children[0]);
+        ValueType typeR = typeOf(node->children[1]);
 
-		if (typeL == "auto") typeL = "Integer";
-if (typeR == "auto") typeR = "Integer";
+		if (typeL == ValueType::Auto) typeL = ValueType::Integer;
+if (typeR == ValueType::Auto) typeR = ValueType::Integer;
 
-        if (typeL != "Integer" || typeR != "Integer") {
-            m_errorManager.addError({"TermOp requires Integer operands. Got: ", typeL + ", " + typeR, "CodeGeneration", std::stoi(node->line)});
+        if (typeL != ValueType::Integer || typeR != ValueType::Integer) {
+            m_errorManager.addError({"TermOp requires Integer operands. Got: ", std::string(valueTypeName(typeL)) + ", " + valueTypeName(typeR), "CodeGeneration", node->line});
             textSection += "    mov rax, 0 ; Error for TermOp\n";
             return;
         }
@@ -359,20 +593,22 @@ if (typeR == "auto") typeR = "Integer";
         if (node->value == "*") {
             textSection += "    imul rax, rbx\n";
         } else if (node->value == "/" || node->value == "//") { // Integer division
+            m_runtime.use(RuntimeItem::DivisionByZero);
             textSection += "    cmp rbx, 0\n";
             textSection += "    je division_by_zero_error\n";
             textSection += "    cqo ; Sign-extend rax into rdx:rax for idiv\n";
             textSection += "    idiv rbx\n"; // Quotient in rax, remainder in rdx
         } else if (node->value == "%") {
+            m_runtime.use(RuntimeItem::DivisionByZero);
             textSection += "    cmp rbx, 0\n";
             textSection += "    je division_by_zero_error\n";
             textSection += "    cqo\n";
             textSection += "    idiv rbx\n";
             textSection += "    mov rax, rdx\n"; // Remainder is the result
         } else {
-            m_errorManager.addError({"Unknown TermOp: ", node->value, "CodeGeneration", std::stoi(node->line)});
+            m_errorManager.addError({"Unknown TermOp: ", std::string(node->value), "CodeGeneration", node->line});
         }
-    } else if (node->type == "And") {
+    } else if (node->kind == NodeKind::And) {
         std::string falseLbl = newLabel("and_false_or_rhs");
         std::string endLbl = newLabel("and_end");
         visitNode(node->children[0]); // Eval left
@@ -388,7 +624,7 @@ if (typeR == "auto") typeR = "Integer";
         // Result is the left value, which is on top of stack
         textSection += "    pop rax ; Left value (which was false-equivalent) is the result\n";
         textSection += endLbl + ":\n";
-    } else if (node->type == "Or") {
+    } else if (node->kind == NodeKind::Or) {
         std::string trueLbl = newLabel("or_true_skip_rhs");
         std::string endLbl = newLabel("or_end");
         visitNode(node->children[0]); // Eval left
@@ -404,33 +640,33 @@ if (typeR == "auto") typeR = "Integer";
         // Result is the left value, which is on top of stack
         textSection += "    pop rax ; Left value (which was true-equivalent) is the result\n";
         textSection += endLbl + ":\n";
-    } else if (node->type == "Not") {
+    } else if (node->kind == NodeKind::Not) {
         visitNode(node->children[0]);
         toBool("rax");
         textSection += "    xor rax, 1\n"; // Invert boolean value (0 to 1, 1 to 0)
-    } else if (node->type == "UnaryOp" && node->value == "-") {
+    } else if (node->kind == NodeKind::UnaryOp && node->value == "-") {
          if (node->children.empty()) {
-            m_errorManager.addError({"Unary '-' has no operand.", "", "CodeGeneration", std::stoi(node->line)});
+            m_errorManager.addError({"Unary '-' has no operand.", "", "CodeGeneration", node->line});
             return;
          }
          visitNode(node->children[0]);
-         std::string operandType = getExpressionType(node->children[0]);
-         if (operandType == "Integer") {
+         ValueType operandType = typeOf(node->children[0]);
+         if (operandType == ValueType::Integer) {
             textSection += "    neg rax\n";
          } else {
-            m_errorManager.addError({"Unary '-' expects Integer operand, got: ", operandType, "CodeGeneration", std::stoi(node->line)});
+            m_errorManager.addError({"Unary '-' expects Integer operand, got: ", valueTypeName(operandType), "CodeGeneration", node->line});
             textSection += "    mov rax, 0 ; Error for unary -\n";
          }
     }
     // For Program, Definitions, Instructions, FunctionBody, FormalParameterList, ActualParameterList etc.
-    else if (node->type == "Program" || node->type == "Definitions" || node->type == "Instructions" ||
-             node->type == "FunctionBody" || node->type == "FormalParameterList" ||
-             node->type == "ActualParameterList" || node->type == "ParameterList" || // ParameterList is used by parser for func calls
-             node->type == "IfBody" || node->type == "ElseBody" || node->type == "ForBody" || node->type == "WhileBody" ) {
+    else if (node->kind == NodeKind::Program || node->kind == NodeKind::Definitions || node->kind == NodeKind::Instructions ||
+             node->kind == NodeKind::FunctionBody || node->kind == NodeKind::FormalParameterList ||
+             node->kind == NodeKind::ParameterList || // ParameterList is used by parser for func calls
+             node->kind == NodeKind::IfBody || node->kind == NodeKind::ElseBody || node->kind == NodeKind::ForBody || node->kind == NodeKind::WhileBody ) {
         for (auto &child : node->children) {
             visitNode(child);
         }
-    }else if (node->type == "ListCall") {           // read  L[i]  -> rax
+    }else if (node->kind == NodeKind::ListCall) {           // read  L[i]  -> rax
     auto listId  = node->children[0];          // Identifier
     auto indexNd = node->children[1];          // expression for i
 
@@ -439,7 +675,7 @@ if (typeR == "auto") typeR = "Integer";
     textSection += "    push rax        ; save index\n";
 
     // load list base address in rbx
-    textSection += "    mov rbx, " + getIdentifierMemoryOperand(listId->value) + "\n";
+    textSection += "    mov rbx, " + getIdentifierMemoryOperand(std::string(listId->value)) + "\n";
     textSection += "    pop  rcx        ; rcx = index\n";
 
     std::string bad = newLabel("index_error_read");
@@ -456,6 +692,7 @@ if (typeR == "auto") typeR = "Integer";
     textSection += "    mov rax, [rbx]  ; <- element value\n";
     textSection += "    jmp " + ok + "\n";
 
+    m_runtime.use(RuntimeItem::IndexErrorMessage);
     textSection += bad + ":\n";
     textSection += "    mov rax, 1\n";
     textSection += "    mov rdi, 1\n";
@@ -469,7 +706,7 @@ if (typeR == "auto") typeR = "Integer";
     textSection += ok + ":\n";
 }
      else {
-        m_errorManager.addError({"Unrecognized or unhandled ASTNode type in visitNode: ", node->type, "CodeGeneration", std::stoi(node->line)});
+        m_errorManager.addError({"Unrecognized or unhandled ASTNode type in visitNode: ", nodeKindName(node->kind), "CodeGeneration", node->line});
         
         for (auto &child : node->children) {
             visitNode(child);
@@ -483,446 +720,36 @@ void CodeGenerator::endAssembly() {
     textSection += "xor rdi, rdi     ; exit code 0\n";
     textSection += "syscall\n\n";
 
-    // --- Division by Zero Error Handler ---
-    textSection += "\n; Division by zero error handler\n";
-    textSection += "division_by_zero_error:\n";
-    textSection += "    ; Print error message\n";
-    textSection += "    mov rax, 1          ; syscall: write\n";
-    textSection += "    mov rdi, 1          ; file descriptor: stdout\n";
-    textSection += "    mov rsi, div_zero_msg\n";
-    textSection += "    mov rdx, div_zero_len\n";
-    textSection += "    syscall\n";
-    textSection += "    ; Exit with error code\n";
-    textSection += "    mov rax, 60         ; syscall: exit\n";
-    textSection += "    mov rdi, 1          ; exit code 1 (error)\n";
-    textSection += "    syscall\n\n";
-
-    // --- Print Number Function ---
-    textSection += "; Function to print a number in RAX\n";
-    textSection += "print_number:\n";
-    textSection += "    push rbp\n";
-    textSection += "    mov rbp, rsp\n";
-    textSection += "    push rbx          ; Preserve callee-saved rbx\n";
-    textSection += "    push r12          ; Preserve callee-saved r12\n";
-    textSection += "    mov r12, rax      ; save original number in r12 (after r12 is saved)\n";
-
-    // Handle negative numbers
-    textSection += "    cmp r12, 0\n";
-    textSection += "    jge .print_positive\n";
-    textSection += "    ; Handle negative number\n";
-    textSection += "    push rax          ; Syscalls clobber rax, rdi, rsi, rdx. r12 is safe here.\n";
-    textSection += "    push rdi\n";
-    textSection += "    push rsi\n";
-    textSection += "    push rdx\n";
-    textSection += "    mov rax, 1\n";
-    textSection += "    mov rdi, 1\n";
-    textSection += "    mov rsi, minus_sign\n";
-    textSection += "    mov rdx, 1\n";
-    textSection += "    syscall\n";
-    textSection += "    pop rdx\n";
-    textSection += "    pop rsi\n";
-    textSection += "    pop rdi\n";
-    textSection += "    pop rax\n";
-    textSection += "    neg r12           ; Make the number positive. r12 was preserved.\n";
-
-    textSection += ".print_positive:\n";
-    textSection += "    lea rdi, [buffer+31]  ; point rdi to end of buffer\n";
-    textSection += "    mov byte [rdi], 0     ; null-terminate the buffer\n";
-    textSection += "    cmp r12, 0\n";
-    textSection += "    jne .print_convert\n";
-    textSection += "    mov byte [rdi-1], '0'\n";
-    textSection += "    lea rdi, [rdi-1]\n";
-    textSection += "    jmp .print_output\n";
-     
-    textSection += ".print_convert:\n";
-    textSection += "    mov rax, r12          ; Use r12 (which holds the number) for conversion\n";
-    textSection += "    mov rbx, 10           ; Divisor (rbx was saved)\n";
-    textSection += ".print_convert_loop:\n";
-    textSection += "    xor rdx, rdx\n";
-    textSection += "    div rbx             ; rax = quotient, rdx = remainder\n";
-    textSection += "    add rdx, '0'        ; convert digit to ASCII\n";
-    textSection += "    dec rdi             ; move pointer left\n";
-    textSection += "    mov [rdi], dl       ; store digit in buffer\n";
-    textSection += "    cmp rax, 0\n";
-    textSection += "    jne .print_convert_loop\n";
-    
-    textSection += ".print_output:\n";
-    textSection += "    lea rsi, [rdi]      ; rsi points to start of the string\n";
-    textSection += "    mov rdx, buffer+31\n";
-    textSection += "    sub rdx, rdi        ; compute string length\n";
-    textSection += "    mov rax, 1          ; syscall: write\n";
-    textSection += "    mov rdi, 1          ; file descriptor: stdout\n";
-    textSection += "    syscall             ; rax, rdi, rsi, rdx might be clobbered\n";
-
-    textSection += "    pop r12           ; Restore callee-saved r12\n";
-    textSection += "    pop rbx           ; Restore callee-saved rbx\n";
-    textSection += "    pop rbp\n";
-    textSection += "    ret\n\n";
-    
-
-    // Dans la fonction endAssembly(), remplacer la partie list_concat
-    textSection += "\n; Function to concatenate two lists\n";
-    textSection += "list_concat:\n";
-    textSection += "    push rbp\n";
-    textSection += "    mov rbp, rsp\n";
-    textSection += "    push r12\n";
-    textSection += "    push r13\n";
-    textSection += "    push r14\n";
-    textSection += "    push rbx\n";
-    textSection += "    push r15\n";
-        
-    // Sauvegarder les listes d'entrée
-    textSection += "    mov r12, rdi        ; r12 = liste1\n";
-    textSection += "    mov r13, rsi        ; r13 = liste2\n";
-        
-    // Lire les tailles des deux listes
-    textSection += "    mov r14, [r12]      ; r14 = taille de liste1\n";
-    textSection += "    mov r15, [r13]      ; r15 = taille de liste2\n";
-        
-    // Obtenir un nouvel emplacement pour la liste résultat
-    textSection += "    mov rbx, [list_offset]\n";
-    textSection += "    mov rax, list_buffer\n";
-    textSection += "    add rax, rbx        ; rax = adresse de la nouvelle liste\n";
-    textSection += "    push rax            ; sauvegarder l'adresse de la nouvelle liste\n";
-        
-    // Calculer et stocker la taille totale
-    textSection += "    mov rcx, [list_offset]\n";
-    textSection += "    mov rax, r14\n";
-    textSection += "    add rax, r15\n";
-    textSection += "    mov [list_buffer + rcx], rax  ; stocker la taille totale\n";
-    textSection += "    add rcx, 8\n";
-    textSection += "    mov [list_offset], rcx\n";
-        
-    // Copier les éléments de la première liste (sauter la taille)
-    textSection += "    mov rsi, r12\n";
-    textSection += "    add rsi, 8          ; sauter la taille de liste1\n";
-    textSection += "    mov rbx, rcx        ; offset de destination\n";
-    textSection += "    mov rcx, r14        ; nombre d'éléments à copier\n";
-    textSection += "    cmp rcx, 0\n";
-    textSection += "    je .list_copy1_done\n";
-        
-    textSection += ".list_copy1_loop:\n";
-    textSection += "    mov rdx, [rsi]      ; charger élément de liste1\n";
-    textSection += "    mov [list_buffer + rbx], rdx  ; copier l'élément\n";
-    textSection += "    add rsi, 8          ; avancer dans liste1\n";
-    textSection += "    add rbx, 8          ; avancer dans nouvelle liste\n";
-    textSection += "    dec rcx\n";
-    textSection += "    jnz .list_copy1_loop\n";
-    textSection += ".list_copy1_done:\n";
-        
-    // Copier les éléments de la deuxième liste (sauter la taille)
-    textSection += "    mov rsi, r13\n";
-    textSection += "    add rsi, 8          ; sauter la taille de liste2\n";
-    textSection += "    mov rcx, r15        ; nombre d'éléments à copier\n";
-    textSection += "    cmp rcx, 0\n";
-    textSection += "    je .list_copy2_done\n";
-        
-    textSection += ".list_copy2_loop:\n";
-    textSection += "    mov rdx, [rsi]      ; charger élément de liste2\n";
-    textSection += "    mov [list_buffer + rbx], rdx  ; copier l'élément\n";
-    textSection += "    add rsi, 8          ; avancer dans liste2\n";
-    textSection += "    add rbx, 8          ; avancer dans nouvelle liste\n";
-    textSection += "    dec rcx\n";
-    textSection += "    jnz .list_copy2_loop\n";
-    textSection += ".list_copy2_done:\n";
-        
-    // Mettre à jour list_offset
-    textSection += "    mov [list_offset], rbx\n";
-        
-    // Retourner l'adresse de la nouvelle liste
-    textSection += "    pop rax             ; récupérer l'adresse de la liste résultat\n";
-        
-    // Nettoyage
-    textSection += "    pop r15\n";
-    textSection += "    pop rbx\n";
-    textSection += "    pop r14\n";
-    textSection += "    pop r13\n";
-    textSection += "    pop r12\n";
-    textSection += "    pop rbp\n";
-    textSection += "    ret\n\n";
-
-    textSection += "; Function to concatenate two strings with offset\n";
-    textSection += "str_concat:\n";
-    textSection += "    push rbp\n";
-    textSection += "    mov rbp, rsp\n";
-    textSection += "    push r12\n";
-    textSection += "    push r13\n";
-    textSection += "    push r14\n";
-    textSection += "    push rbx\n";
-
-    textSection += "    ; Save input strings\n";
-    textSection += "    mov r12, rdi        ; r12 = str1\n";
-    textSection += "    mov r13, rsi        ; r13 = str2\n";
-
-    textSection += "    mov r14, concat_buffer\n";
-    textSection += "    mov rbx, 0\n";
-    // textSection += "    mov rbx, [concat_offset]\n";
-    // textSection += "    add r14, rbx        ; r14 = destination address (buffer + offset)\n";
-
-    // Label ID pour éviter les conflits
-    static int concatId = 0;
-    std::string id = std::to_string(concatId++);
-
-    // Sauvegarder le pointeur de début de concaténation à retourner
-    textSection += "    mov rax, r14\n";
-
-    // --- Copier str1 ---
-    textSection += "    mov rsi, r12\n";
-    textSection += ".copy_str1_" + id + ":\n";
-    textSection += "    mov al, [rsi]\n";
-    textSection += "    cmp al, 0\n";
-    textSection += "    je .done_str1_" + id + "\n";
-    textSection += "    mov [r14], al\n";
-    textSection += "    inc rsi\n";
-    textSection += "    inc r14\n";
-    textSection += "    jmp .copy_str1_" + id + "\n";
-    textSection += ".done_str1_" + id + ":\n";
-
-    // --- Copier str2 ---
-    textSection += "    mov rsi, r13\n";
-    textSection += ".copy_str2_" + id + ":\n";
-    textSection += "    mov al, [rsi]\n";
-    textSection += "    cmp al, 0\n";
-    textSection += "    je .done_str2_" + id + "\n";
-    textSection += "    mov [r14], al\n";
-    textSection += "    inc rsi\n";
-    textSection += "    inc r14\n";
-    textSection += "    jmp .copy_str2_" + id + "\n";
-    textSection += ".done_str2_" + id + ":\n";
-
-    // Ajout du null terminator
-    textSection += "    mov byte [r14], 0\n";
-    textSection += "    inc r14\n";
-
-    // Mettre à jour concat_offset = r14 - concat_buffer
-    textSection += "    mov rbx, r14\n";
-    textSection += "    sub rbx, concat_buffer\n";
-    textSection += "    mov [concat_offset], rbx\n";
-
-    // Nettoyage
-    textSection += "    pop rbx\n";
-    textSection += "    pop r14\n";
-    textSection += "    pop r13\n";
-    textSection += "    pop r12\n";
-    textSection += "    pop rbp\n";
-    textSection += "    ret\n\n";
-
-    // Routine pour les chaînes
-    textSection += "print_string:\n";
-    textSection += "    push rbp\n";
-    textSection += "    mov rbp, rsp\n";
-    textSection += "    mov rsi, rax\n";
-    textSection += "    mov rdx, 0\n";
-    textSection += ".print_strlen_loop:\n";
-    textSection += "    cmp byte [rsi+rdx], 0\n";
-    textSection += "    je .print_strlen_done\n";
-    textSection += "    inc rdx\n";
-    textSection += "    jmp .print_strlen_loop\n";
-    textSection += ".print_strlen_done:\n";
-    textSection += "    mov rax, 1\n";
-    textSection += "    mov rdi, 1\n";
-    textSection += "    syscall\n";
-    textSection += "    pop rbp\n";
-    textSection += "    ret\n\n";
-
-    // Dans la fonction endAssembly(), remplacer la partie list_range
-    textSection += "; Function to create a range list (0...n-1)\n";
-    textSection += "list_range:\n";
-    textSection += "    push rbp\n";
-    textSection += "    mov rbp, rsp\n";
-    textSection += "    push rbx\n";
-    textSection += "    push r12\n";
-    textSection += "    push r13\n";
-            
-    textSection += "    ; rax = n (size of the range)\n";
-    textSection += "    mov r12, rax        ; r12 = n\n";
-            
-    textSection += "    ; Get new list address\n";
-    textSection += "    mov rbx, [list_offset]\n";
-    textSection += "    mov rax, list_buffer\n";
-    textSection += "    add rax, rbx        ; rax = address of the new list\n";
-    textSection += "    push rax            ; save list address\n";
-            
-    textSection += "    ; Store the size first\n";
-    textSection += "    mov rcx, [list_offset]\n";
-    textSection += "    mov [list_buffer + rcx], r12\n";
-    textSection += "    add rcx, 8\n";
-    textSection += "    mov [list_offset], rcx\n";
-            
-    textSection += "    ; Initialize counter\n";
-    textSection += "    xor r13, r13        ; r13 = 0 (counter)\n";
-    textSection += "    cmp r12, 0\n";
-    textSection += "    je .list_range_done\n";
-            
-    textSection += ".list_range_loop:\n";
-    textSection += "    ; Add counter value to list\n";
-    textSection += "    mov rcx, [list_offset]\n";
-    textSection += "    mov [list_buffer + rcx], r13\n";
-    textSection += "    add rcx, 8\n";
-    textSection += "    mov [list_offset], rcx\n";
-            
-    textSection += "    ; Increment counter\n";
-    textSection += "    inc r13\n";
-            
-    textSection += "    ; Check if counter < n\n";
-    textSection += "    cmp r13, r12\n";
-    textSection += "    jl .list_range_loop\n";
-            
-    textSection += ".list_range_done:\n";
-    textSection += "    ; Return list address\n";
-    textSection += "    pop rax\n";
-            
-    textSection += "    ; Cleanup\n";
-    textSection += "    pop r13\n";
-    textSection += "    pop r12\n";
-    textSection += "    pop rbx\n";
-    textSection += "    pop rbp\n";
-    textSection += "    ret\n\n";
-
-        // --- revised print_not_string ----------------------------------------
-
-    textSection += "; Function to print a list (elements separated by space, enclosed in brackets)\n";
-    textSection += "print_not_string:          ; RAX = address of list\n";
-    textSection += "    push rbp\n";
-    textSection += "    mov  rbp, rsp\n";
-    textSection += "    push rbx\n";
-    textSection += "    push r12            ; will be our loop-counter\n";
-    textSection += "    push rdx\n";
-    textSection += "    push rsi\n";
-    textSection += "    push rdi\n";
-    textSection += "    push r8\n";
-    textSection += "    push r9\n";
-
-    textSection += "    mov  rbx, rax          ; rbx = base address of the list structure\n";
-    textSection += "    mov  r12, [rbx]        ; r12 = size of the list\n";
-    textSection += "    add  rbx, 8            ; rbx -> first element\n";
-
-    // print '['
-    textSection += "    mov  rax, 1\n";
-    textSection += "    mov  rdi, 1\n";
-    textSection += "    mov  rsi, open_bracket\n";
-    textSection += "    mov  rdx, 1\n";
-    textSection += "    syscall\n";
-
-    textSection += ".print_list_loop:\n";
-    textSection += "    cmp  r12, 0\n";
-    textSection += "    je   .print_list_done\n";
-
-    textSection += "    mov  r8, [rbx]         ; element -> r8\n";
-    textSection += "    ; Check if element is a likely pointer (above certain address threshold)\n";
-    textSection += "    cmp  r8, 0x1000        ; Addresses below this are likely integers\n";
-    textSection += "    jb   .print_as_number\n";
-
-    textSection += "    mov  rax, r8\n";
-    textSection += "    ; Try to read the first byte safely\n";
-    textSection += "    push rcx\n";
-    textSection += "    mov  rcx, r8\n";
-    textSection += "    shr  rcx, 48           ; Get top 16 bits - if non-zero, likely invalid addr\n";
-    textSection += "    cmp  rcx, 0\n";
-    textSection += "    jne  .not_a_string\n";
-    textSection += "    pop  rcx\n";
-
-    textSection += "    ; Now test if this might be a string (has ASCII characters and null-terminator)\n";
-    textSection += "    push rcx\n";
-    textSection += "    xor  rcx, rcx\n";
-    textSection += ".check_string_loop:\n";
-    textSection += "    cmp  rcx, 20           ; Limite max: 20 caractères à vérifier\n";
-    textSection += "    jge  .not_a_string\n";
-    textSection += "    mov  r9b, byte [rax+rcx]\n";
-    textSection += "    cmp  r9b, 0            ; Fin de la chaîne?\n";
-    textSection += "    je   .print_as_string\n";
-    textSection += "    cmp  r9b, 32\n";
-    textSection += "    jl   .not_a_string\n";
-    textSection += "    cmp  r9b, 126\n";
-    textSection += "    jg   .not_a_string\n";
-    textSection += "    inc  rcx\n";
-    textSection += "    jmp  .check_string_loop\n";
-
-    textSection += ".not_a_string:\n";
-    textSection += "    pop  rcx\n";
-    textSection += "    jmp  .print_as_number\n";
-
-    textSection += ".print_as_string:\n";
-    textSection += "    pop  rcx\n";
-    textSection += "    mov  rax, r8\n";
-    textSection += "    call print_string\n";
-    textSection += "    jmp  .after_element_print\n";
-
-    textSection += ".print_as_number:\n";
-    textSection += "    mov  rax, r8\n";
-    textSection += "    call print_number\n";
-
-    textSection += ".after_element_print:\n";
-    textSection += "    add  rbx, 8\n";
-    textSection += "    dec  r12\n";
-    textSection += "    cmp  r12, 0\n";
-    textSection += "    je   .print_list_done\n";
-
-    // print ", "
-    textSection += "    mov  rax, 1\n";
-    textSection += "    mov  rdi, 1\n";
-    textSection += "    mov  rsi, comma_space\n";
-    textSection += "    mov  rdx, 2\n";
-    textSection += "    syscall\n";
-    textSection += "    jmp  .print_list_loop\n";
-
-    textSection += ".print_list_done:\n";
-    // print ']'
-    textSection += "    mov  rax, 1\n";
-    textSection += "    mov  rdi, 1\n";
-    textSection += "    mov  rsi, close_bracket\n";
-    textSection += "    mov  rdx, 1\n";
-    textSection += "    syscall\n";
-
-    textSection += "    pop  r9\n";
-    textSection += "    pop  r8\n";
-    textSection += "    pop  rdi\n";
-    textSection += "    pop  rsi\n";
-    textSection += "    pop  rdx\n";
-    textSection += "    pop  r12\n";
-    textSection += "    pop  rbx\n";
-    textSection += "    pop  rbp\n";
-    textSection += "    ret\n";
-
-    bool aliasExists = textSection.find("print_list:\n    jmp print_not_string") != std::string::npos;
-    if (!aliasExists) { 
-        textSection += "\n; legacy alias – keep older code paths working\n";
-        textSection += "print_list:\n";
-        textSection += "    jmp print_not_string\n\n";
-    }
-}
-
-void CodeGenerator::writeToFile(const std::string &filename) {
-    std::ofstream outFile(filename);
-    if (!outFile) {
-        throw std::runtime_error("Failed to open output file: " + filename);
-    }
-    outFile << asmCode;
-    outFile.close();
+    // Runtime helpers and data referenced by the units, with their dependencies
+    this->dataSection.clear();
+    this->bssSection.clear();
+    emitRuntime(m_runtime, m_runtimeLinkage, textSection, dataSection, bssSection);
 }
 
 void CodeGenerator::genPrint(const std::string& type) {
     if (type == "String") {
         textSection += "call print_string\n";
+        m_runtime.use(RuntimeItem::PrintString);
     }
     else {
         textSection += "call print_not_string\n";
+        m_runtime.use(RuntimeItem::PrintList);
     }
 }    
 
-void CodeGenerator::genAffect(const std::shared_ptr<ASTNode>& node) {
+void CodeGenerator::genAffect(ASTNode* node) {
     if (node->children.size() < 2) {
         throw std::runtime_error("Invalid ASTNode structure for assignment on line " + node->line);
     }
     
-    std::string varName = node->children[0]->value; 
+    std::string varName(node->children[0]->value); 
     auto leftNode = node->children[0];
     auto rightValueNode = node->children[1];
 
     visitNode(rightValueNode);
 
-    if (leftNode->type == "ListCall") {
-        std::string listName = leftNode->children[0]->value;
+    if (leftNode->kind == NodeKind::ListCall) {
+        std::string listName(leftNode->children[0]->value);
         auto indexNode = leftNode->children[1];
         textSection += "; List element assignment for " + listName + "\n";
         textSection += "    mov rbx, " + getIdentifierMemoryOperand(listName) + "\n"; // Base address of list in rbx
@@ -950,6 +777,7 @@ void CodeGenerator::genAffect(const std::shared_ptr<ASTNode>& node) {
         textSection += "    mov qword [rbx], rax\n";
         textSection += "    jmp " + endLabel + "\n";
         
+        m_runtime.use(RuntimeItem::IndexErrorMessage);
         textSection += errorLabel + ":\n";
         textSection += "    mov rax, 1\n";
         textSection += "    mov rdi, 1\n";
@@ -966,26 +794,11 @@ void CodeGenerator::genAffect(const std::shared_ptr<ASTNode>& node) {
     
 
     textSection += "    mov " + getIdentifierMemoryOperand(varName) + ", rax\n";
-
-    std::string valueType = getExpressionType(rightValueNode);
-	
-    if (valueType != "auto" && valueType != "autoFun") {
-        updateSymbolType(varName, valueType);
-    } else if (rightValueNode->type == "Integer") {
-        updateSymbolType(varName, "Integer");
-    } else if (rightValueNode->type == "String") {
-        updateSymbolType(varName, "String");
-    } else if (rightValueNode->type == "List") {
-        updateSymbolType(varName, "List");
-    } else if (rightValueNode->type == "True" || rightValueNode->type == "False") {
-        updateSymbolType(varName, "Boolean");
-    }
-
 }
 
-void CodeGenerator::genFor(const std::shared_ptr<ASTNode>& node) {
+void CodeGenerator::genFor(ASTNode* node) {
     if (node->children.size() < 3) {
-        m_errorManager.addError({"Invalid For ASTNode structure: requires variable, iterable, and body.", "", "CodeGeneration", std::stoi(node->line)});
+        m_errorManager.addError({"Invalid For ASTNode structure: requires variable, iterable, and body.", "", "CodeGeneration", node->line});
         return;
     }
 
@@ -993,34 +806,41 @@ void CodeGenerator::genFor(const std::shared_ptr<ASTNode>& node) {
     auto iterableNode = node->children[1];
     auto bodyNode = node->children[2];
 
-    if (loopVarNode->type != "Identifier") {
-        m_errorManager.addError({"For loop variable must be an Identifier.", "", "CodeGeneration", std::stoi(loopVarNode->line)});
+    if (loopVarNode->kind != NodeKind::Identifier) {
+        m_errorManager.addError({"For loop variable must be an Identifier.", "", "CodeGeneration", loopVarNode->line});
         return;
     }
-    auto typeIter = getExpressionType(iterableNode);
-    if (typeIter == "String" || typeIter == "Integer") {
-        m_errorManager.addError({"For loop iterable must be a list or a range.", "", "CodeGeneration", std::stoi(iterableNode->line)});
+    ValueType typeIter = typeOf(iterableNode);
+    if (typeIter == ValueType::String || typeIter == ValueType::Integer) {
+        m_errorManager.addError({"For loop iterable must be a list or a range.", "", "CodeGeneration", iterableNode->line});
     }
-    std::string loopVarName = loopVarNode->value;
+    std::string loopVarName(loopVarNode->value);
     std::string loopVarMem = getIdentifierMemoryOperand(loopVarName);
 
-    auto type = getExpressionType(iterableNode);
-    if (iterableNode->type == "FunctionCall" && 
+    if (iterableNode->kind == NodeKind::FunctionCall && 
         !iterableNode->children.empty() &&
-        iterableNode->children[0]->type == "Identifier" &&
+        iterableNode->children[0]->kind == NodeKind::Identifier &&
         iterableNode->children[0]->value == "range") {
 
-        if (iterableNode->children.size() < 2 || iterableNode->children[1]->type != "ParameterList" || iterableNode->children[1]->children.empty()) {
-            m_errorManager.addError({"Invalid 'range' call in for loop: ParameterList expected.", "", "CodeGeneration", std::stoi(iterableNode->line)});
+        if (iterableNode->children.size() < 2 || iterableNode->children[1]->kind != NodeKind::ParameterList || iterableNode->children[1]->children.empty()) {
+            m_errorManager.addError({"Invalid 'range' call in for loop: ParameterList expected.", "", "CodeGeneration", iterableNode->line});
             return;
         }
         
         auto paramListNode = iterableNode->children[1];
         if (paramListNode->children.size() != 1) {
-            m_errorManager.addError({"range() in for loop expects exactly one argument.", "", "CodeGeneration", std::stoi(paramListNode->line)});
+            m_errorManager.addError({"range() in for loop expects exactly one argument.", "", "CodeGeneration", paramListNode->line});
             return;
         }
         auto rangeArgNode = paramListNode->children[0];
+        if (rangeArgNode && rangeArgNode->kind == NodeKind::Integer && genUnrolledRange(loopVarNode, rangeArgNode, bodyNode)) return;
+        // Boucle vectorisée ; un calcul élément par élément garde la boucle générique en repli
+        std::string vectorDone;
+        VectorLoop vectorLoop;
+        if (m_vectorize && matchVectorLoop(node, vectorLoop)) {
+            vectorDone = genVectorLoop(node, vectorLoop);
+            if (vectorDone.empty()) return;
+        }
 
         std::string startLabel = newLabel("for_start");
         std::string endLabel = newLabel("for_end");
@@ -1054,74 +874,534 @@ void CodeGenerator::genFor(const std::shared_ptr<ASTNode>& node) {
 
         textSection += endLabel + ":\n";
         textSection += "    add rsp, 8        ; Pop range limit N from stack\n";
+        if (!vectorDone.empty()) textSection += vectorDone + ":\n";
 
     } 
     else{
+        VectorLoop vectorLoop;
+        if (m_vectorize && matchVectorLoop(node, vectorLoop)) {
+            genVectorLoop(node, vectorLoop);
+            return;
+        }
         std::string startLabel = newLabel("for_list_start");
         std::string endLabel = newLabel("for_list_end");
         
         visitNode(iterableNode);
         
+        // Variable d'induction : un pointeur sur l'élément courant avance de 8 jusqu'au pointeur
+        // de fin. La taille d'une liste ne change pas, les éléments sont relus à chaque tour.
         textSection += "    ; Itération sur liste\n";
-        textSection += "    push rax          ; Sauvegarder l'adresse de la liste\n";
-        textSection += "    mov rbx, rax      ; rbx = adresse de la liste\n";
-        textSection += "    xor rcx, rcx      ; rcx = 0 (compteur d'itération)\n";
-        
-        textSection += startLabel + ":\n";
-        textSection += "    mov rbx, [rsp]    ; rbx = adresse de la liste (depuis la pile)\n";
-        textSection += "    mov rdx, [rbx]    ; rdx = taille de la liste\n";
-        textSection += "    cmp rcx, rdx      ; comparer compteur avec taille\n";
-        textSection += "    jge " + endLabel + "    ; si compteur >= taille, sortir\n";
-        
-        textSection += "    ; Récupérer l'élément courant\n";
-        textSection += "    lea r8, [rbx + 8]   ; r8 = adresse du premier élément\n";
-        textSection += "    mov r9, rcx        ; r9 = index courant\n";
-        textSection += "    imul r9, 8         ; r9 = décalage en octets (index * 8)\n";
-        textSection += "    mov rax, [r8 + r9] ; rax = liste[rcx] (élément courant)\n";
-        textSection += "    mov " + loopVarMem + ", rax ; assigner à la variable de boucle\n";
-        
-        textSection += "    push rcx           ; Sauvegarder le compteur d'itération\n";
-        
-        textSection += "    ; Corps de la boucle for\n";
-        visitNode(bodyNode);
-        
-        textSection += "    pop rcx            ; Restaurer le compteur\n";
-        
-        textSection += "    inc rcx            ; Incrémenter l'index\n";
-        textSection += "    jmp " + startLabel + "\n";
-        
-        textSection += endLabel + ":\n";
-        textSection += "    add rsp, 8        ; Libérer l'adresse de la liste\n";
+        textSection += "    mov rdx, [rax]    ; rdx = taille de la liste\n";
+        if (m_listLoopDepth < 2) {
+            std::string pointer = m_listLoopDepth == 0 ? "r12" : "r14";
+            std::string last = m_listLoopDepth == 0 ? "r13" : "r15";
+            textSection += "    lea " + pointer + ", [rax + 8]   ; " + pointer + " = adresse du premier élément\n";
+            textSection += "    lea " + last + ", [rax + 8 + rdx * 8] ; " + last + " = fin de la liste\n";
+
+            textSection += startLabel + ":\n";
+            textSection += "    cmp " + pointer + ", " + last + "\n";
+            textSection += "    jae " + endLabel + "    ; si pointeur >= fin, sortir\n";
+            textSection += "    mov rax, [" + pointer + "] ; rax = élément courant\n";
+            textSection += "    mov " + loopVarMem + ", rax ; assigner à la variable de boucle\n";
+
+            textSection += "    ; Corps de la boucle for\n";
+            ++m_listLoopDepth;
+            visitNode(bodyNode);
+            --m_listLoopDepth;
+
+            textSection += "    add " + pointer + ", 8        ; élément suivant\n";
+            textSection += "    jmp " + startLabel + "\n";
+            textSection += endLabel + ":\n";
+        } else {
+            // Plus de registres libres : pointeur et fin restent sur la pile
+            textSection += "    lea rbx, [rax + 8 + rdx * 8]\n";
+            textSection += "    push rbx          ; [rsp + 8] = fin de la liste\n";
+            textSection += "    lea rbx, [rax + 8]\n";
+            textSection += "    push rbx          ; [rsp] = adresse de l'élément courant\n";
+
+            textSection += startLabel + ":\n";
+            textSection += "    mov rbx, [rsp]\n";
+            textSection += "    cmp rbx, [rsp + 8]\n";
+            textSection += "    jae " + endLabel + "    ; si pointeur >= fin, sortir\n";
+            textSection += "    mov rax, [rbx]     ; rax = élément courant\n";
+            textSection += "    mov " + loopVarMem + ", rax ; assigner à la variable de boucle\n";
+
+            textSection += "    ; Corps de la boucle for\n";
+            visitNode(bodyNode);
+
+            textSection += "    add qword [rsp], 8 ; élément suivant\n";
+            textSection += "    jmp " + startLabel + "\n";
+            textSection += endLabel + ":\n";
+            textSection += "    add rsp, 16       ; Libérer pointeur et fin\n";
+        }
     }
     
 }
 
-void CodeGenerator::genIf(const std::shared_ptr<ASTNode>& node) {
-    std::string ifId = std::to_string(this->ifLabelCounter++);
-    std::string elseLabel = ".else_" + ifId;
-    std::string endLabel = ".endif_" + ifId;
-    
+/* for i in range(K), K littéral : le corps est recopié, i prenant ses valeurs par des mov immédiats.
+ * Si les K copies tiennent dans m_unroll.maxSize noeuds, la boucle disparaît ; sinon chaque tour
+ * enchaîne m_unroll.factor copies, et les K % factor dernières suivent la boucle. Le corps ne doit
+ * pas affecter i (qui sert de compteur au for générique) ni produire d'erreur, qui serait signalée
+ * une fois par copie. Faux si la boucle reste à générer normalement. */
+bool CodeGenerator::genUnrolledRange(ASTNode* loopVarNode, ASTNode* limitNode, ASTNode* bodyNode) {
+    if (m_unroll.maxSize == 0 || !bodyNode) return false;
+    long long count = 0;
+    const char* first = limitNode->value.data();
+    const char* last = first + limitNode->value.size();
+    auto [end, status] = std::from_chars(first, last, count);
+    if (status != std::errc() || end != last || count > std::numeric_limits<std::int32_t>::max()) return false;
+    if (assigns(bodyNode, loopVarNode->nameId)) return false;
+
+    std::size_t size = std::max<std::size_t>(nodeCount(bodyNode), 1);
+    std::size_t trips = static_cast<std::size_t>(count);
+    std::size_t factor = m_unroll.factor;
+    bool full = trips <= m_unroll.maxSize / size;
+    bool partial = !full && factor >= 2 && trips >= factor && factor <= m_unroll.maxSize / size;
+    if (!full && !partial) return false;
+    if (!generatesCleanly(bodyNode)) return false;
+
+    std::string loopVarName(loopVarNode->value);
+    std::string loopVarMem = getIdentifierMemoryOperand(loopVarName);
+    if (full) {
+        textSection += "    ; for " + loopVarName + " in range(" + std::to_string(count) + ") déroulée\n";
+        for (std::size_t i = 0; i < trips; ++i) {
+            textSection += "    mov qword " + loopVarMem + ", " + std::to_string(i) + "\n";
+            visitNode(bodyNode);
+        }
+        textSection += "    mov qword " + loopVarMem + ", " + std::to_string(trips) + "\n";
+        return true;
+    }
 
-    textSection += "; If condition\n";
-    auto condNode = node->children[0];
-    std::string condType = getExpressionType(condNode);
-    
-    visitNode(condNode); // rax <- valeur
-    
+    std::string startLabel = newLabel("for_unrolled");
+    std::size_t remainder = trips % factor;
+    textSection += "    ; for " + loopVarName + " in range(" + std::to_string(count) + ") déroulée par " + std::to_string(factor) + "\n";
+    textSection += "    mov qword " + loopVarMem + ", 0\n";
+    textSection += startLabel + ":\n";
+    for (std::size_t copy = 0; copy < factor; ++copy) {
+        visitNode(bodyNode);
+        textSection += "    add qword " + loopVarMem + ", 1\n";
+    }
+    textSection += "    cmp qword " + loopVarMem + ", " + std::to_string(trips - remainder) + "\n";
+    textSection += "    jl " + startLabel + "\n";
+    for (std::size_t copy = 0; copy < remainder; ++copy) {
+        textSection += "    ; reste du déroulage\n";
+        visitNode(bodyNode);
+        textSection += "    add qword " + loopVarMem + ", 1\n";
+    }
+    return true;
+}
+
+// Génère node dans un générateur jetable, pour savoir s'il produit une erreur
+bool CodeGenerator::generatesCleanly(ASTNode* node) const {
+    ErrorManager errors;
+    CodeGenerator scratch(errors);
+    scratch.symbolTable = symbolTable;
+    scratch.currentSymbolTable = currentSymbolTable;
+    scratch.currentFunction = currentFunction;
+    scratch.m_stringLabels = m_stringLabels;
+    scratch.m_listLoopDepth = m_listLoopDepth;
+    scratch.m_unroll = m_unroll;
+    scratch.m_vectorize = m_vectorize;
+    scratch.m_branchless = m_branchless;
+    try {
+        scratch.visitNode(node);
+    } catch (...) {
+        return false;
+    }
+    return !errors.hasErrors();
+}
+
+/* Boucles dont le corps est une seule instruction, sur les éléments x d'une liste (for x in L) ou
+ * sur L[i] (for i in range(len(L))) :
+ *   s = s + x                       somme
+ *   if x <op> c: s = s + 1          comptage (c littéral ou variable non modifiée)
+ *   if x < s: s = x (ou >)          minimum (maximum)
+ *   M[i] = A[i] +/- B[i] (ou c)     calcul élément par élément, range(len(L)) seulement
+ * Les opérations doivent être celles, entières, que génère visitNode. */
+bool CodeGenerator::matchVectorLoop(const ASTNode* node, VectorLoop& loop) const {
+    ASTNode* var = node->children[0];
+    ASTNode* iterable = node->children[1];
+    ASTNode* body = node->children[2];
+    if (!var || !iterable || !body || body->children.size() != 1 || !body->children[0]) return false;
+    if (iterable->kind == NodeKind::FunctionCall && !iterable->children.empty() && iterable->children[0]
+        && iterable->children[0]->value == "range") {
+        // range(len(L)) : i parcourt exactement les indices de L, sans erreur d'indice possible
+        ASTNode* params = iterable->children.size() > 1 ? iterable->children[1] : nullptr;
+        ASTNode* limit = params && params->children.size() == 1 ? params->children[0] : nullptr;
+        if (!limit || limit->kind != NodeKind::FunctionCall || limit->children.size() != 2 || !limit->children[0]
+            || limit->children[0]->value != "len" || !limit->children[1] || limit->children[1]->children.size() != 1) {
+            return false;
+        }
+        ASTNode* list = limit->children[1]->children[0];
+        if (!list || list->kind != NodeKind::Identifier || typeOf(list) != ValueType::List) return false;
+        loop.list = list;
+    } else if (typeOf(iterable) != ValueType::List) {
+        return false;
+    }
+
+    auto isElement = [&](const ASTNode* e) {
+        if (loop.list) return isIndexed(e, var) && sameVariable(e->children[0], loop.list);
+        return sameVariable(e, var) && isIntegral(e);
+    };
+    // Valeur que le corps ne change pas : littéral, ou variable autre que i et que celle affectée
+    auto isScalar = [&](const ASTNode* e, const ASTNode* written) {
+        if (!isIntegral(e)) return false;
+        if (e->kind == NodeKind::Integer) return true;
+        return e->kind == NodeKind::Identifier && !sameVariable(e, var) && !sameVariable(e, written);
+    };
+    auto isAccumulator = [&](const ASTNode* e) {
+        return e && e->kind == NodeKind::Identifier && isIntegral(e) && !sameVariable(e, var);
+    };
+
+    ASTNode* statement = body->children[0];
+    if (statement->kind == NodeKind::Affect && statement->children.size() == 2 && statement->children[1]) {
+        ASTNode* target = statement->children[0];
+        ASTNode* value = statement->children[1];
+        if (isAccumulator(target) && isIntegerAdd(value)) {
+            ASTNode* a = value->children[0];
+            ASTNode* b = value->children[1];
+            if (!(sameVariable(a, target) && isElement(b)) && !(isElement(a) && sameVariable(b, target))) return false;
+            loop.kind = VectorLoop::Kind::Sum;
+            loop.accumulator = target;
+            return true;
+        }
+        if (!loop.list || !target || target->kind != NodeKind::ListCall || target->children.size() != 2
+            || !target->children[0] || target->children[0]->kind != NodeKind::Identifier
+            || typeOf(target->children[0]) != ValueType::List || !sameVariable(target->children[1], var)) {
+            return false;
+        }
+        if (value->kind != NodeKind::ArithOp || value->children.size() != 2 || (value->value != "+" && value->value != "-")) return false;
+        if (value->value == "+" && !isIntegerAdd(value)) return false;
+        ASTNode* a = value->children[0];
+        ASTNode* b = value->children[1];
+        if (!isIntegral(a) || !isIntegral(b)) return false;
+        bool indexedA = isIndexed(a, var);
+        bool indexedB = isIndexed(b, var);
+        if ((!indexedA && !indexedB) || (!indexedA && !isScalar(a, nullptr)) || (!indexedB && !isScalar(b, nullptr))) return false;
+        loop.kind = VectorLoop::Kind::Map;
+        loop.target = target->children[0];
+        loop.left = a;
+        loop.right = b;
+        loop.op = value->value;
+        return true;
+    }
+
+    // if sans else (le parseur peut laisser un else vide)
+    if (statement->kind != NodeKind::If || statement->children.size() < 2) return false;
+    if (statement->children.size() > 3 || (statement->children.size() == 3 && statement->children[2])) return false;
+    ASTNode* condition = statement->children[0];
+    ASTNode* then = statement->children[1];
+    if (!condition || condition->kind != NodeKind::Compare || condition->children.size() != 2 || !then
+        || then->children.size() != 1 || !then->children[0]) {
+        return false;
+    }
+    ASTNode* assign = then->children[0];
+    if (assign->kind != NodeKind::Affect || assign->children.size() != 2 || !isAccumulator(assign->children[0])) return false;
+    ASTNode* accumulator = assign->children[0];
+    ASTNode* value = assign->children[1];
+    ASTNode* a = condition->children[0];
+    ASTNode* b = condition->children[1];
+    loop.accumulator = accumulator;
+
+    if (isIntegerAdd(value) && sameVariable(value->children[0], accumulator) && value->children[1]->kind == NodeKind::Integer
+        && value->children[1]->value == "1") {
+        if (isElement(a) && isScalar(b, accumulator)) {
+            loop.compare = condition->value;
+            loop.operand = b;
+        } else if (isScalar(a, accumulator) && isElement(b)) {
+            loop.compare = flipped(condition->value);
+            loop.operand = a;
+        } else {
+            return false;
+        }
+        loop.kind = VectorLoop::Kind::Count;
+        return true;
+    }
+    if (!isElement(value)) return false;
+    if (isElement(a) && sameVariable(b, accumulator)) {
+        loop.compare = condition->value;
+    } else if (sameVariable(a, accumulator) && isElement(b)) {
+        loop.compare = flipped(condition->value);
+    } else {
+        return false;
+    }
+    if (loop.compare == "<" || loop.compare == "<=") loop.kind = VectorLoop::Kind::Min;
+    else if (loop.compare == ">" || loop.compare == ">=") loop.kind = VectorLoop::Kind::Max;
+    else return false;
+    return true;
+}
+
+/* Code d'une boucle reconnue par matchVectorLoop. rsi pointe sur les éléments, rdx en donne le
+ * nombre, r8 est l'indice. Somme et comptage d'égalités avancent par vecteurs SSE2 de deux entiers,
+ * suivis des éléments restants un par un ; les comparaisons d'ordre sur 64 bits n'existant pas en
+ * SSE2, comptage ordonné, minimum et maximum bouclent sur les éléments sans test d'indice (setcc,
+ * cmov). La variable de boucle reçoit la valeur qu'elle aurait en sortie de la boucle générique.
+ * Pour M[i] = A[i] +/- B[i], les listes plus courtes que L renvoient à la boucle générique, qui
+ * s'arrête sur l'erreur d'indice au même élément : le label à placer après elle est renvoyé. */
+std::string CodeGenerator::genVectorLoop(ASTNode* node, const VectorLoop& loop) {
+    std::string loopVarMem = getIdentifierMemoryOperand(std::string(node->children[0]->value));
+    std::string vectorLabel = newLabel("vector_loop");
+    std::string vectorEnd = newLabel("vector_end");
+    std::string tailLabel = newLabel("vector_tail");
+    std::string doneLabel = newLabel("vector_done");
+    auto memory = [this](const ASTNode* variable) { return getIdentifierMemoryOperand(std::string(variable->value)); };
+
+    // Liste parcourue dans rax, puis l'opérande scalaire dans rbx (sans effet : l'ordre est libre)
+    textSection += "    ; Boucle vectorisée\n";
+    if (loop.list) textSection += "    mov rax, " + memory(loop.list) + "\n";
+    else visitNode(node->children[1]);
+    ASTNode* scalar = loop.operand;
+    if (loop.kind == VectorLoop::Kind::Map) scalar = isIndexed(loop.left, node->children[0]) ? loop.right : loop.left;
+    if (scalar && !isIndexed(scalar, node->children[0])) {
+        textSection += "    push rax\n";
+        visitNode(scalar);
+        textSection += "    mov rbx, rax\n";
+        textSection += "    pop rax\n";
+    }
+    textSection += "    mov rdx, [rax]    ; rdx = nombre d'éléments\n";
+    textSection += "    lea rsi, [rax + 8]\n";
+    textSection += "    xor r8, r8\n";
+
+    switch (loop.kind) {
+    case VectorLoop::Kind::Sum:
+        textSection += "    pxor xmm0, xmm0\n";
+        textSection += "    pxor xmm1, xmm1\n";
+        textSection += "    mov rcx, rdx\n";
+        textSection += "    and rcx, -4       ; éléments traités par paquets de 4\n";
+        textSection += vectorLabel + ":\n";
+        textSection += "    cmp r8, rcx\n";
+        textSection += "    jae " + vectorEnd + "\n";
+        textSection += "    movdqu xmm2, [rsi + r8 * 8]\n";
+        textSection += "    movdqu xmm3, [rsi + r8 * 8 + 16]\n";
+        textSection += "    paddq xmm0, xmm2\n";
+        textSection += "    paddq xmm1, xmm3\n";
+        textSection += "    add r8, 4\n";
+        textSection += "    jmp " + vectorLabel + "\n";
+        textSection += vectorEnd + ":\n";
+        textSection += "    paddq xmm0, xmm1\n";
+        textSection += "    pshufd xmm1, xmm0, 0xEE\n";
+        textSection += "    paddq xmm0, xmm1\n";
+        textSection += "    movq rax, xmm0\n";
+        textSection += tailLabel + ":\n";
+        textSection += "    cmp r8, rdx\n";
+        textSection += "    jae " + doneLabel + "\n";
+        textSection += "    add rax, [rsi + r8 * 8]\n";
+        textSection += "    inc r8\n";
+        textSection += "    jmp " + tailLabel + "\n";
+        textSection += doneLabel + ":\n";
+        textSection += "    add " + memory(loop.accumulator) + ", rax\n";
+        break;
+    case VectorLoop::Kind::Count:
+        if (loop.compare == "==" || loop.compare == "!=") {
+            // Égalité sur 64 bits : les deux moitiés 32 bits égales ; chaque égalité retranche -1
+            textSection += "    movq xmm4, rbx\n";
+            textSection += "    punpcklqdq xmm4, xmm4\n";
+            textSection += "    pxor xmm0, xmm0\n";
+            textSection += "    mov rcx, rdx\n";
+            textSection += "    and rcx, -2\n";
+            textSection += vectorLabel + ":\n";
+            textSection += "    cmp r8, rcx\n";
+            textSection += "    jae " + vectorEnd + "\n";
+            textSection += "    movdqu xmm2, [rsi + r8 * 8]\n";
+            textSection += "    pcmpeqd xmm2, xmm4\n";
+            textSection += "    pshufd xmm3, xmm2, 0xB1\n";
+            textSection += "    pand xmm2, xmm3\n";
+            textSection += "    psubq xmm0, xmm2\n";
+            textSection += "    add r8, 2\n";
+            textSection += "    jmp " + vectorLabel + "\n";
+            textSection += vectorEnd + ":\n";
+            textSection += "    pshufd xmm1, xmm0, 0xEE\n";
+            textSection += "    paddq xmm0, xmm1\n";
+            textSection += "    movq rax, xmm0\n";
+        } else {
+            textSection += "    xor rax, rax\n";
+        }
+        textSection += tailLabel + ":\n";
+        textSection += "    cmp r8, rdx\n";
+        textSection += "    jae " + doneLabel + "\n";
+        textSection += "    cmp qword [rsi + r8 * 8], rbx\n";
+        textSection += "    set" + conditionCode(loop.compare == "!=" ? "==" : loop.compare) + " r9b\n";
+        textSection += "    movzx r9, r9b\n";
+        textSection += "    add rax, r9\n";
+        textSection += "    inc r8\n";
+        textSection += "    jmp " + tailLabel + "\n";
+        textSection += doneLabel + ":\n";
+        if (loop.compare == "!=") {
+            textSection += "    neg rax\n";
+            textSection += "    add rax, rdx      ; différents = total - égaux\n";
+        }
+        textSection += "    add " + memory(loop.accumulator) + ", rax\n";
+        break;
+    case VectorLoop::Kind::Min: case VectorLoop::Kind::Max:
+        textSection += "    mov rax, " + memory(loop.accumulator) + "\n";
+        textSection += tailLabel + ":\n";
+        textSection += "    cmp r8, rdx\n";
+        textSection += "    jae " + doneLabel + "\n";
+        textSection += "    mov r9, [rsi + r8 * 8]\n";
+        textSection += "    cmp r9, rax\n";
+        textSection += "    cmov" + conditionCode(loop.compare) + " rax, r9\n";
+        textSection += "    inc r8\n";
+        textSection += "    jmp " + tailLabel + "\n";
+        textSection += doneLabel + ":\n";
+        textSection += "    mov " + memory(loop.accumulator) + ", rax\n";
+        break;
+    case VectorLoop::Kind::Map: {
+        std::string fallback = newLabel("vector_fallback");
+        std::string end = newLabel("vector_map_end");
+        const ASTNode* var = node->children[0];
+        bool indexedLeft = isIndexed(loop.left, var);
+        bool indexedRight = isIndexed(loop.right, var);
+        // Toutes les listes doivent avoir au moins len(L) éléments
+        std::vector<const ASTNode*> lists{loop.target};
+        if (indexedLeft) lists.push_back(loop.left->children[0]);
+        if (indexedRight) lists.push_back(loop.right->children[0]);
+        for (const ASTNode* list : lists) {
+            textSection += "    mov rax, " + memory(list) + "\n";
+            textSection += "    cmp qword [rax], rdx\n";
+            textSection += "    jl " + fallback + "\n";
+        }
+        textSection += "    mov rdi, " + memory(loop.target) + "\n";
+        textSection += "    add rdi, 8\n";
+        if (indexedLeft) {
+            textSection += "    mov rsi, " + memory(loop.left->children[0]) + "\n";
+            textSection += "    add rsi, 8\n";
+        }
+        if (indexedRight) {
+            textSection += "    mov r10, " + memory(loop.right->children[0]) + "\n";
+            textSection += "    add r10, 8\n";
+        }
+        if (!indexedLeft || !indexedRight) {
+            textSection += "    movq xmm4, rbx\n";
+            textSection += "    punpcklqdq xmm4, xmm4\n";
+        }
+        std::string vectorOp = loop.op == "+" ? "paddq" : "psubq";
+        std::string scalarOp = loop.op == "+" ? "add" : "sub";
+        textSection += "    mov rcx, rdx\n";
+        textSection += "    and rcx, -2\n";
+        textSection += vectorLabel + ":\n";
+        textSection += "    cmp r8, rcx\n";
+        textSection += "    jae " + tailLabel + "\n";
+        textSection += indexedLeft ? "    movdqu xmm0, [rsi + r8 * 8]\n" : "    movdqa xmm0, xmm4\n";
+        textSection += indexedRight ? "    movdqu xmm1, [r10 + r8 * 8]\n" : "    movdqa xmm1, xmm4\n";
+        textSection += "    " + vectorOp + " xmm0, xmm1\n";
+        textSection += "    movdqu [rdi + r8 * 8], xmm0\n";
+        textSection += "    add r8, 2\n";
+        textSection += "    jmp " + vectorLabel + "\n";
+        textSection += tailLabel + ":\n";
+        textSection += "    cmp r8, rdx\n";
+        textSection += "    jae " + doneLabel + "\n";
+        textSection += indexedLeft ? "    mov rax, [rsi + r8 * 8]\n" : "    mov rax, rbx\n";
+        textSection += indexedRight ? "    mov r9, [r10 + r8 * 8]\n" : "    mov r9, rbx\n";
+        textSection += "    " + scalarOp + " rax, r9\n";
+        textSection += "    mov [rdi + r8 * 8], rax\n";
+        textSection += "    inc r8\n";
+        textSection += "    jmp " + tailLabel + "\n";
+        textSection += doneLabel + ":\n";
+        textSection += "    mov " + loopVarMem + ", rdx\n";
+        textSection += "    jmp " + end + "\n";
+        textSection += fallback + ":\n";
+        return end;
+    }
+    }
+
+    // Valeur de la variable de boucle après la boucle générique
+    if (loop.list) {
+        textSection += "    mov " + loopVarMem + ", rdx\n";
+    } else {
+        std::string empty = newLabel("vector_empty");
+        textSection += "    test rdx, rdx\n";
+        textSection += "    jz " + empty + "\n";
+        textSection += "    mov rax, [rsi + rdx * 8 - 8] ; dernier élément\n";
+        textSection += "    mov " + loopVarMem + ", rax\n";
+        textSection += empty + ":\n";
+    }
+    return {};
+}
+
+/* rax <- 0 / 1 selon la véracité de la valeur de type type qu'il contient */
+void CodeGenerator::genTruthValue(ValueType type) {
     // L = [] ou L = "" ou L = 0 => false
-    if (condType == "List") {
+    if (type == ValueType::List) {
         textSection += "    ; Check if list is empty\n";
         textSection += "    cmp qword [rax], 0    ; Check size at first qword\n";
         textSection += "    setnz al              ; al = 1 if list is not empty (size > 0)\n";
         textSection += "    movzx rax, al         ; rax = 0/1\n";
-    } else if (condType == "String") {
+    } else if (type == ValueType::String) {
         textSection += "    ; Check if string is empty\n";
         textSection += "    cmp byte [rax], 0     ; Check if first byte is null\n";
         textSection += "    setnz al              ; al = 1 if string is not empty\n";
         textSection += "    movzx rax, al         ; rax = 0/1\n";
     } else {
         toBool("rax");            // rax <- 0 / 1
-    }   
+    }
+}
+
+/* if c: v = a / else: v = b (sans else, b est v) : a et b ne pouvant ni échouer ni avoir d'effet,
+ * les deux sont calculés puis la condition choisit par cmov, sans saut à mal prédire. La condition
+ * s'évalue en dernier pour garder ses flags ; une comparaison d'entiers se fond dans le cmov. */
+bool CodeGenerator::genBranchlessIf(ASTNode* node) {
+    if (node->children.size() < 2 || !node->children[0]) return false;
+    const ASTNode* thenAffect = singleAffect(node->children[1]);
+    if (!thenAffect) return false;
+    ASTNode* target = thenAffect->children[0];
+    ASTNode* thenValue = thenAffect->children[1];
+    ASTNode* elseValue = nullptr;
+    if (node->children.size() > 2 && node->children[2]) {
+        const ASTNode* elseAffect = singleAffect(node->children[2]);
+        if (!elseAffect || !sameVariable(elseAffect->children[0], target)) return false;
+        elseValue = elseAffect->children[1];
+        if (!isSpeculable(elseValue) || nodeCount(elseValue) > kMaxSpeculatedSize) return false;
+    }
+    if (!isSpeculable(thenValue) || nodeCount(thenValue) > kMaxSpeculatedSize) return false;
+
+    ASTNode* condNode = node->children[0];
+    std::string targetMem = getIdentifierMemoryOperand(std::string(target->value));
+    textSection += "; If/else sans saut : " + std::string(target->value) + "\n";
+    visitNode(thenValue);
+    textSection += "    push rax\n";
+    if (elseValue) {
+        visitNode(elseValue);
+    } else {
+        textSection += "    mov rax, " + targetMem + "\n";
+    }
+    textSection += "    push rax\n";
+
+    std::string code = "nz";
+    if (condNode->kind == NodeKind::Compare && condNode->children.size() == 2 && isIntegral(condNode->children[0])
+        && isIntegral(condNode->children[1])) {
+        visitNode(condNode->children[0]);
+        textSection += "    push rax\n";
+        visitNode(condNode->children[1]);
+        textSection += "    mov rbx, rax\n";
+        textSection += "    pop rax\n";
+        textSection += "    cmp rax, rbx\n";
+        code = conditionCode(condNode->value);
+    } else {
+        visitNode(condNode);
+        genTruthValue(typeOf(condNode));
+        textSection += "    test rax, rax\n";
+    }
+    textSection += "    pop rax              ; valeur si faux\n";
+    textSection += "    pop rcx              ; valeur si vrai\n";
+    textSection += "    cmov" + code + " rax, rcx\n";
+    textSection += "    mov " + targetMem + ", rax\n";
+    return true;
+}
+
+void CodeGenerator::genIf(ASTNode* node) {
+    if (m_branchless && genBranchlessIf(node)) return;
+    std::string ifId = std::to_string(this->ifLabelCounter++);
+    std::string elseLabel = ".else_" + ifId;
+    std::string endLabel = ".endif_" + ifId;
+    
+
+    textSection += "; If condition\n";
+    auto condNode = node->children[0];
+    ValueType condType = typeOf(condNode);
+    
+    visitNode(condNode); // rax <- valeur
+    
+    genTruthValue(condType);
     
 
     textSection += "cmp rax, 0\n";
@@ -1152,7 +1432,7 @@ void CodeGenerator::genIf(const std::shared_ptr<ASTNode>& node) {
     textSection += endLabel + ":\n";
 }
 
-void CodeGenerator::genWhile(const std::shared_ptr<ASTNode>& node) {
+void CodeGenerator::genWhile(ASTNode* node) {
     std::string whileId = std::to_string(this->ifLabelCounter++);
     std::string startLabel = ".while_" + whileId;
     std::string endLabel   = ".endwhile_" + whileId;
@@ -1161,24 +1441,11 @@ void CodeGenerator::genWhile(const std::shared_ptr<ASTNode>& node) {
     textSection += "; While condition\n";
 
     auto condNode = node->children[0];
-    std::string condType = getExpressionType(condNode);
+    ValueType condType = typeOf(condNode);
 
     visitNode(condNode); // rax <- valeur
 
-    // L = [] ou L = "" ou L = 0 => false
-    if (condType == "List") {
-        textSection += "    ; Check if list is empty\n";
-        textSection += "    cmp qword [rax], 0    ; Check size at first qword\n";
-        textSection += "    setnz al              ; al = 1 if list is not empty (size > 0)\n";
-        textSection += "    movzx rax, al         ; rax = 0/1\n";
-    } else if (condType == "String") {
-        textSection += "    ; Check if string is empty\n";
-        textSection += "    cmp byte [rax], 0     ; Check if first byte is null\n";
-        textSection += "    setnz al              ; al = 1 if string is not empty\n";
-        textSection += "    movzx rax, al         ; rax = 0/1\n";
-    } else {
-        toBool("rax");            // rax <- 0 / 1
-    }   
+    genTruthValue(condType);
 
     textSection += "    cmp rax, 0\n";
     textSection += "    je " + endLabel + "\n";
@@ -1191,17 +1458,16 @@ void CodeGenerator::genWhile(const std::shared_ptr<ASTNode>& node) {
 }
 
 
-void CodeGenerator::genFunction(const std::shared_ptr<ASTNode>& node) {
-    std::string funcName = node->value;
-    FunctionSymbol* funcSym = nullptr;
-	currentFuncSym = funcSym;
+void CodeGenerator::genFunction(ASTNode* node) {
+    std::string funcName(node->value);
+    const FunctionSymbol* funcSym = nullptr;
     if (symbolTable) { 
-        Symbol* sym = symbolTable->findImmediateSymbol(funcName);
-        funcSym = dynamic_cast<FunctionSymbol*>(sym);
+        const Symbol* sym = symbolTable->findImmediateSymbol(funcName);
+        funcSym = symbolAs<FunctionSymbol>(sym);
     }
 
     if (!funcSym) {
-        m_errorManager.addError({"Function symbol not found for: ", funcName, "CodeGeneration", std::stoi(node->line)});
+        m_errorManager.addError({"Function symbol not found for: ", funcName, "CodeGeneration", node->line});
         
         textSection += "\n" + funcName + ":\n";
         textSection += "    ; ERROR: Function symbol not found\n";
@@ -1227,13 +1493,13 @@ void CodeGenerator::genFunction(const std::shared_ptr<ASTNode>& node) {
 
     //check if function has no double parameters
     auto args = node->children[0];
-    if (args && args->type == "FormalParameterList") {
+    if (args && args->kind == NodeKind::FormalParameterList) {
         std::unordered_set<std::string> paramSet;
         for (const auto& param : args->children) {
-            if (paramSet.find(param->value) != paramSet.end()) {
-                m_errorManager.addError({"Duplicate parameter: ", param->value, "CodeGeneration", std::stoi(param->line)});
+            if (paramSet.find(std::string(param->value)) != paramSet.end()) {
+                m_errorManager.addError({"Duplicate parameter: ", std::string(param->value), "CodeGeneration", param->line});
             }
-            paramSet.insert(param->value);
+            paramSet.insert(std::string(param->value));
         }
     }
     // Generate function body
@@ -1241,14 +1507,16 @@ void CodeGenerator::genFunction(const std::shared_ptr<ASTNode>& node) {
     // Locals are accessed via [rbp - offset]
     
 
-    if (node->children.size() > 1 && node->children[1] && node->children[1]->type == "FunctionBody") {
+    if (node->children.size() > 1 && node->children[1] && node->children[1]->kind == NodeKind::FunctionBody) {
          visitNode(node->children[1]);
-    } else if (node->children.size() > 0 && node->children[0]->type != "FormalParameterList" && node->children[0]) {
+    } else if (node->children.size() > 0 && node->children[0]->kind != NodeKind::FormalParameterList && node->children[0]) {
        
         visitNode(node->children[0]);
     }
 
     textSection += ".return_" + funcName + ":\n"; 
+    // A return inside a for loop leaves the loop's stack slots above the saved registers
+    textSection += "    lea rsp, [rbp - " + std::to_string(funcSym->frameSize + 40) + "] ; Saved registers\n";
     textSection += "    pop r15\n";
     textSection += "    pop r14\n";
     textSection += "    pop r13\n";
@@ -1259,79 +1527,100 @@ void CodeGenerator::genFunction(const std::shared_ptr<ASTNode>& node) {
     textSection += "    ret\n";
 }
 
-void CodeGenerator::genList(const std::shared_ptr<ASTNode>& node) {
-    int listSize = node->children.size();
-
-    textSection += "mov rbx, [list_offset]\n";
-    textSection += "mov rax, list_buffer\n";
-    textSection += "add rax, rbx\n";  
-    textSection += "push rax\n";     
+// Opérande "dq" d'un élément constant de liste littérale, vide si l'élément doit être évalué
+std::string CodeGenerator::constantElement(const ASTNode* element) const {
+    if (!element) return {};
+    switch (element->kind) {
+    case NodeKind::Integer: return std::string(element->value);
+    case NodeKind::True: return "1";
+    case NodeKind::False: return "0";
+    case NodeKind::String: return m_stringLabels->at(element->value);
+    case NodeKind::UnaryOp:
+        if (element->value == "-" && element->children.size() == 1 && element->children[0]
+            && element->children[0]->kind == NodeKind::Integer) {
+            return "-" + std::string(element->children[0]->value);
+        }
+        return {};
+    default: return {};
+    }
+}
 
-    
-    
-    if ((listSize == 1) && node->children[0] == nullptr) {
-        textSection += "mov rcx, [list_offset]\n";
-        textSection += "mov qword [list_buffer + rcx], 0\n";  
-        textSection += "add rcx, 8\n";
-        textSection += "mov [list_offset], rcx\n";
-    } 
-    else {
+void CodeGenerator::genList(ASTNode* node) {
+    m_runtime.use(RuntimeItem::ListHeap);
+    bool empty = node->children.size() == 1 && node->children[0] == nullptr;
+    std::size_t listSize = empty ? 0 : node->children.size();
+    std::string blockSize = std::to_string((listSize + 1) * 8);
+
+    // Liste de constantes : image construite une fois en .data, recopiée d'un bloc à chaque évaluation
+    std::string image = std::to_string(listSize);
+    for (std::size_t i = 0; i < listSize && !image.empty(); ++i) {
+        std::string element = constantElement(node->children[i]);
+        image = element.empty() ? std::string() : image + ", " + element;
+    }
+    if (listSize > 0 && !image.empty()) {
+        // Label hors des identificateurs MiniPython, comme ceux des chaînes
+        auto [it, inserted] = m_listConstants.emplace(image, "lst$" + std::to_string(m_listConstants.size()) + (currentFunction.empty() ? "" : "$" + currentFunction));
+        if (inserted) dataSection += it->second + ": dq " + image + "\n";
+        textSection += "    ; constant list " + it->second + ", copied in one block\n";
+        textSection += "    mov rdi, [list_offset]\n";
+        textSection += "    mov rax, list_buffer\n";
+        textSection += "    add rax, rdi      ; rax = adresse de la nouvelle liste\n";
+        textSection += "    add rdi, " + blockSize + "\n";
+        textSection += "    mov [list_offset], rdi\n";
+        textSection += "    mov rdi, rax\n";
+        textSection += "    mov rsi, " + it->second + "\n";
+        textSection += "    mov rcx, " + std::to_string(listSize + 1) + "\n";
+        textSection += "    rep movsq\n";
+        return;
+    }
 
-        textSection += "mov rcx, [list_offset]\n";
-        textSection += "mov qword [list_buffer + rcx], " + std::to_string(listSize) + "\n";
-        textSection += "add rcx, 8\n";
-        textSection += "mov [list_offset], rcx\n";
-        for (int i = 0; i < listSize; i++) {
-            visitNode(node->children[i]); 
-            auto type0 = node->children[i]->type;
-            if (node->children[i]->type == "Identifier") {
-                type0 = getIdentifierType(node->children[i]->value);
-            }
-            if (type0 == "auto") {
-                m_errorManager.addError(Error{
-                    "Undefined Variable; ", 
-                    "Used " + std::string(node->children[i]->value.c_str())+ " before assignment",
-                    "Semantics", 
-                    std::stoi(node->line)
-                });
-                return;
-            }
-            textSection += "mov rcx, [list_offset]\n";
-            textSection += "mov [list_buffer + rcx], rax\n";
-            textSection += "add rcx, 8\n";
-            textSection += "mov [list_offset], rcx\n";
+    // Sinon le bloc entier (taille + éléments) est réservé d'un coup, avant d'évaluer les éléments :
+    // les listes imbriquées qu'ils allouent viennent après lui
+    textSection += "    mov rbx, [list_offset]\n";
+    textSection += "    mov rax, list_buffer\n";
+    textSection += "    add rax, rbx      ; rax = adresse de la nouvelle liste\n";
+    textSection += "    add rbx, " + blockSize + "\n";
+    textSection += "    mov [list_offset], rbx\n";
+    textSection += "    mov qword [rax], " + std::to_string(listSize) + "\n";
+    textSection += "    push rax\n";
+
+    for (std::size_t i = 0; i < listSize; i++) {
+        visitNode(node->children[i]); 
+        if (node->children[i] && node->children[i]->kind == NodeKind::Identifier && typeOf(node->children[i]) == ValueType::Auto) {
+            m_errorManager.addError(Error{
+                "Undefined Variable; ", 
+                "Used " + std::string(node->children[i]->value)+ " before assignment",
+                "Semantics", 
+                node->line
+            });
+            return;
         }
-    }   
+        textSection += "    mov rbx, [rsp]\n";
+        textSection += "    mov [rbx + " + std::to_string((i + 1) * 8) + "], rax\n";
+    }
 
-    textSection += "pop rax\n";  // rax = adresse de début de la liste
+    textSection += "    pop rax           ; rax = adresse de début de la liste\n";
 }
 
-void CodeGenerator::genFunctionCall(const std::shared_ptr<ASTNode>& node) {
-    if (node->children.empty() || node->children[0]->type != "Identifier") {
-        m_errorManager.addError({"Invalid function call AST structure", "", "CodeGeneration", std::stoi(node->line)});
+void CodeGenerator::genFunctionCall(ASTNode* node) {
+    if (node->children.empty() || node->children[0]->kind != NodeKind::Identifier) {
+        m_errorManager.addError({"Invalid function call AST structure", "", "CodeGeneration", node->line});
         return;
     }
 
-    std::string funcName = node->children[0]->value;
+    std::string funcName(node->children[0]->value);
 
    auto args = node->children[1];
 
-   if (funcName != "len"   && funcName != "range" &&  // built-ins
-    funcName != "list"  && funcName != "print")
-{
-    std::vector<std::shared_ptr<ASTNode>> argsList =
-        args ? args->children : std::vector<std::shared_ptr<ASTNode>>{};
-    updateFunctionParamTypes(funcName, argsList);
-}
-   
     if (funcName == "list"){
         if (args->children.size() == 1 && 
-            args->children[0]->type == "FunctionCall" && 
+            args->children[0]->kind == NodeKind::FunctionCall && 
             args->children[0]->children[0]->value == "range"){
             
             auto rangeArgs = args->children[0]->children[1];
             visitNode(rangeArgs->children[0]);
             textSection += "call list_range\n";
+            m_runtime.use(RuntimeItem::ListRange);
             return; 
 
         }
@@ -1340,41 +1629,38 @@ void CodeGenerator::genFunctionCall(const std::shared_ptr<ASTNode>& node) {
         if (args->children.size() == 1){
             auto param = args->children[0];
             visitNode(param);  
-            auto type0 = param->type;
-            if (type0 == "Identifier") {
-                type0 = getIdentifierType(param->value);
-            } else if (type0 == "FunctionCall") {
-                type0 = inferFunctionReturnType(this->rootNode, param->children[0]->value);
-                
-            }
-            if (type0 == "auto") {
+            ValueType type0 = typeOf(param);
+            if (type0 == ValueType::Auto) {
                 // Assume it's a list that we don't know the static type of yet.
                 textSection += "    mov rax, [rax]      ; len(auto-list)\n";
                 return;
             }
-                    if (type0 != "String" && type0 != "List") {
+                    if (type0 != ValueType::String && type0 != ValueType::List) {
                         m_errorManager.addError(Error{
                             "len Error; ", 
                             "Used len on non-list or non-string variable",
                             "Semantics", 
-                            std::stoi(node->line)
+                            node->line
                         });
                         return;
                     }
 
 
 
-                if (type0 == "List") {
+                if (type0 == ValueType::List) {
                     textSection += "mov rax, [rax]  ; Taille de la liste\n";
                 } else { // String
+                    // Labels uniques : len() peut apparaître plusieurs fois dans une fonction (ou un corps déroulé)
+                    std::string loopLabel = newLabel("len_strlen");
+                    std::string doneLabel = newLabel("len_strlen_done");
                     textSection += "mov rsi, rax    ; rsi = adresse de la chaîne\n";
                     textSection += "mov rax, 0      ; rax = compteur\n";
-                    textSection += ".len_strlen_loop:\n";
+                    textSection += loopLabel + ":\n";
                     textSection += "cmp byte [rsi+rax], 0\n";
-                    textSection += "je .len_strlen_done\n";
+                    textSection += "je " + doneLabel + "\n";
                     textSection += "inc rax\n";
-                    textSection += "jmp .len_strlen_loop\n";
-                    textSection += ".len_strlen_done:\n";
+                    textSection += "jmp " + loopLabel + "\n";
+                    textSection += doneLabel + ":\n";
                 }
                 
                 return; 
@@ -1384,25 +1670,22 @@ void CodeGenerator::genFunctionCall(const std::shared_ptr<ASTNode>& node) {
                     "len Error; ", 
                     "Too many arguments for len()",
                     "Semantics", 
-                    std::stoi(node->line)
+                    node->line
                 });
                 return;
             }
     }
     
     int argCount = 0;
-    const std::vector<std::shared_ptr<ASTNode>>* argListPtr = nullptr;
+    const NodeList* argListPtr = nullptr;
 
 	
 
-    if (node->children.size() > 1 && (node->children[1]->type == "ParameterList" || node->children[1]->type == "ActualParameterList")) {
+    if (node->children.size() > 1 && (node->children[1]->kind == NodeKind::ParameterList)) {
         argListPtr = &node->children[1]->children;
         argCount = argListPtr->size();
     }
 
-	if (argListPtr)
-        updateFunctionParamTypes(funcName, *argListPtr);
-
     bool alignment_padding_added = false;
        if ((argCount % 2) != 0) { 
         textSection += "    sub rsp, 8           ; Align stack for odd number of arguments\n";
@@ -1431,337 +1714,13 @@ void CodeGenerator::genFunctionCall(const std::shared_ptr<ASTNode>& node) {
 
 }
     
-void CodeGenerator::genReturn(const std::shared_ptr<ASTNode>& node) {
+void CodeGenerator::genReturn(ASTNode* node) {
     // Evaluate return expression if any
     if (!node->children.empty()) {
         visitNode(node->children[0]);
     } else {
         textSection += "    xor rax, rax\n";  
     }
-	if (currentFuncSym && currentFuncSym->returnType == "autoFun") {
-    currentFuncSym->returnType = getExpressionType(node->children[0]);
-}
 
     textSection += "    jmp .return_" + currentFunction + "\n";
 }
-
-
-// Fonction pour obtenir le type d'un identifiant à partir de la table des symboles
-std::string CodeGenerator::getIdentifierType(const std::string& name) {
-    if (!symbolTable) return "auto"; // Should not happen if called correctly
-
-    SymbolTable* tableToSearch = currentSymbolTable; // Start with current function's scope
-
-    std::function<Symbol*(const std::string&, SymbolTable*)> findSymbolRecursive = 
-        [&](const std::string& symName, SymbolTable* table) -> Symbol* {
-        if (!table) return nullptr;
-        for (const auto& sym_ptr : table->symbols) {
-            if (sym_ptr->name == symName) {
-                return sym_ptr.get();
-            }
-        }
-        // Correctly search in parent scope if currentSymbolTable is a function scope
-        if (table->parent && (table->scopeName.rfind("function ", 0) == 0 || table->parent == symbolTable)) {
-             return findSymbolRecursive(symName, table->parent);
-        } else if (table != symbolTable) { // If not in function scope and not global, search global
-            return findSymbolRecursive(symName, symbolTable);
-        }
-        return nullptr; 
-    };
-    
-    
-    Symbol* sym = nullptr;
-    if (tableToSearch) { 
-        sym = findSymbolRecursive(name, tableToSearch);
-    }
-    // If not found in current scope hierarchy, try global scope directly if not already searched
-    if (!sym && tableToSearch != symbolTable && symbolTable) {
-        sym = findSymbolRecursive(name, symbolTable);
-    }
-
-
-    if (sym) {
-        if (sym->symCat == "variable" || sym->symCat == "parameter") {
-            if (auto varSym = dynamic_cast<VariableSymbol*>(sym)) {
-                return varSym->type;
-            }
-        } else if (sym->symCat == "function") {
-            if (auto funcSym = dynamic_cast<FunctionSymbol*>(sym)) {
-                return funcSym->returnType; // Or a special "function_type"
-            }
-        } else if (sym->symCat == "array") {
-            return "List"; 
-        }
-        return "auto"; 
-    }
-    
-    return "auto"; 
-}
-
-
-bool CodeGenerator::isStringVariable(const std::string& name) {
-    std::string type = getIdentifierType(name);
-    return type == "String" || type == "auto"; 
-}
-
-bool CodeGenerator::isIntVariable(const std::string& name) {
-    std::string t = getIdentifierType(name);
-    return t == "Integer" || t == "auto" || t == "autoFun";
-}
-
-void CodeGenerator::updateSymbolType(const std::string& name, const std::string& newType) {
-    if (!symbolTable) return;
-
-    SymbolTable* scopeToSearch = currentSymbolTable ? currentSymbolTable : symbolTable;
-    if (scopeToSearch) {
-        Symbol* s = scopeToSearch->findSymbol(name); 
-        if (s && (s->symCat == "variable" || s->symCat == "parameter")) {
-            if (auto v = dynamic_cast<VariableSymbol*>(s)) {
-                if (v->type != "auto" && v->type != "autoFun") { 
-                    return;
-                }
-            }
-        }
-    }
-
-    std::function<bool(SymbolTable*, const std::string&, const std::string&)> updateInTableHierarchy = 
-        [&](SymbolTable* table, const std::string& symName, const std::string& typeToSet) -> bool {
-        while (table) {
-            for (auto& sym_ptr : table->symbols) {
-                if (sym_ptr->name == symName && (sym_ptr->symCat == "variable" || sym_ptr->symCat == "parameter")) {
-                    if (auto varSym = dynamic_cast<VariableSymbol*>(sym_ptr.get())) {
-                        varSym->type = typeToSet;
-                        return true;
-                    }
-                }
-            }
-            table = table->parent;
-        }
-        return false;
-    };
-
-    if (currentSymbolTable && currentSymbolTable->scopeName.rfind("function ", 0) == 0) {
-        if (updateInTableHierarchy(currentSymbolTable, name, newType)) {
-            return;
-        }
-    }
-    updateInTableHierarchy(symbolTable, name, newType);
-}
-
-void CodeGenerator::resetFunctionVarTypes(const std::string& funcName) {
-
-    if (!symbolTable) return;
-    
-    SymbolTable* functionScope = nullptr;
-    for (const auto& child : symbolTable->children) { 
-        if (child->scopeName == "function " + funcName) {
-            functionScope = child.get();
-            break;
-        }
-    }
-
-    if (functionScope) {
-        for (auto& sym_ptr : functionScope->symbols) {
-            if (sym_ptr->symCat == "variable" || sym_ptr->symCat == "parameter") {
-                if (auto varSym = dynamic_cast<VariableSymbol*>(sym_ptr.get())) {
-                    varSym->type = "auto"; 
-                }
-            }
-        }
-    }
-}
-
-std::string CodeGenerator::inferFunctionReturnType(const std::shared_ptr<ASTNode>& root, const std::string& funcName) {
-    if (!root) return "Integer"; // Or "auto"
-
-    if (symbolTable) {
-        Symbol* sym = symbolTable->findSymbol(funcName);
-        if (sym && sym->symCat == "function") {
-            if (auto funcSym = dynamic_cast<FunctionSymbol*>(sym)) {
-                if (funcSym->returnType != "autoFun" && !funcSym->returnType.empty()) { 
-                    return funcSym->returnType;
-                }
-            }
-        }
-    }
-
-
-    for (const auto& child : root->children) {
-        if (child->type == "Definitions") {
-            for (const auto& def : child->children) {
-                if (def->type == "FunctionDefinition" && def->value == funcName) {
-                    std::string returnType = "Integer"; 
-                    bool typeSet = false;
-                    
-                    std::function<void(const std::shared_ptr<ASTNode>&)> findReturns;
-                    findReturns = [&](const std::shared_ptr<ASTNode>& node) {
-                        if (!node || typeSet) return; 
-                        
-                        if (node->type == "Return" && !node->children.empty()) {
-                            auto returnExpr = node->children[0];
-                            std::string currentExprType = "Integer"; 
-
-                            if (returnExpr->type == "String") {
-                                currentExprType = "String";
-                            } else if (returnExpr->type == "List") {
-                                currentExprType = "List";
-                            } else if (returnExpr->type == "Integer") {
-                                currentExprType = "Integer";
-                            } else if (returnExpr->type == "True" || returnExpr->type == "False") {
-                                currentExprType = "Boolean"; // Assuming Boolean type
-                            } else if (returnExpr->type == "FunctionCall") {
-                                if (returnExpr->children[0]->value == funcName) {
-
-                                } else {
-                                    
-                                    currentExprType = getFunctionReturnType(returnExpr->children[0]->value);
-                                }
-                            } else if (returnExpr->type == "Identifier") {
-                                currentExprType = getIdentifierType(returnExpr->value);
-                            }
-
-                            if (!typeSet) { 
-                                returnType = currentExprType;
-                                if (returnType != "auto") { 
-                                }
-                            } else if (returnType != currentExprType && currentExprType != "auto") {
-
-                            }
-                            return; 
-                        }
-                        
-                        for (const auto& childNode : node->children) {
-                            findReturns(childNode);
-                        }
-                    };
-                    
-                    // Body is child 1 (FormalParameterList is child 0)
-                    if (def->children.size() > 1 && def->children[1]->type == "FunctionBody") {
-                        findReturns(def->children[1]); 
-                    } else if (def->children.size() > 0 && def->children[0]->type != "FormalParameterList" && def->children[0]) {
-  
-                        findReturns(def->children[0]);
-                    }
-                    
-                    return returnType;
-                }
-            }
-        }
-    }
-
-	if (funcName == "list" || funcName == "range") return "List";
-    
-    return "Integer";
-}
-
-std::string CodeGenerator::getExpressionType(const std::shared_ptr<ASTNode>& node) {
-	
-    if (!node) return "auto"; 
-	if (node->type == "auto" || node->type == "autoFun") return "Integer";
-    if (node->type == "Integer") {
-        return "Integer";
-    } else if (node->type == "String") {
-        return "String";
-    } else if (node->type == "True" || node->type == "False") {
-        return "Boolean";
-    } else if (node->type == "Identifier") {
-        return getIdentifierType(node->value);
-    } else if (node->type == "FunctionCall") {
-        if (!node->children.empty() && node->children[0]->type == "Identifier") {
-
-            if (node->children[0]->value == "len") return "Integer"; // len() always returns Integer
-            if (node->children[0]->value == "print") return "void"; // print() doesn't return a value
-            if (node->children[0]->value == "list") return "List"; // list() returns a List
-            if (node->children[0]->value == "range") return "List"; // str() returns a String
-            return inferFunctionReturnType(this->rootNode, node->children[0]->value);
-        }
-        return "autoFun"; 
-    } else if (node->type == "List") {
-        return "List";
-    } else if (node->type == "ListCall") {
-    return "Integer";
-}else if (node->type == "ArithOp" || node->type == "TermOp") {
-
-        if (!node->children.empty()) {
-            std::string type1 = getExpressionType(node->children[0]);
-            if (node->children.size() > 1) {
-                std::string type2 = getExpressionType(node->children[1]);
-
-                if (node->value == "+") {
-                    if (type1 == "String" || type2 == "String") return "String";
-                    if (type1 == "List" || type2 == "List") return "List";
-                }
-                
-                if (type1 != "auto") return type1;
-                return "Integer"; 
-            }
-            if (type1 != "auto") return type1;
-        }
-        return "Integer"; 
-    } else if (node->type == "Compare" || node->type == "And" || node->type == "Or" || node->type == "Not") {
-        return "Boolean";
-    } else if (node->type == "UnaryOp") {
-        if (!node->children.empty()) {
-            return getExpressionType(node->children[0]); 
-        }
-        return "Integer"; 
-    }
-    
-
-
-    m_errorManager.addError({"Cannot determine expression type for node type: ", node->type, "CodeGeneration", std::stoi(node->line)});
-    return "auto"; 
-}
-
-std::string CodeGenerator::getFunctionReturnType(const std::string& funcName) {
-    if (!symbolTable) return "auto";
-
-    for (const auto& sym : symbolTable->symbols) {
-        if (sym->name == funcName && sym->symCat == "function") {
-            if (auto funcSym = dynamic_cast<FunctionSymbol*>(sym.get())) {
-                return funcSym->returnType;
-            }
-        }
-    }
-
-    return "auto"; 
-}
-
-void CodeGenerator::updateFunctionParamTypes(
-        const std::string&           funcName,
-        const std::vector<std::shared_ptr<ASTNode>>& actualArgs)
-{
-    auto *fs = dynamic_cast<FunctionSymbol*>(symbolTable
-                                            ? symbolTable->findSymbol(funcName)
-                                            : nullptr);
-    if (!fs) return;                       // unknown function (built-ins etc.)
-
-    SymbolTable *funcScope = nullptr;
-    for (auto &sub : symbolTable->children)
-        if (sub->scopeName == ("function " + funcName)) {
-            funcScope = sub.get();
-            break;
-        }
-    if (!funcScope) return;                // should not happen
-
-    std::size_t argIdx = 0;
-    for (auto &symPtr : funcScope->symbols) {
-        if (argIdx >= actualArgs.size()) break; 
-
-        auto *param = dynamic_cast<VariableSymbol*>(symPtr.get());
-        if (!param) continue;                   
-
-        std::string argType = getExpressionType(actualArgs[argIdx]);
-        if ((argType == "auto" || argType == "autoFun") &&
-            actualArgs[argIdx]->type == "Identifier")
-        {
-            argType = getIdentifierType(actualArgs[argIdx]->value);
-        }
-
-        if (param->type == "auto" && argType != "auto" && !argType.empty())
-            param->type = argType;
-
-        ++argIdx;
-        if (argIdx >= actualArgs.size()) break;
-    }
-}
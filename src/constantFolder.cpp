@@ -0,0 +1,69 @@
+#include "constantFolder.h"
+#include <algorithm>
+
+void ConstantFolder::run(ASTNode* root) {
+    m_folded.clear();
+    m_pure = analysePurity(m_globals, m_callGraph);
+    m_evaluator.setPureFunctions(&m_pure);
+    if (!root) return;
+
+    for (ASTNode*& child : root->children) {
+        if (!child) continue;
+        if (child->kind != NodeKind::Definitions) {
+            fold(child, "main");
+            continue;
+        }
+        for (ASTNode* def : child->children) {
+            if (!def || def->kind != NodeKind::FunctionDefinition || def->children.size() < 2 || !def->children[1]) continue;
+            if (!m_callGraph.reachable(def->nameId)) continue; // ne sera pas générée
+            fold(def->children[1], std::string(def->value));
+        }
+    }
+}
+
+std::size_t ConstantFolder::pureCount() const {
+    return static_cast<std::size_t>(std::count(m_pure.begin(), m_pure.end(), true));
+}
+
+void ConstantFolder::report(std::ostream& out) const {
+    for (const FoldedCall& call : m_folded) {
+        out << "[fold] " << call.callee << " in " << call.caller << ", line " << call.line << ": " << call.value << "\n";
+    }
+    out << "[fold] " << m_folded.size() << " calls folded, " << pureCount() << " of " << m_callGraph.size()
+        << " functions pure, " << steps() << " evaluation steps" << std::endl;
+}
+
+void ConstantFolder::fold(ASTNode*& slot, const std::string& caller) {
+    ASTNode* node = slot;
+    if (!node) return;
+    for (ASTNode*& child : node->children) fold(child, caller);
+    if (node->kind != NodeKind::FunctionCall || node->children.empty() || !node->children[0]) return;
+
+    std::size_t f = m_callGraph.indexOf(node->children[0]->nameId);
+    if (f == CallGraph::npos || !m_pure[f]) return;
+    // Seul un résultat entier ou booléen devient un littéral (mov rax, imm)
+    ValueType type = node->type;
+    if (type != ValueType::Integer && type != ValueType::Boolean && type != ValueType::Auto) return;
+    std::vector<Evaluator::Value> args;
+    if (const NodeList* params = argumentsOf(node)) {
+        for (const ASTNode* arg : *params) {
+            std::optional<Evaluator::Value> value = Evaluator::literal(arg);
+            if (!value) return;
+            args.push_back(std::move(*value));
+        }
+    }
+    std::optional<Evaluator::Value> result = m_evaluator.call(f, args);
+    if (!result || result->kind != Evaluator::Value::Kind::Integer) return;
+
+    std::int64_t value = result->integer;
+    ASTNode* literal = nullptr;
+    if (type == ValueType::Boolean && (value == 0 || value == 1)) {
+        literal = m_arena.make(value ? NodeKind::True : NodeKind::False, node->line);
+    } else {
+        literal = m_arena.make(NodeKind::Integer, node->line, std::to_string(value));
+    }
+    literal->type = type;
+    m_folded.push_back(FoldedCall{std::string(node->children[0]->value), caller, node->line,
+                                  literal->kind == NodeKind::Integer ? std::string(literal->value) : (value ? "True" : "False")});
+    slot = literal;
+}
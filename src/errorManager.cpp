@@ -66,3 +66,10 @@ void ErrorManager::displayErrors() const {
 bool ErrorManager::hasErrors() const {
     return !errorQueue.empty();
 }
+
+void ErrorManager::append(ErrorManager& other) {
+    while (!other.errorQueue.empty()) {
+        errorQueue.push(std::move(other.errorQueue.front()));
+        other.errorQueue.pop();
+    }
+}
@@ -0,0 +1,513 @@
+#include "evaluator.h"
+#include "astQueries.h"
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+// Arithmétique modulo 2^64, comme add/sub/imul
+std::int64_t wrapAdd(std::int64_t a, std::int64_t b) {
+    return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) + static_cast<std::uint64_t>(b));
+}
+
+std::int64_t wrapSub(std::int64_t a, std::int64_t b) {
+    return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) - static_cast<std::uint64_t>(b));
+}
+
+std::int64_t wrapMul(std::int64_t a, std::int64_t b) {
+    return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) * static_cast<std::uint64_t>(b));
+}
+
+} // namespace
+
+std::optional<Evaluator::Value> Evaluator::literal(const ASTNode* node) {
+    if (!node) return std::nullopt;
+    switch (node->kind) {
+    case NodeKind::Integer: {
+        std::int64_t v = 0;
+        const char* end = node->value.data() + node->value.size();
+        auto [ptr, ec] = std::from_chars(node->value.data(), end, v);
+        if (ec != std::errc{} || ptr != end) return std::nullopt;
+        return Value::ofInteger(v);
+    }
+    case NodeKind::True: return Value::ofInteger(1);
+    case NodeKind::False: return Value::ofInteger(0);
+    case NodeKind::String: return Value{Value::Kind::String, 0, std::make_shared<std::string>(node->value), nullptr};
+    case NodeKind::UnaryOp: {
+        if (node->value != "-" || node->children.size() != 1 || staticType(node->children[0]) != ValueType::Integer) break;
+        std::optional<Value> operand = literal(node->children[0]);
+        if (!operand || operand->kind != Value::Kind::Integer) break;
+        return Value::ofInteger(wrapSub(0, operand->integer));
+    }
+    default:
+        break;
+    }
+    return std::nullopt;
+}
+
+std::optional<Evaluator::Value> Evaluator::call(std::size_t f, const std::vector<Value>& args) {
+    begin();
+    try {
+        return invoke(f, args);
+    } catch (const Stop&) {
+        return std::nullopt;
+    }
+}
+
+bool Evaluator::executeStatement(const ASTNode* statement) {
+    try {
+        execute(statement);
+        return !m_returning;
+    } catch (const Stop&) {
+        return false;
+    }
+}
+
+void Evaluator::begin() {
+    m_steps = 0;
+    m_depth = 0;
+    m_heapWords = 0;
+    m_concatBuffer.reset();
+    m_globalValues.clear();
+    m_frames.clear();
+    m_returning = false;
+}
+
+void Evaluator::step() {
+    if (++m_steps > m_limits.steps) stop();
+    ++m_totalSteps;
+}
+
+Evaluator::Value Evaluator::invoke(std::size_t f, const std::vector<Value>& args) {
+    const ASTNode* def = m_callGraph.definition(f);
+    if (def->children.size() < 2 || !def->children[0] || def->children[0]->kind != NodeKind::FormalParameterList
+        || !def->children[1]) stop();
+    const NodeList& params = def->children[0]->children;
+    if (params.size() != args.size()) stop();
+
+    // Mémoïsation : fonction pure, arguments entiers, et une exécution qui n'a touché ni au tas
+    // des listes ni à concat_buffer (la sauter changerait l'état vu par l'appelant)
+    bool memoizable = m_pure && (*m_pure)[f];
+    std::vector<std::int64_t> key;
+    for (const Value& arg : args) {
+        if (arg.kind != Value::Kind::Integer) memoizable = false;
+        else key.push_back(arg.integer);
+    }
+    if (memoizable) {
+        auto it = m_memo.find({f, key});
+        if (it != m_memo.end()) return Value::ofInteger(it->second);
+    }
+
+    if (++m_depth > m_limits.depth) stop();
+    const FunctionSymbol* function = symbolAs<FunctionSymbol>(m_globals.findImmediateSymbol(def->nameId));
+    if (!function || !function->scope) stop();
+    Frame frame;
+    frame.scope = function->scope;
+    for (std::size_t i = 0; i < params.size(); ++i) {
+        if (!params[i]) stop();
+        frame.locals[params[i]->nameId] = args[i];
+    }
+    std::size_t heapBefore = m_heapWords;
+    std::shared_ptr<std::string> bufferBefore = m_concatBuffer;
+    std::string contentsBefore = bufferBefore ? *bufferBefore : std::string();
+
+    m_frames.push_back(std::move(frame));
+    execute(def->children[1]);
+    if (!m_returning) stop(); // sortie sans return : rax n'a pas de valeur définie
+    m_returning = false;
+    Value result = std::move(m_returnValue);
+    m_frames.pop_back();
+    --m_depth;
+
+    bool untouched = m_heapWords == heapBefore && m_concatBuffer == bufferBefore
+                     && (!m_concatBuffer || *m_concatBuffer == contentsBefore);
+    if (memoizable && untouched && result.kind == Value::Kind::Integer) m_memo.emplace(std::make_pair(f, std::move(key)), result.integer);
+    return result;
+}
+
+void Evaluator::execute(const ASTNode* node) {
+    if (!node) return;
+    step();
+    switch (node->kind) {
+    case NodeKind::Instructions:
+    case NodeKind::FunctionBody:
+    case NodeKind::IfBody:
+    case NodeKind::ElseBody:
+    case NodeKind::ForBody:
+    case NodeKind::WhileBody:
+        for (const ASTNode* child : node->children) {
+            execute(child);
+            if (m_returning) return;
+        }
+        return;
+    case NodeKind::Affect:
+        executeAffect(node);
+        return;
+    case NodeKind::If: {
+        if (node->children.size() < 2) stop();
+        if (truth(evaluate(node->children[0]), staticType(node->children[0]))) execute(node->children[1]);
+        else if (node->children.size() > 2) execute(node->children[2]);
+        return;
+    }
+    case NodeKind::While:
+        if (node->children.size() < 2) stop();
+        while (truth(evaluate(node->children[0]), staticType(node->children[0]))) {
+            execute(node->children[1]);
+            if (m_returning) return;
+        }
+        return;
+    case NodeKind::For:
+        executeFor(node);
+        return;
+    case NodeKind::Return:
+        if (m_frames.empty()) stop();
+        m_returnValue = node->children.empty() || !node->children[0] ? Value::ofInteger(0) : evaluate(node->children[0]);
+        m_returning = true;
+        return;
+    case NodeKind::Print:
+        print(node);
+        return;
+    case NodeKind::FunctionDefinition:
+        stop();
+    default:
+        evaluate(node); // expression utilisée comme instruction
+        return;
+    }
+}
+
+void Evaluator::executeAffect(const ASTNode* node) {
+    if (node->children.size() < 2 || !node->children[0]) stop();
+    const ASTNode* target = node->children[0];
+    Value value = evaluate(node->children[1]);
+    if (target->kind == NodeKind::Identifier) {
+        variable(target, true) = std::move(value);
+        return;
+    }
+    if (target->kind != NodeKind::ListCall || target->children.size() < 2 || !target->children[0]
+        || target->children[0]->kind != NodeKind::Identifier || !target->children[1]) stop();
+    // genAffect garde l'adresse de la liste dans rbx pendant l'évaluation de l'indice : seul un
+    // indice qui ne touche pas rbx donne le comportement attendu
+    const ASTNode* indexNode = target->children[1];
+    if (indexNode->kind != NodeKind::Identifier && indexNode->kind != NodeKind::Integer) stop();
+    Value list = variable(target->children[0], false);
+    Value index = evaluate(indexNode);
+    if (list.kind != Value::Kind::List || index.kind != Value::Kind::Integer) stop();
+    if (index.integer < 0 || static_cast<std::uint64_t>(index.integer) >= list.list->size()) stop(); // index_error
+    (*list.list)[static_cast<std::size_t>(index.integer)] = std::move(value);
+}
+
+void Evaluator::executeFor(const ASTNode* node) {
+    if (node->children.size() < 3 || !node->children[0] || node->children[0]->kind != NodeKind::Identifier || !node->children[1]) stop();
+    const ASTNode* loopVar = node->children[0];
+    const ASTNode* iterable = node->children[1];
+    const ASTNode* body = node->children[2];
+
+    if (iterable->kind == NodeKind::FunctionCall && !iterable->children.empty() && iterable->children[0]
+        && iterable->children[0]->kind == NodeKind::Identifier && iterable->children[0]->value == "range") {
+        const NodeList* args = argumentsOf(iterable);
+        if (!args || args->size() != 1) stop();
+        // i = 0 ; N évalué une fois ; la variable relue à chaque tour (le corps peut la modifier)
+        variable(loopVar, true) = Value::ofInteger(0);
+        Value limit = evaluate((*args)[0]);
+        if (limit.kind != Value::Kind::Integer) stop();
+        while (true) {
+            step();
+            Value i = variable(loopVar, false);
+            if (i.kind != Value::Kind::Integer) stop();
+            if (i.integer >= limit.integer) return;
+            execute(body);
+            if (m_returning) return;
+            Value next = variable(loopVar, false);
+            if (next.kind != Value::Kind::Integer) stop();
+            variable(loopVar, true) = Value::ofInteger(wrapAdd(next.integer, 1));
+        }
+    }
+
+    ValueType iterType = staticType(iterable);
+    if (iterType == ValueType::String || iterType == ValueType::Integer) stop();
+    Value list = evaluate(iterable);
+    if (list.kind != Value::Kind::List) stop();
+    for (std::size_t k = 0;; ++k) {
+        step();
+        if (k >= list.list->size()) return;
+        variable(loopVar, true) = (*list.list)[k];
+        execute(body);
+        if (m_returning) return;
+    }
+}
+
+// Même texte que print_number / print_string / print_not_string, arguments séparés par une espace
+void Evaluator::print(const ASTNode* node) {
+    if (!m_output) stop();
+    for (std::size_t i = 0; i < node->children.size(); ++i) {
+        const ASTNode* arg = node->children[i];
+        Value value = evaluate(arg);
+        ValueType type = staticType(arg);
+        if (type == ValueType::Auto || type == ValueType::AutoFun) type = ValueType::Integer;
+        write(value, type);
+        if (i + 1 < node->children.size()) *m_output += ' ';
+    }
+    *m_output += '\n';
+    if (m_output->size() > m_limits.output) stop();
+}
+
+void Evaluator::write(const Value& value, ValueType type) {
+    switch (type) {
+    case ValueType::Integer:
+    case ValueType::Boolean: {
+        if (value.kind != Value::Kind::Integer) stop(); // afficherait une adresse
+        std::uint64_t magnitude = static_cast<std::uint64_t>(value.integer);
+        if (value.integer < 0) {
+            *m_output += '-';
+            magnitude = 0 - magnitude;
+        }
+        *m_output += std::to_string(magnitude);
+        return;
+    }
+    case ValueType::String:
+        if (value.kind != Value::Kind::String) stop();
+        *m_output += value.string->substr(0, value.string->find('\0'));
+        return;
+    case ValueType::List:
+        if (value.kind != Value::Kind::List) stop();
+        *m_output += '[';
+        for (std::size_t i = 0; i < value.list->size(); ++i) {
+            const Value& element = (*value.list)[i];
+            if (i > 0) *m_output += ", ";
+            // print_not_string devine le type de l'élément : entier sous 0x1000 ou hors de l'espace
+            // d'adressage, chaîne ASCII imprimable de moins de 20 caractères ; sinon il lit la mémoire
+            if (element.kind == Value::Kind::Integer) {
+                std::uint64_t bits = static_cast<std::uint64_t>(element.integer);
+                if (bits >= 0x1000 && (bits >> 48) == 0) stop();
+                write(element, ValueType::Integer);
+            } else if (element.kind == Value::Kind::String) {
+                const std::string& text = *element.string;
+                if (text.size() >= 20 || !std::all_of(text.begin(), text.end(), [](char c) { return c >= 32 && c <= 126; })) stop();
+                *m_output += text;
+            } else {
+                stop();
+            }
+        }
+        *m_output += ']';
+        return;
+    default:
+        stop();
+    }
+}
+
+Evaluator::Value Evaluator::evaluate(const ASTNode* node) {
+    if (!node) stop();
+    step();
+    switch (node->kind) {
+    case NodeKind::Integer:
+    case NodeKind::True:
+    case NodeKind::False:
+    case NodeKind::String:
+    case NodeKind::UnaryOp: {
+        if (node->kind == NodeKind::UnaryOp) {
+            if (node->value != "-" || node->children.size() != 1 || staticType(node->children[0]) != ValueType::Integer) stop();
+            Value operand = evaluate(node->children[0]);
+            if (operand.kind != Value::Kind::Integer) stop();
+            return Value::ofInteger(wrapSub(0, operand.integer));
+        }
+        std::optional<Value> value = literal(node);
+        if (!value) stop();
+        return *value;
+    }
+    case NodeKind::Identifier:
+        return variable(node, false);
+    case NodeKind::List: {
+        bool empty = node->children.size() == 1 && node->children[0] == nullptr;
+        std::size_t size = empty ? 0 : node->children.size();
+        Value list = allocateList(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            const ASTNode* element = node->children[i];
+            if (!element || (element->kind == NodeKind::Identifier && staticType(element) == ValueType::Auto)) stop();
+            (*list.list)[i] = evaluate(element);
+        }
+        return list;
+    }
+    case NodeKind::ListCall: {
+        if (node->children.size() < 2 || !node->children[0] || node->children[0]->kind != NodeKind::Identifier) stop();
+        Value index = evaluate(node->children[1]);
+        Value list = variable(node->children[0], false);
+        if (list.kind != Value::Kind::List || index.kind != Value::Kind::Integer) stop();
+        if (index.integer < 0 || static_cast<std::uint64_t>(index.integer) >= list.list->size()) stop(); // index_error
+        return (*list.list)[static_cast<std::size_t>(index.integer)];
+    }
+    case NodeKind::FunctionCall:
+        return evaluateCall(node);
+    case NodeKind::Compare: {
+        if (node->children.size() < 2) stop();
+        Value left = evaluate(node->children[0]);
+        Value right = evaluate(node->children[1]);
+        std::string_view op = node->value;
+        if ((op == "==" || op == "!=") && staticType(node->children[0]) == ValueType::String
+            && staticType(node->children[1]) == ValueType::String) {
+            if (left.kind != Value::Kind::String || right.kind != Value::Kind::String) stop();
+            return Value::ofInteger((*left.string == *right.string) == (op == "=="));
+        }
+        if (left.kind != Value::Kind::Integer || right.kind != Value::Kind::Integer) stop();
+        std::int64_t l = left.integer, r = right.integer;
+        if (op == "==") return Value::ofInteger(l == r);
+        if (op == "!=") return Value::ofInteger(l != r);
+        if (op == "<") return Value::ofInteger(l < r);
+        if (op == ">") return Value::ofInteger(l > r);
+        if (op == "<=") return Value::ofInteger(l <= r);
+        if (op == ">=") return Value::ofInteger(l >= r);
+        stop();
+    }
+    case NodeKind::ArithOp: {
+        if (node->children.size() < 2) stop();
+        ValueType typeL = staticType(node->children[0]);
+        ValueType typeR = staticType(node->children[1]);
+        if (node->value == "+") {
+            if (typeL != typeR) stop();
+            Value left = evaluate(node->children[0]);
+            Value right = evaluate(node->children[1]);
+            if (typeL == ValueType::List) {
+                if (left.kind != Value::Kind::List || right.kind != Value::Kind::List) stop();
+                Value list = allocateList(left.list->size() + right.list->size());
+                std::copy(left.list->begin(), left.list->end(), list.list->begin());
+                std::copy(right.list->begin(), right.list->end(), list.list->begin() + static_cast<std::ptrdiff_t>(left.list->size()));
+                return list;
+            }
+            if (typeL == ValueType::String) {
+                if (left.kind != Value::Kind::String || right.kind != Value::Kind::String) stop();
+                // str_concat recopie str1 puis str2 au début de concat_buffer : str2 ne doit pas y être
+                if (m_concatBuffer && right.string == m_concatBuffer) stop();
+                std::string result = *left.string + *right.string;
+                if (result.size() + 1 > kConcatBufferSize) stop();
+                if (!m_concatBuffer) m_concatBuffer = std::make_shared<std::string>();
+                *m_concatBuffer = std::move(result);
+                return Value{Value::Kind::String, 0, m_concatBuffer, nullptr};
+            }
+            if (typeL != ValueType::Integer && typeL != ValueType::Auto) stop();
+            if (left.kind != Value::Kind::Integer || right.kind != Value::Kind::Integer) stop();
+            return Value::ofInteger(wrapAdd(left.integer, right.integer));
+        }
+        if (node->value == "-") {
+            auto numeric = [](ValueType t) { return t == ValueType::Integer || t == ValueType::Boolean || t == ValueType::Auto || t == ValueType::AutoFun; };
+            if (!numeric(typeL) || !numeric(typeR)) stop();
+            Value left = evaluate(node->children[0]);
+            Value right = evaluate(node->children[1]);
+            if (left.kind != Value::Kind::Integer || right.kind != Value::Kind::Integer) stop();
+            return Value::ofInteger(wrapSub(left.integer, right.integer));
+        }
+        stop();
+    }
+    case NodeKind::TermOp: {
+        if (node->children.size() < 2) stop();
+        Value left = evaluate(node->children[0]);
+        Value right = evaluate(node->children[1]);
+        ValueType typeL = staticType(node->children[0]);
+        ValueType typeR = staticType(node->children[1]);
+        if ((typeL != ValueType::Integer && typeL != ValueType::Auto) || (typeR != ValueType::Integer && typeR != ValueType::Auto)) stop();
+        if (left.kind != Value::Kind::Integer || right.kind != Value::Kind::Integer) stop();
+        std::int64_t l = left.integer, r = right.integer;
+        if (node->value == "*") return Value::ofInteger(wrapMul(l, r));
+        bool division = node->value == "/" || node->value == "//";
+        if (!division && node->value != "%") stop();
+        // division_by_zero_error, ou #DE d'idiv sur INT64_MIN / -1
+        if (r == 0 || (l == INT64_MIN && r == -1)) stop();
+        return Value::ofInteger(division ? l / r : l % r);
+    }
+    case NodeKind::And: {
+        if (node->children.size() < 2) stop();
+        Value left = evaluate(node->children[0]);
+        if (left.kind == Value::Kind::Integer && left.integer == 0) return left;
+        return evaluate(node->children[1]);
+    }
+    case NodeKind::Or: {
+        if (node->children.size() < 2) stop();
+        Value left = evaluate(node->children[0]);
+        if (left.kind != Value::Kind::Integer || left.integer != 0) return left;
+        return evaluate(node->children[1]);
+    }
+    case NodeKind::Not: {
+        if (node->children.empty()) stop();
+        Value operand = evaluate(node->children[0]);
+        return Value::ofInteger(operand.kind == Value::Kind::Integer && operand.integer == 0);
+    }
+    default:
+        stop();
+    }
+}
+
+Evaluator::Value Evaluator::evaluateCall(const ASTNode* node) {
+    if (node->children.empty() || !node->children[0] || node->children[0]->kind != NodeKind::Identifier) stop();
+    std::string_view name = node->children[0]->value;
+    const NodeList* args = argumentsOf(node);
+    std::size_t argCount = args ? args->size() : 0;
+
+    if (name == "list" && argCount == 1) {
+        // seule forme que génère genFunctionCall : list(range(n))
+        const ASTNode* range = (*args)[0];
+        if (!range || range->kind != NodeKind::FunctionCall || range->children.empty() || !range->children[0]
+            || range->children[0]->value != "range") stop();
+        const NodeList* rangeArgs = argumentsOf(range);
+        if (!rangeArgs || rangeArgs->empty()) stop();
+        Value n = evaluate((*rangeArgs)[0]);
+        if (n.kind != Value::Kind::Integer || n.integer < 0 || n.integer > static_cast<std::int64_t>(kListHeapWords)) stop();
+        Value list = allocateList(static_cast<std::size_t>(n.integer));
+        for (std::size_t i = 0; i < list.list->size(); ++i) (*list.list)[i] = Value::ofInteger(static_cast<std::int64_t>(i));
+        return list;
+    }
+    if (name == "len") {
+        if (argCount != 1) stop();
+        Value value = evaluate((*args)[0]);
+        ValueType type = staticType((*args)[0]);
+        if ((type == ValueType::Auto || type == ValueType::List) && value.kind == Value::Kind::List) {
+            return Value::ofInteger(static_cast<std::int64_t>(value.list->size()));
+        }
+        if (type == ValueType::String && value.kind == Value::Kind::String) {
+            return Value::ofInteger(static_cast<std::int64_t>(value.string->size()));
+        }
+        stop();
+    }
+
+    std::size_t f = m_callGraph.indexOf(node->children[0]->nameId);
+    if (f == CallGraph::npos) stop();
+    // Arguments évalués du dernier au premier, comme les push de genFunctionCall
+    std::vector<Value> values(argCount);
+    for (std::size_t i = argCount; i-- > 0;) values[i] = evaluate((*args)[i]);
+    return invoke(f, values);
+}
+
+Evaluator::Value& Evaluator::variable(const ASTNode* identifier, bool assign) {
+    Interner::Id id = identifier->nameId;
+    std::unordered_map<Interner::Id, Value>* values = &m_globalValues;
+    const Symbol* symbol = nullptr;
+    if (!m_frames.empty()) symbol = m_frames.back().scope->findImmediateSymbol(id);
+    if (symbol) values = &m_frames.back().locals;
+    else symbol = m_globals.findImmediateSymbol(id);
+    if (!symbol || symbol->kind != SymbolKind::Variable) stop();
+
+    if (assign) return (*values)[id];
+    auto it = values->find(id);
+    if (it == values->end()) stop(); // lu avant d'être affecté
+    return it->second;
+}
+
+Evaluator::Value Evaluator::allocateList(std::size_t size) {
+    if (size >= kListHeapWords || m_heapWords + size + 1 > kListHeapWords) stop(); // list_buffer plein
+    m_heapWords += size + 1;
+    return Value{Value::Kind::List, 0, nullptr, std::make_shared<List>(size)};
+}
+
+// Condition d'un if / while : liste ou chaîne vide selon le type statique, sinon valeur non nulle
+bool Evaluator::truth(const Value& value, ValueType type) const {
+    if (type == ValueType::List) {
+        if (value.kind != Value::Kind::List) stop();
+        return !value.list->empty();
+    }
+    if (type == ValueType::String) {
+        if (value.kind != Value::Kind::String) stop();
+        return !value.string->empty();
+    }
+    return value.kind != Value::Kind::Integer || value.integer != 0; // une adresse n'est jamais nulle
+}
+
+ValueType Evaluator::staticType(const ASTNode* node) {
+    return node ? node->type : ValueType::Auto;
+}
@@ -0,0 +1,250 @@
+#include "inliner.h"
+#include <algorithm>
+
+namespace {
+
+std::size_t countNodes(const ASTNode* node) {
+    if (!node) return 0;
+    std::size_t count = 1;
+    for (const ASTNode* child : node->children) count += countNodes(child);
+    return count;
+}
+
+// Argument recopiable à chaque occurrence du paramètre : rien à évaluer, aucun effet. Une variable
+// de l'appelant ne peut pas être réaffectée par l'expression (une fonction n'affecte que ses locaux).
+bool isPlainValue(const ASTNode* arg) {
+    switch (arg->kind) {
+        case NodeKind::Identifier: case NodeKind::Integer: case NodeKind::String:
+        case NodeKind::True: case NodeKind::False:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+void Inliner::run(ASTNode* root) {
+    m_inlined.clear();
+    m_growth = 0;
+    m_candidates.assign(m_callGraph.size(), Candidate{});
+    m_budget = std::max(kMinBudget, m_arena.nodeCount() / kBudgetShare);
+    if (!root || m_maxCalleeSize == 0) return;
+
+    Caller mainCaller;
+    mainCaller.name = "main";
+    mainCaller.scope = &m_globals;
+    for (ASTNode* child : root->children) {
+        if (!child) continue;
+        if (child->kind != NodeKind::Definitions) {
+            if (isBlock(child)) inlineBlock(child, mainCaller);
+            continue;
+        }
+        for (ASTNode* def : child->children) {
+            if (!def || def->kind != NodeKind::FunctionDefinition || def->children.size() < 2 || !def->children[1]) continue;
+            if (!m_callGraph.reachable(def->nameId)) continue; // ne sera pas générée
+            Caller caller;
+            caller.name = def->value;
+            if (!enterFunction(caller, m_globals, def)) continue;
+            inlineBlock(def->children[1], caller);
+        }
+    }
+}
+
+void Inliner::report(std::ostream& out) const {
+    for (const InlinedCall& call : m_inlined) {
+        out << "[inline] " << call.callee << " into " << call.caller << ", line " << call.line << ": "
+            << call.cost << " nodes";
+        if (call.temporaries) out << ", " << call.temporaries << (call.temporaries > 1 ? " temporaries" : " temporary");
+        out << "\n";
+    }
+    out << "[inline] " << m_inlined.size() << " call sites inlined, AST +" << m_growth << " nodes (budget "
+        << m_budget << ")" << std::endl;
+}
+
+const Inliner::Candidate& Inliner::candidate(std::size_t f) {
+    Candidate& callee = m_candidates[f];
+    if (callee.analysed) return callee;
+    callee.analysed = true;
+
+    // def f(params): return <expression>, hors de tout cycle d'appels
+    const ASTNode* def = m_callGraph.definition(f);
+    if (m_callGraph.recursive(f) || def->children.size() < 2) return callee;
+    const ASTNode* formals = def->children[0];
+    const ASTNode* body = def->children[1];
+    if (!formals || formals->kind != NodeKind::FormalParameterList) return callee;
+    if (!body || body->kind != NodeKind::FunctionBody || body->children.size() != 1) return callee;
+    const ASTNode* ret = body->children[0];
+    if (!ret || ret->kind != NodeKind::Return || ret->children.size() != 1 || !ret->children[0]) return callee;
+
+    callee.expression = ret->children[0];
+    callee.cost = countNodes(callee.expression);
+    const FunctionSymbol* function = symbolAs<FunctionSymbol>(m_globals.findImmediateSymbol(def->nameId));
+    callee.scope = function ? function->scope : nullptr;
+    if (!callee.scope || callee.cost > m_maxCalleeSize) return callee;
+
+    for (const ASTNode* param : formals->children) {
+        if (!param || std::find(callee.params.begin(), callee.params.end(), param->nameId) != callee.params.end()) return callee;
+        callee.params.push_back(param->nameId);
+    }
+    callee.uses.assign(callee.params.size(), 0);
+    callee.paramTypes.assign(callee.params.size(), ValueType::Auto);
+
+    std::vector<const ASTNode*> stack{callee.expression};
+    while (!stack.empty()) {
+        const ASTNode* node = stack.back();
+        stack.pop_back();
+        if (!node) continue;
+        if (node->kind == NodeKind::FunctionCall) {
+            if (node->children.empty() || !node->children[0]) return callee;
+            for (std::size_t i = 1; i < node->children.size(); ++i) stack.push_back(node->children[i]);
+            continue;
+        }
+        if (node->kind == NodeKind::Identifier) {
+            auto param = std::find(callee.params.begin(), callee.params.end(), node->nameId);
+            if (param != callee.params.end()) {
+                std::size_t i = static_cast<std::size_t>(param - callee.params.begin());
+                if (callee.uses[i]++ == 0) callee.paramTypes[i] = node->type;
+            } else if (!callee.scope->findSymbol(node->nameId)) {
+                return callee;
+            } else if (std::find(callee.freeNames.begin(), callee.freeNames.end(), node->nameId) == callee.freeNames.end()) {
+                callee.freeNames.push_back(node->nameId);
+            }
+            continue;
+        }
+        for (const ASTNode* child : node->children) stack.push_back(child);
+    }
+    callee.eligible = true;
+    return callee;
+}
+
+void Inliner::inlineBlock(ASTNode* block, Caller& caller) {
+    for (std::size_t i = 0; i < block->children.size(); ++i) {
+        ASTNode* statement = block->children[i];
+        if (!statement) continue;
+        if (isBlock(statement)) {
+            inlineBlock(statement, caller);
+            continue;
+        }
+
+        // Appel qui forme à lui seul la valeur de l'instruction : ses arguments peuvent passer par
+        // des temporaires affectées juste avant, dans l'ordre où l'appel les aurait évalués
+        auto whole = [&]() -> ASTNode*& {
+            if (statement->kind == NodeKind::Affect) return statement->children[1];
+            if (statement->kind == NodeKind::Return) return statement->children[0];
+            return block->children[i]; // l'insertion des temporaires peut déplacer le tableau
+        };
+        bool hasWhole = statement->kind == NodeKind::FunctionCall
+                        || (statement->kind == NodeKind::Affect && statement->children.size() > 1)
+                        || (statement->kind == NodeKind::Return && !statement->children.empty());
+        if (hasWhole && whole() && whole()->kind == NodeKind::FunctionCall) {
+            if (const NodeList* args = argumentsOf(whole())) {
+                for (ASTNode*& arg : *args) inlineExpression(arg, caller, 0);
+            }
+            if (inlineCall(whole(), caller, block, &i)) inlineExpression(whole(), caller, 1);
+            continue;
+        }
+
+        // La cible d'une affectation n'est pas visitée : pendant l'évaluation de l'indice, le
+        // générateur garde l'adresse de la liste dans rbx, qu'une fonction appelée préserve
+        for (std::size_t c = statement->kind == NodeKind::Affect ? 1 : 0; c < statement->children.size(); ++c) {
+            ASTNode*& child = statement->children[c];
+            if (!child) continue;
+            if (isBlock(child)) inlineBlock(child, caller);
+            else inlineExpression(child, caller, 0);
+        }
+    }
+}
+
+void Inliner::inlineExpression(ASTNode*& slot, Caller& caller, int depth) {
+    ASTNode* node = slot;
+    if (!node || depth > kMaxDepth) return;
+    for (ASTNode*& child : node->children) inlineExpression(child, caller, depth);
+    // La copie peut elle-même contenir des appels inlinables
+    if (node->kind == NodeKind::FunctionCall && inlineCall(slot, caller, nullptr, nullptr)) {
+        inlineExpression(slot, caller, depth + 1);
+    }
+}
+
+bool Inliner::inlineCall(ASTNode*& slot, Caller& caller, ASTNode* block, std::size_t* index) {
+    ASTNode* call = slot;
+    if (call->children.empty() || !call->children[0]) return false;
+    std::size_t f = m_callGraph.indexOf(call->children[0]->nameId);
+    if (f == CallGraph::npos) return false;
+    const Candidate& callee = candidate(f);
+    // La copie garde les types posés dans l'appelé : ils doivent être ceux de ce site
+    if (!callee.eligible || callee.expression->type != call->type) return false;
+    const NodeList* args = argumentsOf(call);
+    std::size_t argCount = args ? args->size() : 0;
+    if (argCount != callee.params.size()) return false;
+    for (Interner::Id name : callee.freeNames) {
+        if (caller.scope->findSymbol(name) != callee.scope->findSymbol(name)) return false;
+    }
+
+    std::vector<ASTNode*> values(argCount, nullptr);
+    std::vector<std::size_t> pending; // arguments à évaluer une fois, dans une temporaire
+    std::size_t plain = 0;
+    for (std::size_t i = 0; i < argCount; ++i) {
+        ASTNode* arg = (*args)[i];
+        if (!arg || (callee.uses[i] && arg->type != callee.paramTypes[i])) return false;
+        if (isPlainValue(arg)) {
+            values[i] = arg;
+            ++plain;
+        } else {
+            pending.push_back(i);
+        }
+    }
+    if (!pending.empty() && !block) return false;
+
+    // Modèle de coût : noeuds ajoutés (copie + affectations des temporaires) moins l'appel retiré.
+    // Une copie qui ne grossit pas l'AST est gratuite ; les autres consomment le budget.
+    std::size_t added = callee.cost + 2 * pending.size();
+    std::size_t removed = kCallNodes + plain;
+    if (added > removed) {
+        if (m_growth + (added - removed) > m_budget) return false;
+        m_growth += added - removed;
+    }
+
+    for (std::size_t n = 0; n < pending.size(); ++n) {
+        std::size_t i = pending[n];
+        values[i] = m_arena.makeName(NodeKind::Identifier, temporary(caller, n), call->line);
+        values[i]->type = (*args)[i]->type;
+    }
+    m_inlined.push_back(InlinedCall{std::string(call->children[0]->value), caller.name, call->line, callee.cost, pending.size()});
+    slot = substitute(callee.expression, callee, values);
+
+    // Arguments évalués du dernier au premier, comme les push de genFunctionCall
+    for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+        ASTNode* affect = m_arena.make(NodeKind::Affect, call->line, "=");
+        m_arena.append(affect, m_arena.clone(values[*it]));
+        m_arena.append(affect, (*args)[*it]);
+        m_arena.insert(block, (*index)++, affect);
+    }
+    return true;
+}
+
+// n-ième temporaire de l'appelant : un local de plus dans son cadre, ou une globale pour le programme principal
+Interner::Id Inliner::temporary(Caller& caller, std::size_t n) {
+    while (caller.temporaries.size() <= n) {
+        caller.temporaries.push_back(addTemporary(caller, m_arena.names(), "inl", m_nextTemporary));
+    }
+    return caller.temporaries[n];
+}
+
+ASTNode* Inliner::substitute(const ASTNode* node, const Candidate& callee, const std::vector<ASTNode*>& values) {
+    if (node->kind == NodeKind::Identifier) {
+        auto param = std::find(callee.params.begin(), callee.params.end(), node->nameId);
+        if (param != callee.params.end()) return m_arena.clone(values[static_cast<std::size_t>(param - callee.params.begin())]);
+    }
+    ASTNode* copy = m_arena.make(node->kind, node->line);
+    copy->type = node->type;
+    copy->nameId = node->nameId;
+    copy->value = node->value;
+    for (std::size_t i = 0; i < node->children.size(); ++i) {
+        const ASTNode* child = node->children[i];
+        if (!child) m_arena.append(copy, nullptr);
+        else if (node->kind == NodeKind::FunctionCall && i == 0) m_arena.append(copy, m_arena.clone(child)); // nom de l'appelé
+        else m_arena.append(copy, substitute(child, callee, values));
+    }
+    return copy;
+}
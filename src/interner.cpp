@@ -0,0 +1,16 @@
+#include "interner.h"
+
+Interner::Id Interner::intern(std::string_view name) {
+    auto it = m_ids.find(name);
+    if (it != m_ids.end()) return it->second;
+
+    Id id = static_cast<Id>(m_names.size());
+    const std::string& stored = m_names.emplace_back(name);
+    m_ids.emplace(std::string_view(stored), id);
+    return id;
+}
+
+Interner::Id Interner::find(std::string_view name) const {
+    auto it = m_ids.find(name);
+    return it == m_ids.end() ? kNoId : it->second;
+}
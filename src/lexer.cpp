@@ -7,8 +7,8 @@
 #include <cstdlib>
 
 /* Constructor for Lexer with keyword, operator, and bracket initialization */
-Lexer::Lexer(std::string src, ErrorManager& errorManager) 
-    : m_src(std::move(src)), m_errorManager(errorManager) {
+Lexer::Lexer(std::string src, ErrorManager& errorManager, Interner& names) 
+    : m_src(std::move(src)), m_errorManager(errorManager), m_names(names) {
     m_keywords = {
         {"and", TokenType::KW_AND}, {"def", TokenType::KW_DEF},
         {"else", TokenType::KW_ELSE}, {"for", TokenType::KW_FOR},
@@ -110,7 +110,7 @@ void Lexer::handleIdentifierOrKeyword(std::vector<Token>& tokens, std::string& b
     if (m_keywords.contains(buffer)) {
         tokens.push_back({.type = m_keywords[buffer], .value = buffer, .line = m_line});
     } else {
-        tokens.push_back({.type = TokenType::IDF, .value = buffer, .line = m_line});
+        tokens.push_back({.type = TokenType::IDF, .value = buffer, .line = m_line, .id = m_names.intern(buffer)});
     }
     buffer.clear();
 }
@@ -0,0 +1,193 @@
+#include "loopInvariantMotion.h"
+#include <algorithm>
+
+void LoopInvariantMotion::run(ASTNode* root) {
+    m_hoisted = 0;
+    m_loops = 0;
+    if (!root) return;
+    m_pure = analysePurity(m_globals, m_callGraph);
+
+    Unit mainUnit;
+    mainUnit.scope = &m_globals;
+    for (ASTNode* child : root->children) {
+        if (!child) continue;
+        if (child->kind != NodeKind::Definitions) {
+            if (isBlock(child)) walk(child, mainUnit);
+            continue;
+        }
+        for (ASTNode* def : child->children) {
+            if (!def || def->kind != NodeKind::FunctionDefinition || def->children.size() < 2 || !def->children[1]) continue;
+            if (!m_callGraph.reachable(def->nameId)) continue; // ne sera pas générée
+            Unit unit;
+            if (!enterFunction(unit, m_globals, def)) continue;
+            walk(def->children[1], unit);
+        }
+    }
+}
+
+// Boucles internes d'abord : leur en-tête fait partie du corps de la boucle englobante
+void LoopInvariantMotion::walk(ASTNode* block, Unit& unit) {
+    for (std::size_t i = 0; i < block->children.size(); ++i) {
+        ASTNode* statement = block->children[i];
+        if (!statement) continue;
+        NodeList& children = statement->children;
+        if (isBlock(statement)) {
+            walk(statement, unit);
+        } else if (statement->kind == NodeKind::If) {
+            for (std::size_t b = 1; b < children.size(); ++b) {
+                if (children[b]) walk(children[b], unit);
+            }
+        } else if (statement->kind == NodeKind::While) {
+            if (children.size() > 1 && children[1]) walk(children[1], unit);
+            hoistFrom(statement, block, unit);
+        } else if (statement->kind == NodeKind::For) {
+            if (children.size() > 2 && children[2]) walk(children[2], unit);
+            hoistFrom(statement, block, unit);
+        }
+        // L'en-tête inséré avant la boucle l'a décalée
+        while (block->children[i] != statement) ++i;
+    }
+}
+
+void LoopInvariantMotion::hoistFrom(ASTNode* statement, ASTNode* block, Unit& unit) {
+    Loop loop;
+    loop.block = block;
+    loop.statement = statement;
+    collectWrites(statement, m_callGraph, m_pure, loop.effects);
+    NodeList& children = statement->children;
+    if (statement->kind == NodeKind::While) {
+        Context context;
+        context.guaranteed = true;
+        if (!children.empty()) visitExpression(children[0], loop, context, unit);
+        if (children.size() > 1 && children[1]) visitBody(children[1], loop, unit);
+    } else if (children.size() > 2 && children[2]) {
+        // L'itérable d'un for n'est évalué qu'une fois
+        visitBody(children[2], loop, unit);
+    }
+}
+
+void LoopInvariantMotion::visitBody(ASTNode* block, Loop& loop, Unit& unit) {
+    for (std::size_t i = 0; i < block->children.size();) {
+        ASTNode* statement = block->children[i];
+        if (!statement) {
+            ++i;
+            continue;
+        }
+        // En-tête d'une boucle interne, invariant ici aussi : il remonte tel quel
+        if (statement->kind == NodeKind::Affect && statement->children.size() == 2 && statement->children[0]
+            && statement->children[0]->kind == NodeKind::Identifier && m_ownTemporaries.count(statement->children[0]->nameId)
+            && isInvariant(statement->children[1], loop.effects) && !mayFail(statement->children[1])) {
+            block->children.erase(i);
+            insertBefore(loop, statement);
+            ++m_hoisted;
+            continue;
+        }
+        visitStatement(statement, loop, unit);
+        ++i;
+    }
+}
+
+void LoopInvariantMotion::visitStatement(ASTNode* statement, Loop& loop, Unit& unit) {
+    if (isBlock(statement)) {
+        visitBody(statement, loop, unit);
+        return;
+    }
+    Context context;
+    NodeList& children = statement->children;
+    switch (statement->kind) {
+    case NodeKind::Affect:
+        if (children.size() < 2) return;
+        visitExpression(children[1], loop, context, unit);
+        // Cible L[i] : seul l'indice se calcule
+        if (children[0] && children[0]->kind == NodeKind::ListCall && children[0]->children.size() == 2) {
+            visitExpression(children[0]->children[1], loop, context, unit);
+        }
+        return;
+    case NodeKind::Print: case NodeKind::Return:
+        for (ASTNode*& expression : children) visitExpression(expression, loop, context, unit);
+        return;
+    case NodeKind::If: case NodeKind::While:
+        if (!children.empty()) visitExpression(children[0], loop, context, unit);
+        for (std::size_t b = 1; b < children.size(); ++b) {
+            if (children[b]) visitBody(children[b], loop, unit);
+        }
+        return;
+    case NodeKind::For: {
+        if (children.size() < 3 || !children[1]) return;
+        ASTNode* iterable = children[1];
+        const NodeList* rangeArgs = isCallTo(iterable, "range") ? argumentsOf(iterable) : nullptr;
+        if (rangeArgs) {
+            // range(len(L)) : rien à sortir, le générateur n'évalue pas len(L)
+            if (!isIndexRange(iterable)) {
+                for (ASTNode*& argument : *rangeArgs) visitExpression(argument, loop, context, unit);
+            }
+        } else {
+            visitExpression(children[1], loop, context, unit);
+        }
+        if (children[2]) visitBody(children[2], loop, unit);
+        return;
+    }
+    default: {
+        // Expression utilisée comme instruction (appel)
+        ASTNode* expression = statement;
+        visitExpression(expression, loop, context, unit);
+        return;
+    }
+    }
+}
+
+void LoopInvariantMotion::visitExpression(ASTNode*& slot, Loop& loop, Context& context, Unit& unit) {
+    ASTNode* node = slot;
+    if (!node) return;
+
+    if (isReusableExpression(node) && isInvariant(node, loop.effects)) {
+        std::string key;
+        structureKey(node, key);
+        auto it = loop.temporaries.find(key);
+        bool evaluated = context.guaranteed && context.clean && !context.conditional;
+        if (it == loop.temporaries.end() && (evaluated || !mayFail(node))) {
+            Interner::Id name = addTemporary(unit, m_arena.names(), "inv", m_nextTemporary);
+            m_ownTemporaries.insert(name);
+            ASTNode* target = m_arena.makeName(NodeKind::Identifier, name, node->line);
+            target->type = node->type;
+            ASTNode* assign = m_arena.make(NodeKind::Affect, node->line);
+            m_arena.append(assign, target);
+            m_arena.append(assign, node);
+            insertBefore(loop, assign);
+            it = loop.temporaries.emplace(std::move(key), name).first;
+            ++m_hoisted;
+        }
+        if (it != loop.temporaries.end()) {
+            ASTNode* read = m_arena.makeName(NodeKind::Identifier, it->second, node->line);
+            read->type = node->type;
+            slot = read;
+            return;
+        }
+    }
+
+    forEachOperand(node, [&](ASTNode*& operand, bool conditional) {
+        bool outer = context.conditional;
+        context.conditional = outer || conditional;
+        visitExpression(operand, loop, context, unit);
+        context.conditional = outer;
+    });
+
+    if (mayPrintOrStop(node)) context.clean = false;
+}
+
+void LoopInvariantMotion::insertBefore(Loop& loop, ASTNode* assign) {
+    const NodeList& statements = loop.block->children;
+    std::size_t index = static_cast<std::size_t>(std::find(statements.begin(), statements.end(), loop.statement) - statements.begin());
+    m_arena.insert(loop.block, index, assign);
+    if (!loop.preheader) {
+        loop.preheader = true;
+        ++m_loops;
+    }
+}
+
+bool LoopInvariantMotion::isInvariant(const ASTNode* node, const Effects& effects) const {
+    std::string key;
+    Accesses reads;
+    structureKey(node, key, &reads);
+    return !changes(effects, reads);
+}
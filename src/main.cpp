@@ -2,24 +2,102 @@
 #include <fstream>
 #include <sstream>
 #include <cstdlib>
+#include <chrono>
+#include <cstring>
+#include <sys/resource.h>
 #include "lexer.h"
 #include "parser.h"
 #include "errorManager.h"
 #include "symbolTable.h"
 #include "semanticAnalyzer.h"
+#include "typeAnnotator.h"
+#include "callGraph.h"
+#include "constantFolder.h"
+#include "inliner.h"
+#include "partialEvaluator.h"
+#include "loopInvariantMotion.h"
+#include "valueNumbering.h"
 #include "codeGenerator.h"
+#include "runtime.h"
+#include "threadPool.h"
 
 #define BOLD "\033[1m"
 #define RESET "\033[0m"
 
 
+// Chronomètre des phases, affiché avec --stats
+struct PhaseTimer {
+    bool enabled = false;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    void lap(const char* phase) {
+        auto now = std::chrono::steady_clock::now();
+        if (enabled) {
+            std::cerr << "[stats] " << phase << ": "
+                      << std::chrono::duration<double, std::milli>(now - start).count() << " ms" << std::endl;
+        }
+        start = std::chrono::steady_clock::now();
+    }
+};
+
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <file>" << std::endl;
+    PhaseTimer timer;
+    const char* inputPath = nullptr;
+    bool badUsage = false;
+    unsigned jobs = ThreadPool::defaultThreads();
+    RuntimeLinkage runtimeLinkage = RuntimeLinkage::Inline;
+    const char* runtimePath = nullptr;
+    std::size_t inlineSize = 16;
+    bool inlineReport = false;
+    std::size_t foldSteps = Evaluator::Limits{}.steps;
+    bool foldReport = false;
+    bool partialEval = false;
+    std::size_t evalFuel = 1000000;
+    UnrollLimits unroll;
+    bool vectorize = true;
+    bool branchless = true;
+    bool loopInvariantMotion = true;
+    bool valueNumbering = true;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--stats") == 0) timer.enabled = true;
+        else if (std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) jobs = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--runtime-lib") == 0) runtimeLinkage = RuntimeLinkage::Library;
+        else if (std::strcmp(argv[i], "--emit-runtime") == 0 && i + 1 < argc) runtimePath = argv[++i];
+        else if (std::strcmp(argv[i], "--inline-size") == 0 && i + 1 < argc) inlineSize = static_cast<std::size_t>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--inline-report") == 0) inlineReport = true;
+        else if (std::strcmp(argv[i], "--fold-steps") == 0 && i + 1 < argc) foldSteps = static_cast<std::size_t>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--fold-report") == 0) foldReport = true;
+        else if (std::strcmp(argv[i], "--partial-eval") == 0) partialEval = true;
+        else if (std::strcmp(argv[i], "--eval-fuel") == 0 && i + 1 < argc) evalFuel = static_cast<std::size_t>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--no-licm") == 0) loopInvariantMotion = false;
+        else if (std::strcmp(argv[i], "--unroll-factor") == 0 && i + 1 < argc) unroll.factor = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--unroll-size") == 0 && i + 1 < argc) unroll.maxSize = static_cast<std::size_t>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--no-vectorize") == 0) vectorize = false;
+        else if (std::strcmp(argv[i], "--no-cmov") == 0) branchless = false;
+        else if (std::strcmp(argv[i], "--no-cse") == 0) valueNumbering = false;
+        else if (!inputPath) inputPath = argv[i];
+        else badUsage = true;
+    }
+
+    // Source de la bibliothèque pyasm_rt (cible CMake du même nom)
+    if (runtimePath && !inputPath && !badUsage) {
+        try {
+            FileSink sink(runtimePath);
+            emitRuntimeLibrary(sink);
+            sink.close();
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+    if (!inputPath || badUsage) {
+        std::cerr << "Usage: " << argv[0] << " [--stats] [--jobs N] [--runtime-lib] [--inline-size N] [--inline-report] [--fold-steps N] [--fold-report] [--partial-eval] [--eval-fuel N] [--no-licm] [--no-cse] [--unroll-factor N] [--unroll-size N] [--no-vectorize] [--no-cmov] <file>" << std::endl;
+        std::cerr << "       " << argv[0] << " --emit-runtime <file.asm>" << std::endl;
         return EXIT_FAILURE;
     }
 
-    std::ifstream srcFile(argv[1]);
+    std::ifstream srcFile(inputPath);
     if (!srcFile) {
         std::cerr << "Error reading source file" << std::endl;
         return EXIT_FAILURE;
@@ -29,30 +107,48 @@ int main(int argc, char* argv[]) {
 
     std::stringstream srcStream;
     srcStream << srcFile.rdbuf();
-    Lexer lexer(srcStream.str(), errorManager);
+    // Noms internés (dès le lexer) et noeuds de l'AST vivent jusqu'à la fin de la compilation
+    Interner names;
+    ASTArena arena(names);
+    Lexer lexer(srcStream.str(), errorManager, names);
 
     try {
         auto tokens = lexer.tokenize();
-        Parser parser(tokens, errorManager);
+        timer.lap("lexer");
+        Parser parser(tokens, errorManager, arena);
         auto ast = parser.parse();
         if (!ast) {
             std::cerr << "Failed to parse input." << std::endl;
             return EXIT_FAILURE;
         }
+        timer.lap("parser");
+        if (timer.enabled) {
+            std::cerr << "[stats] ast: " << arena.nodeCount() << " nodes, "
+                      << arena.bytesUsed() / 1024 << " KiB used / " << arena.bytesReserved() / 1024 << " KiB reserved, "
+                      << names.size() << " interned names" << std::endl;
+        }
         parser.generateDotFile(ast, "ast.dot");
         //std::cout << "Abstract Syntax Tree:" << std::endl;
         //parser.print(ast);
 
 
-        SemanticAnalyzer semAnalyzer(errorManager);
+        SemanticAnalyzer semAnalyzer(errorManager, arena);
         ast = semAnalyzer.firstPass(ast);
         parser.generateDotFile(ast, "ast2.dot");
+        timer.lap("dot + firstPass");
 
 
-        SymbolTableGenerator symGen(errorManager);
+        SymbolTableGenerator symGen(errorManager, arena);
         std::cout << "CAME HERE" << std::endl;
         auto symTable = symGen.generate(ast);
         std::cout << "CAME HERE" << std::endl;
+        timer.lap("symbol table");
+        if (timer.enabled) {
+            const InferenceStats& inference = symGen.inferenceStats();
+            std::cerr << "[stats] type inference: " << inference.iterations << " iterations for "
+                      << inference.statements << " statements, " << inference.specializations << " specializations, "
+                      << inference.milliseconds << " ms" << std::endl;
+        }
 
         // 1) Check for lexical/syntax errors or Symbol Table generation errors
         if (errorManager.hasErrors()) {
@@ -61,6 +157,7 @@ int main(int argc, char* argv[]) {
         }
         // 2) Launch semantic analysis
         semAnalyzer.checkSemantics(ast, symTable.get());
+        timer.lap("semantic analysis");
         // 3) Check for semantic errors
         if (errorManager.hasErrors()) {
             std::cout << std::endl;
@@ -71,10 +168,112 @@ int main(int argc, char* argv[]) {
         std::cout << BOLD << "\nSymbol Table:" << RESET << std::endl;
         symTable->print(std::cout);
 
+        // --- Typing Phase: one ValueType per node, read by the code generator ---
+        TypeAnnotator typeAnnotator(errorManager);
+        typeAnnotator.annotate(ast, symTable.get());
+        timer.lap("typing");
+        if (timer.enabled) {
+            std::cerr << "[stats] typing: " << typeAnnotator.annotatedNodes() << " nodes annotated" << std::endl;
+        }
+
+        // --- Call graph: functions reachable from the main program ---
+        CallGraph callGraph;
+        callGraph.build(ast);
+        timer.lap("call graph");
+        if (timer.enabled) {
+            std::cerr << "[stats] call graph: " << callGraph.size() << " functions, " << callGraph.reachableCount()
+                      << " reachable, " << callGraph.recursiveCount() << " recursive" << std::endl;
+        }
+
+        // --- Partial evaluation: the main program runs in the compiler as far as the fuel allows ---
+        std::string prerenderedOutput;
+        if (!errorManager.hasErrors() && partialEval) {
+            PartialEvaluator evaluator(arena, *symTable, callGraph);
+            evaluator.setFuel(evalFuel);
+            evaluator.run(ast);
+            prerenderedOutput = evaluator.output();
+            // Functions only called by the evaluated statements are no longer reachable
+            if (evaluator.executed() > 0) callGraph.build(ast);
+            timer.lap("partial evaluation");
+            if (timer.enabled) {
+                std::cerr << "[stats] partial evaluation: " << evaluator.executed() << " of " << evaluator.statements()
+                          << " statements, " << evaluator.steps() << " steps, " << prerenderedOutput.size()
+                          << " bytes of output, " << evaluator.materialized() << " globals restored" << std::endl;
+            }
+        }
+
+        // --- Compile-time evaluation of pure calls with constant arguments ---
+        if (!errorManager.hasErrors() && foldSteps > 0) {
+            ConstantFolder folder(arena, *symTable, callGraph);
+            Evaluator::Limits limits;
+            limits.steps = foldSteps;
+            folder.setLimits(limits);
+            folder.run(ast);
+            if (foldReport) folder.report(std::cerr);
+            // Functions only called with constant arguments are no longer reachable
+            if (!folder.folded().empty()) callGraph.build(ast);
+            timer.lap("constant folding");
+            if (timer.enabled) {
+                std::cerr << "[stats] constant folding: " << folder.folded().size() << " calls, " << folder.pureCount()
+                          << " pure functions, " << folder.steps() << " evaluation steps" << std::endl;
+            }
+        }
+
+        // --- Inlining of small non-recursive functions (the typed AST must be sound) ---
+        if (!errorManager.hasErrors()) {
+            Inliner inliner(arena, *symTable, callGraph);
+            inliner.setMaxCalleeSize(inlineSize);
+            inliner.run(ast);
+            if (inlineReport) inliner.report(std::cerr);
+            // Functions whose every call was inlined are no longer reachable
+            if (!inliner.inlined().empty()) callGraph.build(ast);
+            timer.lap("inlining");
+            if (timer.enabled) {
+                std::cerr << "[stats] inlining: " << inliner.inlined().size() << " call sites, AST +" << inliner.growth()
+                          << " nodes (budget " << inliner.budget() << "), " << callGraph.reachableCount()
+                          << " functions still reachable" << std::endl;
+            }
+        }
+
+        // --- Loop-invariant code motion ---
+        if (!errorManager.hasErrors() && loopInvariantMotion) {
+            LoopInvariantMotion motion(arena, *symTable, callGraph);
+            motion.run(ast);
+            timer.lap("loop-invariant code motion");
+            if (timer.enabled) {
+                std::cerr << "[stats] loop-invariant code motion: " << motion.hoisted() << " expressions hoisted out of "
+                          << motion.loops() << " loops" << std::endl;
+            }
+        }
+
+        // --- Common subexpression elimination (value numbering) ---
+        if (!errorManager.hasErrors() && valueNumbering) {
+            ValueNumbering numbering(arena, *symTable, callGraph);
+            numbering.run(ast);
+            timer.lap("value numbering");
+            if (timer.enabled) {
+                std::cerr << "[stats] value numbering: " << numbering.temporaries() << " values kept in temporaries, "
+                          << numbering.reused() << " recomputations removed" << std::endl;
+            }
+        }
+
         // --- Code Generation Phase ---
         CodeGenerator codeGen(errorManager);
+        codeGen.setJobs(jobs);
+        codeGen.setRuntimeLinkage(runtimeLinkage);
+        codeGen.setCallGraph(&callGraph);
+        codeGen.setUnrolling(unroll);
+        codeGen.setVectorize(vectorize);
+        codeGen.setBranchless(branchless);
+        codeGen.setPrerenderedOutput(std::move(prerenderedOutput));
         // Generate the assembly code and write it to "output.asm"
         codeGen.generateCode(ast, "output.asm", symTable.get());
+        timer.lap("code generation");
+        if (timer.enabled) {
+            rusage usage{};
+            getrusage(RUSAGE_SELF, &usage);
+            std::cerr << "[stats] peak memory: " << usage.ru_maxrss << " KiB" << std::endl;
+        }
         if (errorManager.hasErrors()) {
             std::cout << std::endl;
             errorManager.displayErrors();
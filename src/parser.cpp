@@ -1,31 +1,34 @@
 #include "parser.h"
+#include <array>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 
 
-Parser::Parser(const std::vector<Token>& tokens, ErrorManager& errorManager) 
-    : tokens(tokens), m_errorManager(errorManager), pos(0) {}
+Parser::Parser(const std::vector<Token>& tokens, ErrorManager& errorManager, ASTArena& arena) 
+    : tokens(tokens), m_errorManager(errorManager), m_arena(arena), pos(0) {}
 
-std::shared_ptr<ASTNode> Parser::parse() {
+ASTNode* Parser::parse() {
     return parseRoot();
 }
 
-void Parser::print(const std::shared_ptr<ASTNode>& node, int depth) {
+void Parser::print(ASTNode* node, int depth) {
     if (!node) return;
-    std::cout << std::string(depth * 2, ' ') << node->type;
+    std::cout << std::string(depth * 2, ' ') << nodeKindName(node->kind);
     if (!node->value.empty()) std::cout << ": " << node->value;
     std::cout << std::endl;
     for (const auto& child : node->children) print(child, depth + 1);
 }
 
-Token Parser::peek() {
+static const Token kEndOfFile{TokenType::ENDOFFILE, "", 0};
+
+const Token& Parser::peek() const {
     if ( ((unsigned long)pos) < tokens.size()) return tokens[pos];
-    return {TokenType::ENDOFFILE, ""};
+    return kEndOfFile;
 }
 
-Token Parser::next() {
-    return ((unsigned long)pos) < tokens.size() ? tokens[pos++] : Token{TokenType::ENDOFFILE, ""};
+const Token& Parser::next() {
+    return ((unsigned long)pos) < tokens.size() ? tokens[pos++] : kEndOfFile;
 }
 
 bool Parser::expect(TokenType type) {
@@ -48,6 +51,15 @@ void Parser::skipNewlines() {
     while (peek().type == TokenType::NEWLINE) next();
 }
 
+ASTNode* Parser::makeNode(NodeKind kind, int line, std::string_view value) {
+    return m_arena.make(kind, line, value);
+}
+
+ASTNode* Parser::identifier(const Token& tok) {
+    if (tok.id != Interner::kNoId) return m_arena.makeName(NodeKind::Identifier, tok.id, tok.line);
+    return m_arena.makeName(NodeKind::Identifier, tok.value, tok.line);
+}
+
 void Parser::continueParsing(){
     while (peek().type != TokenType::ENDOFFILE && peek().type != TokenType::NEWLINE) {
         next();
@@ -73,17 +85,17 @@ void Parser::continueParsing(){
 // S -> stmt S .
 // S -> .
 // et un peu plus de tolérance avec les NEWLINES en trop que ce qui est rigoureusement spécifié dans la grammaire
-std::shared_ptr<ASTNode> Parser::parseRoot() {
-    auto root = std::make_shared<ASTNode>("Program");
-    auto DEF = std::make_shared<ASTNode>("Definitions");
-    root->children.push_back(DEF);
-    auto OP = std::make_shared<ASTNode>("Instructions");
-    root->children.push_back(OP);
+ASTNode* Parser::parseRoot() {
+    auto root = makeNode(NodeKind::Program, 0);
+    auto DEF = makeNode(NodeKind::Definitions, 0);
+    add(root, DEF);
+    auto OP = makeNode(NodeKind::Instructions, 0);
+    add(root, OP);
 
     skipNewlines();
     auto def = parseDefinition();
     while ( def != nullptr ) {
-        DEF->children.push_back(def);
+        add(DEF, def);
         skipNewlines();
         def = parseDefinition();
     }
@@ -93,7 +105,7 @@ std::shared_ptr<ASTNode> Parser::parseRoot() {
     while (peek().type != TokenType::ENDOFFILE and old_pos < pos) {
         old_pos = pos;
         auto expr = parseStmt();
-        if (expr) OP->children.push_back(expr);
+        if (expr) add(OP, expr);
         skipNewlines();
     }
 
@@ -121,42 +133,39 @@ std::shared_ptr<ASTNode> Parser::parseRoot() {
 // I-> .
 // I_prime -> "," ident I_prime .
 // I_prime -> .
-std::shared_ptr<ASTNode> Parser::parseDefinition() {
+ASTNode* Parser::parseDefinition() {
     if (expect(TokenType::KW_DEF)) {
         auto tok = peek();
-        auto def_root = std::make_shared<ASTNode>("FunctionDefinition", tok.value);
-        def_root->line = std::to_string(tok.line);
+        auto def_root = tok.id != Interner::kNoId ? m_arena.makeName(NodeKind::FunctionDefinition, tok.id, tok.line)
+                                                  : m_arena.makeName(NodeKind::FunctionDefinition, tok.value, tok.line);
         if (tok.value == "list" || tok.value == "len" || tok.value == "range" || tok.value == "print") {
             m_errorManager.addError(Error{"Function name cannot be list, len, range or print (reserved names). Got: ", tok.value, "Semantic", tok.line});
         }
         expectR(TokenType::IDF);
         expectR(TokenType::CAR_LPAREN);
-        auto formal_param_list = std::make_shared<ASTNode>("FormalParameterList");
-        formal_param_list->line = std::to_string(peek().line); 
+        auto formal_param_list = makeNode(NodeKind::FormalParameterList, peek().line); 
         tok = peek();
         if (expect(TokenType::IDF)) {
-            auto idNode = std::make_shared<ASTNode>("Identifier", tok.value);
-            idNode->line = std::to_string(tok.line);
-            formal_param_list->children.push_back(idNode); 
+            auto idNode = identifier(tok);
+            add(formal_param_list, idNode); 
             while (expect(TokenType::CAR_COMMA)) {
                 tok = peek();
                 expectR(TokenType::IDF);
-                auto paramNode = std::make_shared<ASTNode>("Identifier", tok.value);
-                paramNode->line = std::to_string(tok.line);
-                formal_param_list->children.push_back(paramNode);
+                auto paramNode = identifier(tok);
+                add(formal_param_list, paramNode);
             }
         }
         expectR(TokenType::CAR_RPAREN);
         expectR(TokenType::CAR_COLON);
-        def_root->children.push_back(formal_param_list);
+        add(def_root, formal_param_list);
 
         auto [defs,suite] = parseSuiteDef();
-        defs->line = std::to_string(peek().line);
-        defs->type = "Definitions";
-        def_root->children.push_back(defs);
-        suite->line = std::to_string(peek().line); // because of the news definitions, this value is incorrect, but i don't think it's used anyways so...
-        suite->type = "FunctionBody";
-        def_root->children.push_back(suite);
+        defs->line = peek().line;
+        defs->kind = NodeKind::Definitions;
+        add(def_root, defs);
+        suite->line = peek().line; // because of the news definitions, this value is incorrect, but i don't think it's used anyways so...
+        suite->kind = NodeKind::FunctionBody;
+        add(def_root, suite);
 
         return def_root;
     }
@@ -168,9 +177,9 @@ std::shared_ptr<ASTNode> Parser::parseDefinition() {
 // suite_def -> NEWLINE BEGIN D stmt S END .
 // toute la différence avec parseSuite tient dans ce petit D 
 // idem, plus de tolérance pour les newlines que ce qui est rigoureusement spécifié
-std::pair<std::shared_ptr<ASTNode>, std::shared_ptr<ASTNode>> Parser::parseSuiteDef() {
-    auto suite_root = std::make_shared<ASTNode>("");
-    auto DEF = std::make_shared<ASTNode>("");
+std::pair<ASTNode*, ASTNode*> Parser::parseSuiteDef() {
+    auto suite_root = makeNode(NodeKind::Suite, 0);
+    auto DEF = makeNode(NodeKind::Suite, 0);
     if (expect(TokenType::NEWLINE)) {
         skipNewlines();
         expectR(TokenType::BEGIN);
@@ -178,7 +187,7 @@ std::pair<std::shared_ptr<ASTNode>, std::shared_ptr<ASTNode>> Parser::parseSuite
         skipNewlines();
         auto def = parseDefinition();
         while ( def != nullptr ) {
-            DEF->children.push_back(def);
+            add(DEF, def);
             skipNewlines();
             def = parseDefinition();
         }
@@ -188,13 +197,13 @@ std::pair<std::shared_ptr<ASTNode>, std::shared_ptr<ASTNode>> Parser::parseSuite
         while (peek().type != TokenType::END and old_pos < pos) {
             old_pos = pos;
             auto expr = parseStmt();
-            if (expr) suite_root->children.push_back(expr);
+            if (expr) add(suite_root, expr);
             skipNewlines();
         }
         expectR(TokenType::END);
     }
     else {
-        suite_root->children.push_back(parseSimpleStmt());
+        add(suite_root, parseSimpleStmt());
         if (!expect(TokenType::NEWLINE)) {
             m_errorManager.addError(Error{"Expected newline", "", "Syntax", peek().line});
             continueParsing();
@@ -206,8 +215,8 @@ std::pair<std::shared_ptr<ASTNode>, std::shared_ptr<ASTNode>> Parser::parseSuite
 // suite -> simple_stmt NEWLINE .
 // suite -> NEWLINE BEGIN stmt S END .
 // idem, plus de tolérance pour les newlines que ce qui est rigoureusement spécifié
-std::shared_ptr<ASTNode> Parser::parseSuite() {
-    auto suite_root = std::make_shared<ASTNode>("");
+ASTNode* Parser::parseSuite() {
+    auto suite_root = makeNode(NodeKind::Suite, 0);
     if (expect(TokenType::NEWLINE)) {
         skipNewlines();
         expectR(TokenType::BEGIN);
@@ -216,13 +225,13 @@ std::shared_ptr<ASTNode> Parser::parseSuite() {
         while (peek().type != TokenType::END and old_pos < pos) {
             old_pos = pos;
             auto expr = parseStmt();
-            if (expr) suite_root->children.push_back(expr);
+            if (expr) add(suite_root, expr);
             skipNewlines();
         }
         expectR(TokenType::END);
     }
     else {
-        suite_root->children.push_back(parseSimpleStmt());
+        add(suite_root, parseSimpleStmt());
         if (!expect(TokenType::NEWLINE)) {
             m_errorManager.addError(Error{"Expected newline", "", "Syntax", peek().line});
             continueParsing();
@@ -231,99 +240,227 @@ std::shared_ptr<ASTNode> Parser::parseSuite() {
     return suite_root;
 }
 
+// Table des opérateurs binaires, indexée par TokenType (precedence 0 = pas un opérateur binaire).
+// Les niveaux reprennent la grammaire : or_expr < and_expr < comp_expr < arith_expr < term.
+namespace {
+
+struct BinaryOp {
+    NodeKind kind = NodeKind::Or;
+    std::uint8_t precedence = 0;
+    bool nonAssociative = false;   // comp_expr -> arith_expr comp_op arith_expr : pas de a < b < c
+};
+
+constexpr std::uint8_t kPrefixPrecedence = 6;   // "-" et "not" ne portent que sur un primary
+constexpr int kMaxExprDepth = 3000;             // imbrication d'appels/listes/indices (les parenthèses ne récursent pas)
+
+constexpr auto kBinaryOps = [] {
+    std::array<BinaryOp, static_cast<std::size_t>(TokenType::END) + 1> table{};
+    auto set = [&table](TokenType type, NodeKind kind, std::uint8_t precedence, bool nonAssociative = false) {
+        table[static_cast<std::size_t>(type)] = BinaryOp{kind, precedence, nonAssociative};
+    };
+    set(TokenType::KW_OR, NodeKind::Or, 1);
+    set(TokenType::KW_AND, NodeKind::And, 2);
+    set(TokenType::OP_EQ_EQ, NodeKind::Compare, 3, true);
+    set(TokenType::OP_NEQ, NodeKind::Compare, 3, true);
+    set(TokenType::OP_LE, NodeKind::Compare, 3, true);
+    set(TokenType::OP_GE, NodeKind::Compare, 3, true);
+    set(TokenType::OP_LE_EQ, NodeKind::Compare, 3, true);
+    set(TokenType::OP_GE_EQ, NodeKind::Compare, 3, true);
+    set(TokenType::OP_EQ, NodeKind::Compare, 3, true);      // "=" au lieu de "==" : erreur puis reprise
+    set(TokenType::OP_PLUS, NodeKind::ArithOp, 4);
+    set(TokenType::OP_MINUS, NodeKind::ArithOp, 4);
+    set(TokenType::OP_MUL, NodeKind::TermOp, 5);
+    set(TokenType::OP_DIV, NodeKind::TermOp, 5);
+    set(TokenType::OP_MOD, NodeKind::TermOp, 5);
+    return table;
+}();
+
+constexpr const BinaryOp& binaryOp(TokenType type) {
+    return kBinaryOps[static_cast<std::size_t>(type)];
+}
+
+static_assert(binaryOp(TokenType::OP_MUL).precedence > binaryOp(TokenType::OP_PLUS).precedence);
+static_assert(binaryOp(TokenType::OP_PLUS).precedence > binaryOp(TokenType::OP_LE).precedence);
+static_assert(binaryOp(TokenType::OP_LE).precedence > binaryOp(TokenType::KW_AND).precedence);
+static_assert(binaryOp(TokenType::KW_AND).precedence > binaryOp(TokenType::KW_OR).precedence);
+static_assert(kPrefixPrecedence > binaryOp(TokenType::OP_MUL).precedence);
+
+} // namespace
+
 // expr -> or_expr .
-std::shared_ptr<ASTNode> Parser::parseExpr() {
-    return parseOrExpr();
+ASTNode* Parser::parseExpr() {
+    if (m_exprDepth >= kMaxExprDepth) {
+        m_errorManager.addError(Error{"Expression nested too deeply", "", "Syntax", peek().line});
+        continueParsing();
+        return nullptr;
+    }
+    ++m_exprDepth;
+    auto expr = parseBinaryExpr(nullptr);
+    --m_exprDepth;
+    return expr;
 }
 
-// primary -> const . || ident expr_prime . || ( expr ) . || [ e ] . || not primary .
-std::shared_ptr<ASTNode> Parser::parsePrimary() {
-    Token tok = peek();
+// Précédence par escalade, avec piles explicites au lieu de la chaîne
+// or_expr -> and_expr -> comp_expr -> arith_expr -> term -> factor -> primary.
+// Les parenthèses sont des marqueurs dans la pile d'opérateurs : aucune récursion par niveau.
+// Si first est fourni (simple_stmt -> ident test), l'analyse reprend juste après cet opérande.
+ASTNode* Parser::parseBinaryExpr(ASTNode* first) {
+    const std::size_t operandBase = m_operands.size();
+    const std::size_t operatorBase = m_operators.size();
+    std::size_t openGroups = 0;   // parenthèses ouvertes par cet appel
+
+    auto topPrecedence = [&]() -> int {
+        return m_operators.size() > operatorBase ? m_operators.back().precedence : -1;
+    };
+    auto reduce = [&]() {
+        PendingOp op = m_operators.back();
+        m_operators.pop_back();
+        auto opNode = makeNode(op.kind, op.line, op.value);
+        if (op.kind == NodeKind::UnaryOp || op.kind == NodeKind::Not) {
+            add(opNode, m_operands.back());
+        } else {
+            add(opNode, m_operands[m_operands.size() - 2]);
+            add(opNode, m_operands.back());
+            m_operands.pop_back();
+        }
+        m_operands.back() = opNode;
+    };
+    // Réduit jusqu'à la parenthèse ouvrante (ou la base) sans la retirer
+    auto reduceGroup = [&]() {
+        while (topPrecedence() > 0) reduce();
+    };
+
+    bool expectOperand = (first == nullptr);
+    bool primaryOnly = false;
+    if (first) m_operands.push_back(first);
+
+    for (;;) {
+        const Token& tok = peek();
+        if (expectOperand) {
+            // factor -> "-" primary . || primary .     primary -> not primary . || ( expr ) . || ...
+            if (tok.type == TokenType::OP_MINUS && !primaryOnly) {
+                next();
+                m_operators.push_back({NodeKind::UnaryOp, kPrefixPrecedence, peek().line, "-"});
+                primaryOnly = true;
+            } else if (tok.type == TokenType::KW_NOT) {
+                m_operators.push_back({NodeKind::Not, kPrefixPrecedence, tok.line, {}});
+                next();
+                primaryOnly = true;
+            } else if (tok.type == TokenType::CAR_LPAREN) {
+                next();
+                m_operators.push_back({NodeKind::Suite, 0, tok.line, {}});   // marqueur de groupe
+                ++openGroups;
+                primaryOnly = false;
+            } else {
+                m_operands.push_back(parseAtom());
+                expectOperand = false;
+            }
+            continue;
+        }
+
+        const BinaryOp& op = binaryOp(tok.type);
+        // parseTest ne prenait pas "=" pour "==" au premier niveau (affectation déjà écartée)
+        bool isOperator = op.precedence != 0 && (tok.type != TokenType::OP_EQ || first == nullptr || openGroups > 0);
+        if (isOperator) {
+            while (topPrecedence() > op.precedence) reduce();
+            if (topPrecedence() == op.precedence) {
+                if (op.nonAssociative) isOperator = false;   // fin de l'expression, comme comp_expr
+                else reduce();
+            }
+        }
+        if (isOperator) {
+            if (tok.type == TokenType::OP_EQ) {
+                expectR(TokenType::OP_EQ_EQ);
+                const Token& falseOp = next();
+                m_operators.push_back({NodeKind::Compare, op.precedence, falseOp.line, "=="});
+            } else if (op.kind == NodeKind::Or || op.kind == NodeKind::And) {
+                next();
+                m_operators.push_back({op.kind, op.precedence, peek().line, {}});
+            } else {
+                next();
+                m_operators.push_back({op.kind, op.precedence, tok.line, tok.value});
+            }
+            expectOperand = true;
+            primaryOnly = false;
+            continue;
+        }
+
+        // Plus d'opérateur : fermeture du groupe parenthésé courant, ou fin de l'expression
+        reduceGroup();
+        if (m_operators.size() == operatorBase) break;
+        m_operators.pop_back();
+        --openGroups;
+        expectR(TokenType::CAR_RPAREN);
+    }
+
+    ASTNode* result = m_operands.back();
+    m_operands.resize(operandBase);
+    return result;
+}
+
+// primary -> const . || ident expr_prime . || [ e ] .
+// ("not primary" et "( expr )" sont traités par parseBinaryExpr)
+ASTNode* Parser::parseAtom() {
+    const Token& tok = peek();
     if (expect(TokenType::INTEGER)) {
-        auto node = std::make_shared<ASTNode>("Integer", tok.value);
-        node->line = std::to_string(tok.line);
-        return node;
+        return makeNode(NodeKind::Integer, tok.line, tok.value);
     }
     if (expect(TokenType::STRING)) {
-        auto node = std::make_shared<ASTNode>("String", tok.value);
-        node->line = std::to_string(tok.line);
-        return node;
+        return makeNode(NodeKind::String, tok.line, tok.value);
     }
     if (expect(TokenType::KW_TRUE)) {
-        auto node = std::make_shared<ASTNode>("True");
-        node->line = std::to_string(tok.line);
-        return node;
+        return makeNode(NodeKind::True, tok.line);
     }
     if (expect(TokenType::KW_FALSE)) {
-        auto node = std::make_shared<ASTNode>("False");
-        node->line = std::to_string(tok.line);
-        return node;
+        return makeNode(NodeKind::False, tok.line);
     }
     if (expect(TokenType::KW_NONE)) {
-        auto node = std::make_shared<ASTNode>("None");
-        node->line = std::to_string(tok.line);
-        return node;
+        return makeNode(NodeKind::None, tok.line);
     }
     if (expect(TokenType::IDF)) {
-        auto idNode = std::make_shared<ASTNode>("Identifier", tok.value);
-        idNode->line = std::to_string(tok.line);
+        auto idNode = identifier(tok);
         if (expect(TokenType::CAR_LPAREN)) {
-            auto funcCallNode = std::make_shared<ASTNode>("FunctionCall");
-            funcCallNode->line = idNode->line; 
-            funcCallNode->children.push_back(idNode);
-            auto paramListNode = std::make_shared<ASTNode>("ParameterList");
-            paramListNode->line = std::to_string(peek().line);
+            auto funcCallNode = makeNode(NodeKind::FunctionCall, idNode->line);
+            add(funcCallNode, idNode);
+            auto paramListNode = makeNode(NodeKind::ParameterList, peek().line);
             while (peek().type != TokenType::CAR_RPAREN) {
                 auto exprNode = parseExpr();
                 if (exprNode) {
-                    paramListNode->children.push_back(exprNode);
+                    add(paramListNode, exprNode);
                 }
                 if (!expect(TokenType::CAR_COMMA)) break;
             }
-            funcCallNode->children.push_back(paramListNode);
+            add(funcCallNode, paramListNode);
             expectR(TokenType::CAR_RPAREN);
             return funcCallNode;
         }
         
         if (expect(TokenType::CAR_LBRACKET)){
-            auto node = std::make_shared<ASTNode>("ListCall");
-            node->line = std::to_string(tok.line);
-            node->children.push_back(idNode);
-            node->children.push_back(parseExpr());
+            auto node = makeNode(NodeKind::ListCall, tok.line);
+            add(node, idNode);
+            add(node, parseExpr());
             expectR(TokenType::CAR_RBRACKET);
 
             while (expect(TokenType::CAR_LBRACKET)){
-                node->children.push_back(parseExpr());
+                add(node, parseExpr());
                 expectR(TokenType::CAR_RBRACKET);
             }
 
             if (expect(TokenType::OP_EQ)) {                                     
-                auto opNode = std::make_shared<ASTNode>("Affect", "=");
-                opNode->line = std::to_string(tok.line);
-                opNode->children.push_back(node);
-                opNode->children.push_back(parseExpr());
+                auto opNode = makeNode(NodeKind::Affect, tok.line, "=");
+                add(opNode, node);
+                add(opNode, parseExpr());
                 return opNode;
             }
             return node;
         }
         return idNode;
     }
-    if (expect(TokenType::CAR_LPAREN)) {
-        auto expr = parseExpr();
-        expectR(TokenType::CAR_RPAREN);
-        return expr;
-    }
     if (expect(TokenType::CAR_LBRACKET)) {
         auto expr = parseE();
         expectR(TokenType::CAR_RBRACKET);
         return expr;
     }
-    if (expect(TokenType::KW_NOT)) {
-        auto notNode = std::make_shared<ASTNode>("Not");
-        notNode->line = std::to_string(tok.line);
-        notNode->children.push_back(parsePrimary());
-        return notNode;
-    }
 
 
     m_errorManager.addError(Error{"Unexpected ", Lexer::tokenTypeToString(tok.type), "Syntax", tok.line});
@@ -332,138 +469,20 @@ std::shared_ptr<ASTNode> Parser::parsePrimary() {
 }
 
 // E -> expr E_prime . || .
-std::shared_ptr<ASTNode> Parser::parseE() {
-    auto listNode = std::make_shared<ASTNode>("List");
-    listNode->line = std::to_string(peek().line);
+// E_prime -> , expr E_prime . || .       (déroulé en boucle)
+ASTNode* Parser::parseE() {
+    auto listNode = makeNode(NodeKind::List, peek().line);
     // E can be replaced with nothing!!
     if (peek().type == TokenType::CAR_RBRACKET) return listNode;
-    auto exprNode = parseExpr(); 
-    auto ePrimeNode = parseEPrime(); 
-    listNode->children.push_back(exprNode);
-    if (ePrimeNode) {
-        auto currentNode = ePrimeNode;
-        while (currentNode) {
-            listNode->children.push_back(currentNode->children.front());  
-            if (currentNode->children.size() > 1) {
-                currentNode = currentNode->children[1];
-            } else {
-                currentNode = nullptr;
-            } 
-        }
+    add(listNode, parseExpr());
+    while (expect(TokenType::CAR_COMMA)) {
+        add(listNode, parseExpr());
     }
     return listNode;
 }
 
-// E_prime -> , expr E_prime . || .
-std::shared_ptr<ASTNode> Parser::parseEPrime() {
-    if (expect(TokenType::CAR_COMMA)) {
-        auto exprNode = parseExpr(); 
-        auto ePrimeNode = parseEPrime();  
-        auto commaNode = std::make_shared<ASTNode>("EPrime");
-        commaNode->line = std::to_string(peek().line);
-        commaNode->children.push_back(exprNode);
-        if (ePrimeNode) {
-            commaNode->children.push_back(ePrimeNode);
-        }
-        return commaNode;
-    }
-    return nullptr;
-}
-
-// or_expr -> and_expr or_expr_prime .
-std::shared_ptr<ASTNode> Parser::parseOrExpr() {
-    auto left = parseAndExpr();
-    while (expect(TokenType::KW_OR)) {
-        auto opNode = std::make_shared<ASTNode>("Or");
-        opNode->line = std::to_string(peek().line);
-        opNode->children.push_back(left);
-        opNode->children.push_back(parseAndExpr());
-        left = opNode;
-    }
-    return left;
-}
-
-// and_expr -> comp_expr and_expr_prime .
-std::shared_ptr<ASTNode> Parser::parseAndExpr() {
-    auto left = parseCompExpr();
-    while (expect(TokenType::KW_AND)) {
-        auto opNode = std::make_shared<ASTNode>("And");
-        opNode->line = std::to_string(peek().line);
-        opNode->children.push_back(left);
-        opNode->children.push_back(parseCompExpr());
-        left = opNode;
-    }
-    return left;
-}
-
-
-// comp_expr -> arith_expr comp_expr_prime .
-std::shared_ptr<ASTNode> Parser::parseCompExpr() {
-    auto left = parseArithExpr();
-    if (peek().type == TokenType::OP_EQ){
-        expectR(TokenType::OP_EQ_EQ);
-        auto comOpFalse = next();
-        auto opNode = std::make_shared<ASTNode>("Compare", "==");
-        opNode->line = std::to_string(comOpFalse.line);
-        opNode->children.push_back(left);
-        opNode->children.push_back(parseArithExpr());
-        return opNode;
-    }
-    if (peek().type == TokenType::OP_EQ_EQ || peek().type == TokenType::OP_NEQ ||
-        peek().type == TokenType::OP_LE || peek().type == TokenType::OP_GE ||
-        peek().type == TokenType::OP_LE_EQ || peek().type == TokenType::OP_GE_EQ) {
-        auto compOp = next();
-        auto opNode = std::make_shared<ASTNode>("Compare", compOp.value);
-        opNode->line = std::to_string(compOp.line);
-        opNode->children.push_back(left);
-        opNode->children.push_back(parseArithExpr());
-        return opNode;
-    }
-    return left;
-}
-
-// arith_expr -> term arith_expr_prime .
-std::shared_ptr<ASTNode> Parser::parseArithExpr() {
-    auto left = parseTerm();
-    while (peek().type == TokenType::OP_PLUS || peek().type == TokenType::OP_MINUS) {
-        auto arithOp = next();
-        auto opNode = std::make_shared<ASTNode>("ArithOp", arithOp.value);
-        opNode->line = std::to_string(arithOp.line);
-        opNode->children.push_back(left);
-        opNode->children.push_back(parseTerm());
-        left = opNode;
-    }
-    return left;
-}
-
-// term -> factor term_prime .
-std::shared_ptr<ASTNode> Parser::parseTerm() {
-    auto left = parseFactor();
-    while (peek().type == TokenType::OP_MUL || peek().type == TokenType::OP_DIV || peek().type == TokenType::OP_MOD) {
-        auto termOp = next();
-        auto opNode = std::make_shared<ASTNode>("TermOp", termOp.value);
-        opNode->line = std::to_string(termOp.line);
-        opNode->children.push_back(left);
-        opNode->children.push_back(parseFactor());
-        left = opNode;
-    }
-    return left;
-}
-
-// factor -> unary primary .
-std::shared_ptr<ASTNode> Parser::parseFactor() {
-    if (expect(TokenType::OP_MINUS)) {
-        auto opNode = std::make_shared<ASTNode>("UnaryOp", "-");
-        opNode->line = std::to_string(peek().line);
-        opNode->children.push_back(parsePrimary());
-        return opNode;
-    }
-    return parsePrimary();
-}
-
-
 // expr_prime -> "(" E ")" . || .                                               # Probalement pas utilisée
-std::shared_ptr<ASTNode> Parser::parseExprPrime() {
+ASTNode* Parser::parseExprPrime() {
     if (expect(TokenType::CAR_LPAREN)) {
         auto exprNode = parseE();
         expectR(TokenType::CAR_RPAREN);
@@ -477,33 +496,30 @@ std::shared_ptr<ASTNode> Parser::parseExprPrime() {
 //stmt -> if expr ":" suite stmt_seconde .
 //stmt -> for ident in expr ":" suite .
 //stmt -> while expr ":" suite .
-std::shared_ptr<ASTNode> Parser::parseStmt() {
+ASTNode* Parser::parseStmt() {
     Token tok = peek();
     if (expect(TokenType::KW_IF)) {
-        auto ifNode = std::make_shared<ASTNode>("If");
-        ifNode->line = std::to_string(tok.line);
-        ifNode->children.push_back(parseExpr());
+        auto ifNode = makeNode(NodeKind::If, tok.line);
+        add(ifNode, parseExpr());
         expectR(TokenType::CAR_COLON);
         auto suite = parseSuite();
-        suite->type = "IfBody";
-        ifNode->children.push_back(suite);
-        ifNode->children.push_back(parseStmtSeconde());
+        suite->kind = NodeKind::IfBody;
+        add(ifNode, suite);
+        add(ifNode, parseStmtSeconde());
         return ifNode;
     }
     if (expect(TokenType::KW_FOR)) {
-        auto forNode = std::make_shared<ASTNode>("For");
-        forNode->line = std::to_string(tok.line);
+        auto forNode = makeNode(NodeKind::For, tok.line);
         Token tok = peek();
         if (expect(TokenType::IDF)) {
-            auto idNode = std::make_shared<ASTNode>("Identifier", tok.value);
-            idNode->line = std::to_string(tok.line);
-            forNode->children.push_back(idNode);
+            auto idNode = identifier(tok);
+            add(forNode, idNode);
             expectR(TokenType::KW_IN);
-            forNode->children.push_back(parseExpr());
+            add(forNode, parseExpr());
             expectR(TokenType::CAR_COLON);
             auto suite = parseSuite();
-            suite->type = "ForBody";
-            forNode->children.push_back(suite);
+            suite->kind = NodeKind::ForBody;
+            add(forNode, suite);
             return forNode;
         }
         //std::cerr << "Unexpected token: " << tok.value << std::endl;
@@ -512,13 +528,12 @@ std::shared_ptr<ASTNode> Parser::parseStmt() {
         //m_errorManager.addError("Lexer: Unexpected token: " + tok.value + " (line:" + std::to_string(tok.line) + ")");
     }
     if (expect(TokenType::KW_WHILE)) {
-        auto whileNode = std::make_shared<ASTNode>("While");
-        whileNode->line = std::to_string(tok.line);
-        whileNode->children.push_back(parseExpr());
+        auto whileNode = makeNode(NodeKind::While, tok.line);
+        add(whileNode, parseExpr());
         expectR(TokenType::CAR_COLON);
         auto suite = parseSuite();
-        suite->type = "WhileBody";
-        whileNode->children.push_back(suite);
+        suite->kind = NodeKind::WhileBody;
+        add(whileNode, suite);
         return whileNode;
     }
     auto simpleStmt = parseSimpleStmt();
@@ -535,11 +550,11 @@ std::shared_ptr<ASTNode> Parser::parseStmt() {
 
 // stmt_seconde -> else ":" suite .
 // stmt_seconde -> .
-std::shared_ptr<ASTNode> Parser::parseStmtSeconde() {
+ASTNode* Parser::parseStmtSeconde() {
     if (expect(TokenType::KW_ELSE)) {
         expectR(TokenType::CAR_COLON);
         auto suite = parseSuite();
-        suite->type = "ElseBody";
+        suite->kind = NodeKind::ElseBody;
         return suite;
     }
     return nullptr;
@@ -547,17 +562,16 @@ std::shared_ptr<ASTNode> Parser::parseStmtSeconde() {
 
 
 // simple_stmt -> "print" "(" print_args ")"      (no NEWLINE here)
-std::shared_ptr<ASTNode> Parser::parsePrint() {
+ASTNode* Parser::parsePrint() {
     if (!expect(TokenType::KW_PRINT)) return nullptr;
     Token printTok = tokens[pos-1]; // Get the PRINT token for its line number
     expectR(TokenType::CAR_LPAREN);
-    auto printNode = std::make_shared<ASTNode>("Print");
-    printNode->line = std::to_string(printTok.line);
+    auto printNode = makeNode(NodeKind::Print, printTok.line);
     if (peek().type != TokenType::CAR_RPAREN) {
         do {
             auto expr = parseExpr();
             if (expr) { // Ensure expression was parsed successfully
-                printNode->children.push_back(expr);
+                add(printNode, expr);
             } else {
                 // If parseExpr returns nullptr, it means an error occurred during parsing the argument.
                 // The error should have been reported by parseExpr or its callees.
@@ -576,38 +590,34 @@ std::shared_ptr<ASTNode> Parser::parsePrint() {
 //simple_stmt -> "return" expr .
 //simple_stmt -> "print" "(" expr ")" .
 //simple_stmt -> "-" indent expr_prime term_prime arith_expr_prime comp_expr_prime and_expr_prime or_expr_prime .
-std::shared_ptr<ASTNode> Parser::parseSimpleStmt() {
+ASTNode* Parser::parseSimpleStmt() {
     Token tok = peek();
     if (tok.type == TokenType::KW_PRINT) { // Check for print keyword first
         return parsePrint();
     }
     if (expect(TokenType::IDF)) {               
-        auto idNode = std::make_shared<ASTNode>("Identifier", tok.value);
-        idNode->line = std::to_string(tok.line);
+        auto idNode = identifier(tok);
         if (expect(TokenType::OP_EQ)) {                                     // test -> "=" expr .
-            auto opNode = std::make_shared<ASTNode>("Affect", "=");
-            opNode->line = std::to_string(tok.line);
-            opNode->children.push_back(idNode);
-            opNode->children.push_back(parseExpr());
+            auto opNode = makeNode(NodeKind::Affect, tok.line, "=");
+            add(opNode, idNode);
+            add(opNode, parseExpr());
             return opNode;
         }
         if (expect(TokenType::CAR_LBRACKET)){
-            auto node = std::make_shared<ASTNode>("ListCall");
-            node->line = std::to_string(tok.line);
-            node->children.push_back(idNode);
-            node->children.push_back(parseExpr());
+            auto node = makeNode(NodeKind::ListCall, tok.line);
+            add(node, idNode);
+            add(node, parseExpr());
             expectR(TokenType::CAR_RBRACKET);
 
             while (expect(TokenType::CAR_LBRACKET)){
-                node->children.push_back(parseExpr());
+                add(node, parseExpr());
                 expectR(TokenType::CAR_RBRACKET);
             }
 
             if (expect(TokenType::OP_EQ)) {                                     // test -> "=" expr .
-                auto opNode = std::make_shared<ASTNode>("Affect", "=");
-                opNode->line = std::to_string(tok.line);
-                opNode->children.push_back(node);
-                opNode->children.push_back(parseExpr());
+                auto opNode = makeNode(NodeKind::Affect, tok.line, "=");
+                add(opNode, node);
+                add(opNode, parseExpr());
                 return opNode;
             }
             return node;
@@ -618,20 +628,17 @@ std::shared_ptr<ASTNode> Parser::parseSimpleStmt() {
            
     }
     if (expect(TokenType::KW_RETURN)) {
-        auto returnNode = std::make_shared<ASTNode>("Return");
-        returnNode->line = std::to_string(tok.line);
-        returnNode->children.push_back(parseExpr());
+        auto returnNode = makeNode(NodeKind::Return, tok.line);
+        add(returnNode, parseExpr());
         return returnNode;
     }
     if (expect(TokenType::OP_MINUS)) {
-        auto defNode = std::make_shared<ASTNode>("Negative", "-");
-        defNode->line = std::to_string(tok.line);
+        auto defNode = makeNode(NodeKind::Negative, tok.line, "-");
         tok = peek();
         if (expect(TokenType::IDF)) {
-            auto idNode = std::make_shared<ASTNode>("Identifier", tok.value);
-            idNode->line = std::to_string(tok.line);
+            auto idNode = identifier(tok);
             auto testNode = parseTest(idNode);
-            defNode->children.push_back(testNode);
+            add(defNode, testNode);
             return defNode;
         }
         //std::cerr << "Unexpected token: " << tok.value << std::endl;
@@ -655,124 +662,40 @@ std::shared_ptr<ASTNode> Parser::parseSimpleStmt() {
 // test -> "=" expr .                           
 // test -> expr_prime term_prime arith_expr_prime comp_expr_prime and_expr_prime or_expr_prime .
 // Fonction réutilisée pour compléter la 4e règle de simple_stmt
-std::shared_ptr<ASTNode> Parser::parseTest(const std::shared_ptr<ASTNode>& idNode) {
-    auto testNode = std::make_shared<ASTNode>("Test");
-    testNode->line = std::to_string(peek().line);
+ASTNode* Parser::parseTest(ASTNode* idNode) {
     auto currentNode = idNode; // Commence avec l'identifiant fourni
-    printf("Call of %s\n", idNode->value.c_str());
+    printf("Call of %.*s\n", static_cast<int>(idNode->value.size()), idNode->value.data());
     // Parsing de expr_prime
     // Si l'identifiant est suivi de parenthèses, il s'agit ici d'un appel de fonction
     if (peek().type == TokenType::CAR_LPAREN) {
-        auto funcCallNode = std::make_shared<ASTNode>("FunctionCall");
-        funcCallNode->line = std::to_string(peek().line);
-        funcCallNode->children.push_back(idNode);
+        auto funcCallNode = makeNode(NodeKind::FunctionCall, peek().line);
+        add(funcCallNode, idNode);
 
         // Parsing des paramètres
-        auto paramListNode = std::make_shared<ASTNode>("ParameterList");
-        paramListNode->line = std::to_string(peek().line);
+        auto paramListNode = makeNode(NodeKind::ParameterList, peek().line);
         expectR(TokenType::CAR_LPAREN);
         while (peek().type != TokenType::CAR_RPAREN) {
             auto exprNode = parseExpr();
             if (exprNode) {
-                paramListNode->children.push_back(exprNode);
+                add(paramListNode, exprNode);
             }
             if (!expect(TokenType::CAR_COMMA)) break;
         }
         expectR(TokenType::CAR_RPAREN);
 
-        funcCallNode->children.push_back(paramListNode);
+        add(funcCallNode, paramListNode);
         currentNode = funcCallNode;
     }
-    // Parsing des opérations term_prime
-    while (peek().type == TokenType::OP_MUL || peek().type == TokenType::OP_DIV || peek().type == TokenType::OP_MOD) {
-        auto termOp = next();
-        auto opNode = std::make_shared<ASTNode>("TermOp", termOp.value);
-        opNode->line = std::to_string(termOp.line);
-
-        // Le côté gauche de l'opération est le nœud courant
-        opNode->children.push_back(currentNode);
-
-        // Parsez le côté droit de l'opération
-        opNode->children.push_back(parseTerm());
-
-        // Le nouvel opérateur devient le nœud courant
-        currentNode = opNode;
-    }
-    
-    // Parsing des opérations arith_expr_prime
-    if (peek().type == TokenType::OP_PLUS || peek().type == TokenType::OP_MINUS) {
-        while (peek().type == TokenType::OP_PLUS || peek().type == TokenType::OP_MINUS) {
-            auto arithOp = next();
-            auto opNode = std::make_shared<ASTNode>("ArithOp", arithOp.value);
-            opNode->line = std::to_string(arithOp.line);
-
-            // Le côté gauche de l'opération est le nœud courant
-            opNode->children.push_back(currentNode);
-
-            // Parsez le côté droit de l'opération
-            opNode->children.push_back(parseTerm());
-
-            // Le nouvel opérateur devient le nœud courant
-            currentNode = opNode;
-        }       
-    }
-
-    // Parsing des opérations comp_expr_prime
-    if (peek().type == TokenType::OP_EQ_EQ || peek().type == TokenType::OP_NEQ ||
-        peek().type == TokenType::OP_LE || peek().type == TokenType::OP_GE ||
-        peek().type == TokenType::OP_LE_EQ || peek().type == TokenType::OP_GE_EQ) {
-        
-        auto compOp = next();
-        auto opNode = std::make_shared<ASTNode>("Compare", compOp.value);
-        opNode->line = std::to_string(compOp.line);
-
-        opNode->children.push_back(currentNode);
-
-        opNode->children.push_back(parseArithExpr());
-
-        currentNode = opNode;
-    }
-
-    // Parsing des opérations and_expr_prime
-    if (peek().type == TokenType::KW_AND) {   
-        while (expect(TokenType::KW_AND)) {
-            auto opNode = std::make_shared<ASTNode>("And");
-            opNode->line = std::to_string(peek().line);
-
-            opNode->children.push_back(currentNode);
-
-            opNode->children.push_back(parseCompExpr());
-
-            currentNode = opNode;
-        }
-    }
-    
-    // Parsing des opérations or_expr_prime
-    if (peek().type == TokenType::KW_OR) {
-        while (expect(TokenType::KW_OR)) {
-            auto opNode = std::make_shared<ASTNode>("Or");
-            opNode->line = std::to_string(peek().line);
-            
-            opNode->children.push_back(currentNode);
-            
-            opNode->children.push_back(parseAndExpr());
-            
-            currentNode = opNode;
-        }
-    }
-
-    // Ajoutez le nœud final au nœud Test
-    testNode->children.push_back(currentNode);              // On peut peut-être enlever ce noeud "Test"
-    return testNode->children.back();
+    // term_prime arith_expr_prime comp_expr_prime and_expr_prime or_expr_prime
+    return parseBinaryExpr(currentNode);
 }
 
-
-void Parser::exportToDot(const std::shared_ptr<ASTNode>& node, std::ostream& out) {
+void Parser::exportToDot(ASTNode* node, std::ostream& out) {
     static int counter = 0;
     int currentId = counter++;
     
     // Écrire le nœud courant
-    out << "  node" << currentId << " [label=\"" << node->type;
+    out << "  node" << currentId << " [label=\"" << nodeKindName(node->kind);
     if (!node->value.empty()) {
         out << "\\n" << node->value;
     }
@@ -788,7 +711,7 @@ void Parser::exportToDot(const std::shared_ptr<ASTNode>& node, std::ostream& out
     }
 }
 
-void Parser::generateDotFile(const std::shared_ptr<ASTNode>& root, const std::string& filename) {
+void Parser::generateDotFile(ASTNode* root, const std::string& filename) {
     std::ofstream file(filename);
     if (!file) {
         throw std::runtime_error("Unable to open file for writing");
@@ -0,0 +1,103 @@
+#include "partialEvaluator.h"
+#include "astQueries.h"
+#include <unordered_set>
+
+void PartialEvaluator::run(ASTNode* root) {
+    m_output.clear();
+    m_statements = m_executed = m_materialized = m_steps = 0;
+    if (!root) return;
+    ASTNode* instructions = nullptr;
+    for (ASTNode* child : root->children) {
+        if (child && child->kind == NodeKind::Instructions) instructions = child;
+    }
+    if (!instructions) return;
+    m_statements = instructions->children.size();
+
+    std::vector<bool> pure = analysePurity(m_globals, m_callGraph);
+    Evaluator evaluator(m_globals, m_callGraph);
+    Evaluator::Limits limits;
+    limits.steps = m_fuel;
+    evaluator.setLimits(limits);
+    evaluator.setPureFunctions(&pure);
+    std::string output;
+    evaluator.setOutput(&output);
+    evaluator.beginProgram();
+
+    // Dernier point où l'état se réécrit : avant la première instruction, il est vide
+    State state;
+    std::size_t outputSize = 0;
+    State current;
+    for (std::size_t i = 0; i < m_statements; ++i) {
+        if (!evaluator.executeStatement(instructions->children[i])) break;
+        current.clear();
+        if (!snapshot(evaluator, current)) continue;
+        m_executed = i + 1;
+        outputSize = output.size();
+        state = std::move(current);
+    }
+    m_steps = evaluator.steps();
+    if (m_executed == 0) return;
+    m_output = output.substr(0, outputSize);
+
+    // Le préfixe exécuté laisse place aux affectations qui rétablissent son état
+    for (std::size_t i = 0; i < m_executed; ++i) instructions->children.erase(0);
+    if (instructions->children.empty()) return; // plus rien ne relit les globales
+    int line = instructions->children[0] ? instructions->children[0]->line : 0;
+    for (const auto& [symbol, value] : state) {
+        ASTNode* target = m_arena.makeName(NodeKind::Identifier, symbol->id, line);
+        target->type = valueTypeOf(symbol->type);
+        ASTNode* affect = m_arena.make(NodeKind::Affect, line);
+        m_arena.append(affect, target);
+        m_arena.append(affect, literal(value, target->type, line));
+        m_arena.insert(instructions, m_materialized++, affect);
+    }
+}
+
+// Copie des globales affectées, dans l'ordre de la table ; faux si l'état ne se réécrit pas en littéraux
+bool PartialEvaluator::snapshot(const Evaluator& evaluator, State& state) const {
+    const auto& values = evaluator.globalValues();
+    std::unordered_set<const Evaluator::List*> lists;
+    for (const Symbol* symbol : m_globals.symbols) {
+        const VariableSymbol* variable = symbolAs<VariableSymbol>(symbol);
+        if (!variable) continue;
+        auto it = values.find(variable->id);
+        if (it == values.end()) continue;
+        const Evaluator::Value& value = it->second;
+        if (evaluator.inConcatBuffer(value)) return false;
+        if (value.kind != Evaluator::Value::Kind::List) {
+            state.emplace_back(variable, value);
+            continue;
+        }
+        // Une liste partagée ou imbriquée perdrait son identité en devenant un littéral
+        if (!lists.insert(value.list.get()).second) return false;
+        for (const Evaluator::Value& element : *value.list) {
+            if (element.kind == Evaluator::Value::Kind::List || evaluator.inConcatBuffer(element)) return false;
+        }
+        Evaluator::Value copy = value;
+        copy.list = std::make_shared<Evaluator::List>(*value.list);
+        state.emplace_back(variable, std::move(copy));
+    }
+    return true;
+}
+
+ASTNode* PartialEvaluator::literal(const Evaluator::Value& value, ValueType type, int line) {
+    ASTNode* node = nullptr;
+    switch (value.kind) {
+    case Evaluator::Value::Kind::Integer:
+        node = m_arena.make(NodeKind::Integer, line, std::to_string(value.integer));
+        node->type = type == ValueType::Boolean ? ValueType::Boolean : ValueType::Integer;
+        return node;
+    case Evaluator::Value::Kind::String:
+        node = m_arena.make(NodeKind::String, line, *value.string);
+        node->type = ValueType::String;
+        return node;
+    case Evaluator::Value::Kind::List:
+        node = m_arena.make(NodeKind::List, line);
+        node->type = ValueType::List;
+        for (const Evaluator::Value& element : *value.list) {
+            m_arena.append(node, literal(element, element.kind == Evaluator::Value::Kind::String ? ValueType::String : ValueType::Integer, line));
+        }
+        return node;
+    }
+    return node;
+}
@@ -0,0 +1,589 @@
+#include "runtime.h"
+#include <string>
+
+namespace {
+
+struct Dependency {
+    RuntimeItem item;
+    RuntimeItem dependency;
+};
+
+constexpr Dependency kDependencies[] = {
+    {RuntimeItem::DivisionByZero, RuntimeItem::DivZeroMessage},
+    {RuntimeItem::PrintNumber, RuntimeItem::NumberBuffer},
+    {RuntimeItem::PrintNumber, RuntimeItem::MinusSign},
+    {RuntimeItem::ListConcat, RuntimeItem::ListHeap},
+    {RuntimeItem::StrConcat, RuntimeItem::ConcatBuffer},
+    {RuntimeItem::ListRange, RuntimeItem::ListHeap},
+    {RuntimeItem::PrintList, RuntimeItem::PrintString},
+    {RuntimeItem::PrintList, RuntimeItem::PrintNumber},
+    {RuntimeItem::PrintList, RuntimeItem::ListPunctuation},
+};
+
+void emitDivisionByZero(AsmSection& textSection) {
+    // --- Division by Zero Error Handler ---
+    textSection += "\n; Division by zero error handler\n";
+    textSection += "division_by_zero_error:\n";
+    textSection += "    ; Print error message\n";
+    textSection += "    mov rax, 1          ; syscall: write\n";
+    textSection += "    mov rdi, 1          ; file descriptor: stdout\n";
+    textSection += "    mov rsi, div_zero_msg\n";
+    textSection += "    mov rdx, div_zero_len\n";
+    textSection += "    syscall\n";
+    textSection += "    ; Exit with error code\n";
+    textSection += "    mov rax, 60         ; syscall: exit\n";
+    textSection += "    mov rdi, 1          ; exit code 1 (error)\n";
+    textSection += "    syscall\n\n";
+}
+
+void emitPrintNumber(AsmSection& textSection) {
+    // --- Print Number Function ---
+    textSection += "; Function to print a number in RAX\n";
+    textSection += "print_number:\n";
+    textSection += "    push rbp\n";
+    textSection += "    mov rbp, rsp\n";
+    textSection += "    push rbx          ; Preserve callee-saved rbx\n";
+    textSection += "    push r12          ; Preserve callee-saved r12\n";
+    textSection += "    mov r12, rax      ; save original number in r12 (after r12 is saved)\n";
+
+    // Handle negative numbers
+    textSection += "    cmp r12, 0\n";
+    textSection += "    jge .print_positive\n";
+    textSection += "    ; Handle negative number\n";
+    textSection += "    push rax          ; Syscalls clobber rax, rdi, rsi, rdx. r12 is safe here.\n";
+    textSection += "    push rdi\n";
+    textSection += "    push rsi\n";
+    textSection += "    push rdx\n";
+    textSection += "    mov rax, 1\n";
+    textSection += "    mov rdi, 1\n";
+    textSection += "    mov rsi, minus_sign\n";
+    textSection += "    mov rdx, 1\n";
+    textSection += "    syscall\n";
+    textSection += "    pop rdx\n";
+    textSection += "    pop rsi\n";
+    textSection += "    pop rdi\n";
+    textSection += "    pop rax\n";
+    textSection += "    neg r12           ; Make the number positive. r12 was preserved.\n";
+
+    textSection += ".print_positive:\n";
+    textSection += "    lea rdi, [buffer+31]  ; point rdi to end of buffer\n";
+    textSection += "    mov byte [rdi], 0     ; null-terminate the buffer\n";
+    textSection += "    cmp r12, 0\n";
+    textSection += "    jne .print_convert\n";
+    textSection += "    mov byte [rdi-1], '0'\n";
+    textSection += "    lea rdi, [rdi-1]\n";
+    textSection += "    jmp .print_output\n";
+     
+    textSection += ".print_convert:\n";
+    textSection += "    mov rax, r12          ; Use r12 (which holds the number) for conversion\n";
+    textSection += "    mov rbx, 10           ; Divisor (rbx was saved)\n";
+    textSection += ".print_convert_loop:\n";
+    textSection += "    xor rdx, rdx\n";
+    textSection += "    div rbx             ; rax = quotient, rdx = remainder\n";
+    textSection += "    add rdx, '0'        ; convert digit to ASCII\n";
+    textSection += "    dec rdi             ; move pointer left\n";
+    textSection += "    mov [rdi], dl       ; store digit in buffer\n";
+    textSection += "    cmp rax, 0\n";
+    textSection += "    jne .print_convert_loop\n";
+    
+    textSection += ".print_output:\n";
+    textSection += "    lea rsi, [rdi]      ; rsi points to start of the string\n";
+    textSection += "    mov rdx, buffer+31\n";
+    textSection += "    sub rdx, rdi        ; compute string length\n";
+    textSection += "    mov rax, 1          ; syscall: write\n";
+    textSection += "    mov rdi, 1          ; file descriptor: stdout\n";
+    textSection += "    syscall             ; rax, rdi, rsi, rdx might be clobbered\n";
+
+    textSection += "    pop r12           ; Restore callee-saved r12\n";
+    textSection += "    pop rbx           ; Restore callee-saved rbx\n";
+    textSection += "    pop rbp\n";
+    textSection += "    ret\n\n";
+}
+
+void emitListConcat(AsmSection& textSection) {
+    textSection += "\n; Function to concatenate two lists\n";
+    textSection += "list_concat:\n";
+    textSection += "    push rbp\n";
+    textSection += "    mov rbp, rsp\n";
+    textSection += "    push r12\n";
+    textSection += "    push r13\n";
+    textSection += "    push r14\n";
+    textSection += "    push rbx\n";
+    textSection += "    push r15\n";
+        
+    // Sauvegarder les listes d'entrée
+    textSection += "    mov r12, rdi        ; r12 = liste1\n";
+    textSection += "    mov r13, rsi        ; r13 = liste2\n";
+        
+    // Lire les tailles des deux listes
+    textSection += "    mov r14, [r12]      ; r14 = taille de liste1\n";
+    textSection += "    mov r15, [r13]      ; r15 = taille de liste2\n";
+        
+    // Obtenir un nouvel emplacement pour la liste résultat
+    textSection += "    mov rbx, [list_offset]\n";
+    textSection += "    mov rax, list_buffer\n";
+    textSection += "    add rax, rbx        ; rax = adresse de la nouvelle liste\n";
+    textSection += "    push rax            ; sauvegarder l'adresse de la nouvelle liste\n";
+        
+    // Calculer et stocker la taille totale
+    textSection += "    mov rcx, [list_offset]\n";
+    textSection += "    mov rax, r14\n";
+    textSection += "    add rax, r15\n";
+    textSection += "    mov [list_buffer + rcx], rax  ; stocker la taille totale\n";
+    textSection += "    add rcx, 8\n";
+    textSection += "    mov [list_offset], rcx\n";
+        
+    // Copier les éléments de la première liste (sauter la taille)
+    textSection += "    mov rsi, r12\n";
+    textSection += "    add rsi, 8          ; sauter la taille de liste1\n";
+    textSection += "    mov rbx, rcx        ; offset de destination\n";
+    textSection += "    mov rcx, r14        ; nombre d'éléments à copier\n";
+    textSection += "    cmp rcx, 0\n";
+    textSection += "    je .list_copy1_done\n";
+        
+    textSection += ".list_copy1_loop:\n";
+    textSection += "    mov rdx, [rsi]      ; charger élément de liste1\n";
+    textSection += "    mov [list_buffer + rbx], rdx  ; copier l'élément\n";
+    textSection += "    add rsi, 8          ; avancer dans liste1\n";
+    textSection += "    add rbx, 8          ; avancer dans nouvelle liste\n";
+    textSection += "    dec rcx\n";
+    textSection += "    jnz .list_copy1_loop\n";
+    textSection += ".list_copy1_done:\n";
+        
+    // Copier les éléments de la deuxième liste (sauter la taille)
+    textSection += "    mov rsi, r13\n";
+    textSection += "    add rsi, 8          ; sauter la taille de liste2\n";
+    textSection += "    mov rcx, r15        ; nombre d'éléments à copier\n";
+    textSection += "    cmp rcx, 0\n";
+    textSection += "    je .list_copy2_done\n";
+        
+    textSection += ".list_copy2_loop:\n";
+    textSection += "    mov rdx, [rsi]      ; charger élément de liste2\n";
+    textSection += "    mov [list_buffer + rbx], rdx  ; copier l'élément\n";
+    textSection += "    add rsi, 8          ; avancer dans liste2\n";
+    textSection += "    add rbx, 8          ; avancer dans nouvelle liste\n";
+    textSection += "    dec rcx\n";
+    textSection += "    jnz .list_copy2_loop\n";
+    textSection += ".list_copy2_done:\n";
+        
+    // Mettre à jour list_offset
+    textSection += "    mov [list_offset], rbx\n";
+        
+    // Retourner l'adresse de la nouvelle liste
+    textSection += "    pop rax             ; récupérer l'adresse de la liste résultat\n";
+        
+    // Nettoyage
+    textSection += "    pop r15\n";
+    textSection += "    pop rbx\n";
+    textSection += "    pop r14\n";
+    textSection += "    pop r13\n";
+    textSection += "    pop r12\n";
+    textSection += "    pop rbp\n";
+    textSection += "    ret\n\n";
+}
+
+void emitStrConcat(AsmSection& textSection) {
+    textSection += "; Function to concatenate two strings with offset\n";
+    textSection += "str_concat:\n";
+    textSection += "    push rbp\n";
+    textSection += "    mov rbp, rsp\n";
+    textSection += "    push r12\n";
+    textSection += "    push r13\n";
+    textSection += "    push r14\n";
+    textSection += "    push rbx\n";
+
+    textSection += "    ; Save input strings\n";
+    textSection += "    mov r12, rdi        ; r12 = str1\n";
+    textSection += "    mov r13, rsi        ; r13 = str2\n";
+
+    textSection += "    mov r14, concat_buffer\n";
+    textSection += "    mov rbx, 0\n";
+    // textSection += "    mov rbx, [concat_offset]\n";
+    // textSection += "    add r14, rbx        ; r14 = destination address (buffer + offset)\n";
+
+    // Sauvegarder le pointeur de début de concaténation à retourner
+    textSection += "    mov rax, r14\n";
+
+    // --- Copier str1 --- (octets dans dl : al écraserait le résultat rangé dans rax)
+    textSection += "    mov rsi, r12\n";
+    textSection += ".copy_str1:\n";
+    textSection += "    mov dl, [rsi]\n";
+    textSection += "    cmp dl, 0\n";
+    textSection += "    je .done_str1\n";
+    textSection += "    mov [r14], dl\n";
+    textSection += "    inc rsi\n";
+    textSection += "    inc r14\n";
+    textSection += "    jmp .copy_str1\n";
+    textSection += ".done_str1:\n";
+
+    // --- Copier str2 ---
+    textSection += "    mov rsi, r13\n";
+    textSection += ".copy_str2:\n";
+    textSection += "    mov dl, [rsi]\n";
+    textSection += "    cmp dl, 0\n";
+    textSection += "    je .done_str2\n";
+    textSection += "    mov [r14], dl\n";
+    textSection += "    inc rsi\n";
+    textSection += "    inc r14\n";
+    textSection += "    jmp .copy_str2\n";
+    textSection += ".done_str2:\n";
+
+    // Ajout du null terminator
+    textSection += "    mov byte [r14], 0\n";
+    textSection += "    inc r14\n";
+
+    // Mettre à jour concat_offset = r14 - concat_buffer
+    textSection += "    mov rbx, r14\n";
+    textSection += "    sub rbx, concat_buffer\n";
+    textSection += "    mov [concat_offset], rbx\n";
+
+    // Nettoyage
+    textSection += "    pop rbx\n";
+    textSection += "    pop r14\n";
+    textSection += "    pop r13\n";
+    textSection += "    pop r12\n";
+    textSection += "    pop rbp\n";
+    textSection += "    ret\n\n";
+}
+
+void emitPrintString(AsmSection& textSection) {
+    // Routine pour les chaînes
+    textSection += "print_string:\n";
+    textSection += "    push rbp\n";
+    textSection += "    mov rbp, rsp\n";
+    textSection += "    mov rsi, rax\n";
+    textSection += "    mov rdx, 0\n";
+    textSection += ".print_strlen_loop:\n";
+    textSection += "    cmp byte [rsi+rdx], 0\n";
+    textSection += "    je .print_strlen_done\n";
+    textSection += "    inc rdx\n";
+    textSection += "    jmp .print_strlen_loop\n";
+    textSection += ".print_strlen_done:\n";
+    textSection += "    mov rax, 1\n";
+    textSection += "    mov rdi, 1\n";
+    textSection += "    syscall\n";
+    textSection += "    pop rbp\n";
+    textSection += "    ret\n\n";
+}
+
+void emitListRange(AsmSection& textSection) {
+    textSection += "; Function to create a range list (0...n-1)\n";
+    textSection += "list_range:\n";
+    textSection += "    push rbp\n";
+    textSection += "    mov rbp, rsp\n";
+    textSection += "    push rbx\n";
+    textSection += "    push r12\n";
+    textSection += "    push r13\n";
+            
+    textSection += "    ; rax = n (size of the range)\n";
+    textSection += "    mov r12, rax        ; r12 = n\n";
+            
+    textSection += "    ; Get new list address\n";
+    textSection += "    mov rbx, [list_offset]\n";
+    textSection += "    mov rax, list_buffer\n";
+    textSection += "    add rax, rbx        ; rax = address of the new list\n";
+    textSection += "    push rax            ; save list address\n";
+            
+    textSection += "    ; Store the size first\n";
+    textSection += "    mov rcx, [list_offset]\n";
+    textSection += "    mov [list_buffer + rcx], r12\n";
+    textSection += "    add rcx, 8\n";
+    textSection += "    mov [list_offset], rcx\n";
+            
+    textSection += "    ; Initialize counter\n";
+    textSection += "    xor r13, r13        ; r13 = 0 (counter)\n";
+    textSection += "    cmp r12, 0\n";
+    textSection += "    je .list_range_done\n";
+            
+    textSection += ".list_range_loop:\n";
+    textSection += "    ; Add counter value to list\n";
+    textSection += "    mov rcx, [list_offset]\n";
+    textSection += "    mov [list_buffer + rcx], r13\n";
+    textSection += "    add rcx, 8\n";
+    textSection += "    mov [list_offset], rcx\n";
+            
+    textSection += "    ; Increment counter\n";
+    textSection += "    inc r13\n";
+            
+    textSection += "    ; Check if counter < n\n";
+    textSection += "    cmp r13, r12\n";
+    textSection += "    jl .list_range_loop\n";
+            
+    textSection += ".list_range_done:\n";
+    textSection += "    ; Return list address\n";
+    textSection += "    pop rax\n";
+            
+    textSection += "    ; Cleanup\n";
+    textSection += "    pop r13\n";
+    textSection += "    pop r12\n";
+    textSection += "    pop rbx\n";
+    textSection += "    pop rbp\n";
+    textSection += "    ret\n\n";
+}
+
+void emitPrintList(AsmSection& textSection) {
+    // --- revised print_not_string ----------------------------------------
+
+    textSection += "; Function to print a list (elements separated by space, enclosed in brackets)\n";
+    textSection += "print_not_string:          ; RAX = address of list\n";
+    textSection += "    push rbp\n";
+    textSection += "    mov  rbp, rsp\n";
+    textSection += "    push rbx\n";
+    textSection += "    push r12            ; will be our loop-counter\n";
+    textSection += "    push rdx\n";
+    textSection += "    push rsi\n";
+    textSection += "    push rdi\n";
+    textSection += "    push r8\n";
+    textSection += "    push r9\n";
+
+    textSection += "    mov  rbx, rax          ; rbx = base address of the list structure\n";
+    textSection += "    mov  r12, [rbx]        ; r12 = size of the list\n";
+    textSection += "    add  rbx, 8            ; rbx -> first element\n";
+
+    // print '['
+    textSection += "    mov  rax, 1\n";
+    textSection += "    mov  rdi, 1\n";
+    textSection += "    mov  rsi, open_bracket\n";
+    textSection += "    mov  rdx, 1\n";
+    textSection += "    syscall\n";
+
+    textSection += ".print_list_loop:\n";
+    textSection += "    cmp  r12, 0\n";
+    textSection += "    je   .print_list_done\n";
+
+    textSection += "    mov  r8, [rbx]         ; element -> r8\n";
+    textSection += "    ; Check if element is a likely pointer (above certain address threshold)\n";
+    textSection += "    cmp  r8, 0x1000        ; Addresses below this are likely integers\n";
+    textSection += "    jb   .print_as_number\n";
+
+    textSection += "    mov  rax, r8\n";
+    textSection += "    ; Try to read the first byte safely\n";
+    textSection += "    push rcx\n";
+    textSection += "    mov  rcx, r8\n";
+    textSection += "    shr  rcx, 48           ; Get top 16 bits - if non-zero, likely invalid addr\n";
+    textSection += "    cmp  rcx, 0\n";
+    textSection += "    jne  .not_a_string\n";
+    textSection += "    pop  rcx\n";
+
+    textSection += "    ; Now test if this might be a string (has ASCII characters and null-terminator)\n";
+    textSection += "    push rcx\n";
+    textSection += "    xor  rcx, rcx\n";
+    textSection += ".check_string_loop:\n";
+    textSection += "    cmp  rcx, 20           ; Limite max: 20 caractères à vérifier\n";
+    textSection += "    jge  .not_a_string\n";
+    textSection += "    mov  r9b, byte [rax+rcx]\n";
+    textSection += "    cmp  r9b, 0            ; Fin de la chaîne?\n";
+    textSection += "    je   .print_as_string\n";
+    textSection += "    cmp  r9b, 32\n";
+    textSection += "    jl   .not_a_string\n";
+    textSection += "    cmp  r9b, 126\n";
+    textSection += "    jg   .not_a_string\n";
+    textSection += "    inc  rcx\n";
+    textSection += "    jmp  .check_string_loop\n";
+
+    textSection += ".not_a_string:\n";
+    textSection += "    pop  rcx\n";
+    textSection += "    jmp  .print_as_number\n";
+
+    textSection += ".print_as_string:\n";
+    textSection += "    pop  rcx\n";
+    textSection += "    mov  rax, r8\n";
+    textSection += "    call print_string\n";
+    textSection += "    jmp  .after_element_print\n";
+
+    textSection += ".print_as_number:\n";
+    textSection += "    mov  rax, r8\n";
+    textSection += "    call print_number\n";
+
+    textSection += ".after_element_print:\n";
+    textSection += "    add  rbx, 8\n";
+    textSection += "    dec  r12\n";
+    textSection += "    cmp  r12, 0\n";
+    textSection += "    je   .print_list_done\n";
+
+    // print ", "
+    textSection += "    mov  rax, 1\n";
+    textSection += "    mov  rdi, 1\n";
+    textSection += "    mov  rsi, comma_space\n";
+    textSection += "    mov  rdx, 2\n";
+    textSection += "    syscall\n";
+    textSection += "    jmp  .print_list_loop\n";
+
+    textSection += ".print_list_done:\n";
+    // print ']'
+    textSection += "    mov  rax, 1\n";
+    textSection += "    mov  rdi, 1\n";
+    textSection += "    mov  rsi, close_bracket\n";
+    textSection += "    mov  rdx, 1\n";
+    textSection += "    syscall\n";
+
+    textSection += "    pop  r9\n";
+    textSection += "    pop  r8\n";
+    textSection += "    pop  rdi\n";
+    textSection += "    pop  rsi\n";
+    textSection += "    pop  rdx\n";
+    textSection += "    pop  r12\n";
+    textSection += "    pop  rbx\n";
+    textSection += "    pop  rbp\n";
+    textSection += "    ret\n";
+
+    textSection += "\n; legacy alias – keep older code paths working\n";
+    textSection += "print_list:\n";
+    textSection += "    jmp print_not_string\n\n";
+}
+
+void emitStrEquals(AsmSection& textSection) {
+    textSection += "\n; Function to compare two strings: rax = 1 if rdi and rsi hold the same bytes, else 0\n";
+    textSection += "str_equals:\n";
+    textSection += "    cmp rdi, rsi\n";
+    textSection += "    je .str_equals_true     ; same pointer (interned literals): no need to read them\n";
+    textSection += ".str_equals_loop:\n";
+    textSection += "    mov al, [rdi]\n";
+    textSection += "    cmp al, [rsi]\n";
+    textSection += "    jne .str_equals_false\n";
+    textSection += "    test al, al\n";
+    textSection += "    je .str_equals_true\n";
+    textSection += "    inc rdi\n";
+    textSection += "    inc rsi\n";
+    textSection += "    jmp .str_equals_loop\n";
+    textSection += ".str_equals_false:\n";
+    textSection += "    xor rax, rax\n";
+    textSection += "    ret\n";
+    textSection += ".str_equals_true:\n";
+    textSection += "    mov rax, 1\n";
+    textSection += "    ret\n";
+}
+
+void emitItems(const RuntimeUsage& usage, AsmSection& textSection, AsmSection& dataSection, AsmSection& bssSection) {
+    if (usage.uses(RuntimeItem::DivisionByZero)) emitDivisionByZero(textSection);
+    if (usage.uses(RuntimeItem::PrintNumber)) emitPrintNumber(textSection);
+    if (usage.uses(RuntimeItem::ListConcat)) emitListConcat(textSection);
+    if (usage.uses(RuntimeItem::StrConcat)) emitStrConcat(textSection);
+    if (usage.uses(RuntimeItem::PrintString)) emitPrintString(textSection);
+    if (usage.uses(RuntimeItem::ListRange)) emitListRange(textSection);
+    if (usage.uses(RuntimeItem::PrintList)) emitPrintList(textSection);
+    if (usage.uses(RuntimeItem::StrEquals)) emitStrEquals(textSection);
+
+    if (usage.uses(RuntimeItem::DivZeroMessage)) {
+        dataSection += "    div_zero_msg: db 'Error: Division by zero', 10, 0\n";
+        dataSection += "    div_zero_len: equ $ - div_zero_msg\n";
+    }
+    if (usage.uses(RuntimeItem::ListPunctuation)) {
+        dataSection += "    open_bracket: db '['\n";
+        dataSection += "    close_bracket: db ']'\n";
+        dataSection += "    comma_space: db ',', 32\n";
+    }
+    if (usage.uses(RuntimeItem::IndexErrorMessage)) {
+        dataSection += "    index_error_msg: db 'Error: Index out of bounds', 10, 0\n";
+        dataSection += "    index_error_len: equ $ - index_error_msg\n";
+    }
+    if (usage.uses(RuntimeItem::Newline)) dataSection += "    newline: db 10\n";
+    if (usage.uses(RuntimeItem::Space)) dataSection += "    space: db 32\n";
+    if (usage.uses(RuntimeItem::MinusSign)) dataSection += "    minus_sign: db '-'\n";
+
+    // Tampons remplis de zéros : en .bss, ils ne pèsent rien dans l'exécutable
+    if (usage.uses(RuntimeItem::ConcatBuffer)) {
+        bssSection += "    concat_buffer: resb 2048\n";
+        bssSection += "    concat_offset: resq 1\n";
+    }
+    if (usage.uses(RuntimeItem::ListHeap)) {
+        bssSection += "    list_buffer: resq 8192\n";
+        bssSection += "    list_offset: resq 1\n";
+    }
+    if (usage.uses(RuntimeItem::NumberBuffer)) bssSection += "    buffer: resb 32 ; For print_number\n";
+}
+
+// Points d'entrée et données partagées exportés par pyasm_rt (ABI décrite dans runtime.h)
+struct Export {
+    RuntimeItem item;
+    const char* symbol;
+};
+
+constexpr Export kExports[] = {
+    {RuntimeItem::DivisionByZero, "division_by_zero_error"},
+    {RuntimeItem::PrintNumber, "print_number"},
+    {RuntimeItem::ListConcat, "list_concat"},
+    {RuntimeItem::StrConcat, "str_concat"},
+    {RuntimeItem::PrintString, "print_string"},
+    {RuntimeItem::ListRange, "list_range"},
+    {RuntimeItem::PrintList, "print_not_string"},
+    {RuntimeItem::PrintList, "print_list"},
+    {RuntimeItem::StrEquals, "str_equals"},
+    {RuntimeItem::ListHeap, "list_buffer"},
+    {RuntimeItem::ListHeap, "list_offset"},
+};
+
+// Les constantes utilisées directement par le code en ligne restent dans chaque programme
+bool inLibrary(RuntimeItem item) {
+    return item != RuntimeItem::Newline && item != RuntimeItem::Space && item != RuntimeItem::IndexErrorMessage;
+}
+
+RuntimeItem itemAt(unsigned i) {
+    return static_cast<RuntimeItem>(i);
+}
+
+} // namespace
+
+std::size_t RuntimeUsage::count() const {
+    std::size_t n = 0;
+    for (std::uint32_t mask = m_mask; mask; mask &= mask - 1) ++n;
+    return n;
+}
+
+RuntimeUsage RuntimeUsage::closure() const {
+    RuntimeUsage result = *this;
+    bool changed = true;
+    while (changed) { // le graphe est minuscule : point fixe naïf
+        changed = false;
+        for (const Dependency& dep : kDependencies) {
+            if (result.uses(dep.item) && !result.uses(dep.dependency)) {
+                result.use(dep.dependency);
+                changed = true;
+            }
+        }
+    }
+    return result;
+}
+
+
+void emitRuntime(const RuntimeUsage& usage, RuntimeLinkage linkage,
+                 AsmSection& textSection, AsmSection& dataSection, AsmSection& bssSection) {
+    if (linkage == RuntimeLinkage::Inline) {
+        emitItems(usage.closure(), textSection, dataSection, bssSection);
+        return;
+    }
+
+    // pyasm_rt fournit les routines et leurs données : seules les références restent ici
+    RuntimeUsage local;
+    for (unsigned i = 0; i < static_cast<unsigned>(RuntimeItem::Count); ++i) {
+        if (usage.uses(itemAt(i)) && !inLibrary(itemAt(i))) local.use(itemAt(i));
+    }
+    for (const Export& entry : kExports) {
+        if (usage.uses(entry.item)) textSection += std::string("extern ") + entry.symbol + "\n";
+    }
+    emitItems(local, textSection, dataSection, bssSection);
+}
+
+void emitRuntimeLibrary(OutputSink& out) {
+    RuntimeUsage all;
+    for (unsigned i = 0; i < static_cast<unsigned>(RuntimeItem::Count); ++i) {
+        if (inLibrary(itemAt(i))) all.use(itemAt(i));
+    }
+    AsmSection textSection, dataSection, bssSection;
+    emitItems(all, textSection, dataSection, bssSection);
+
+    out.write("; pyasm_rt - runtime library of pyasm programs\n");
+    out.write("; Generated by `pyasm --emit-runtime`: edit src/runtime.cpp instead. ABI: include/runtime.h\n\n");
+    for (const Export& entry : kExports) {
+        out.write("global ");
+        out.write(entry.symbol);
+        out.write("\n");
+    }
+    out.write("\nsection .text\n");
+    textSection.writeTo(out);
+    out.write("\nsection .data\n");
+    dataSection.writeTo(out);
+    out.write("\nsection .bss\n");
+    bssSection.writeTo(out);
+    out.flush();
+}
@@ -1,139 +1,120 @@
 #include "semanticAnalyzer.h"
+#include "astQueries.h"
 #include <iostream>
 #include <algorithm>
 
-// Liste des noms de variables de boucle for ouvertes
-std::vector<std::string> loopVariables;
-// Liste des noms de fonctions déjà définies
-std::vector<std::string> definedFunctionsNames;
-
-
-std::vector<std::string> ACCESSIBLE_GLOB;
-std::shared_ptr<ASTNode> NEW_DEF;
-
-void SemanticAnalyzer::smallhelpR(const std::shared_ptr<ASTNode>& node, const std::shared_ptr<ASTNode>& defnode, const std::shared_ptr<ASTNode>& parentnode, const int n, std::string suffixe) {
-    if (node->type == "FunctionCall") {
-        if  (defnode != nullptr) {
-            // si défini dans le self même : += suffixe + name + "_"
-            for (auto& d : defnode->children[1]->children) {
-                if (node->children[0]->value == d->value) {
-                    node->children[0]->value = suffixe + defnode->value + "_" + node->children[0]->value;
-                    goto recurNOW;
-                }
-            }
-            // si == à self name : += suffixe + "_"
-            if (node->children[0]->value == defnode->value) {
-                node->children[0]->value = suffixe + "_" + node->children[0]->value;
-                goto recurNOW;
-            }
-        }
-        if (parentnode != nullptr) {
-            // si défini dans parent : += suffixe + "_"
-            int i = 0;
-            for (auto& d : parentnode->children[1]->children) {
-                if (i >= n) break;
-                if (suffixe + "_" + node->children[0]->value == d->value) {
-                    node->children[0]->value = suffixe + "_" + node->children[0]->value;
-                    goto recurNOW;
-                }
-                ++i;
-            }
-        }
-        // si dans ACCESSIBLE_GLOB : += "_"
-        if (std::find(ACCESSIBLE_GLOB.begin(), ACCESSIBLE_GLOB.end(), node->children[0]->value) != ACCESSIBLE_GLOB.end()) {
-            node->children[0]->value = std::string("_") + node->children[0]->value;
-            goto recurNOW;
-        }
-        // sinon erreur sémantique (et pas de modification)
-        m_errorManager.addError({
-            "Call to nonexistent/inaccessible function.",
-            "",
-            "Semantic",
-            std::stoi(node->line)
-        });   
+// ────────────────────────────────────────────────────────────────
+// Résolution d'un appel depuis le corps de `self` (nullptr = programme principal).
+// Sont visibles, dans l'ordre : les fonctions imbriquées de self, self lui-même,
+// les fonctions soeurs définies avant self, puis les fonctions globales déjà définies.
+// ────────────────────────────────────────────────────────────────
+Interner::Id SemanticAnalyzer::resolveCall(Interner::Id callee, const DefinitionContext* self) const {
+    if (self) {
+        const NameScope& nested = m_scopes.back();
+        if (auto it = nested.find(callee); it != nested.end()) return it->second.id;
+        if (callee == self->name) return self->mangled;
+        // portée parente (= portée globale pour une fonction de premier niveau)
+        const NameScope& siblings = m_scopes[m_scopes.size() - 2];
+        if (auto it = siblings.find(callee); it != siblings.end() && it->second.order < self->order) return it->second.id;
     }
+    const NameScope& globals = m_scopes.front();
+    if (auto it = globals.find(callee); it != globals.end() && it->second.order < m_visibleGlobals) return it->second.id;
+    return Interner::kNoId;
+}
 
-    //std::cout << "HERE FDP" << std::endl;
+void SemanticAnalyzer::resolveCalls(ASTNode* node, const DefinitionContext* self) {
+    if (node->kind == NodeKind::FunctionCall) {
+        Interner::Id mangled = resolveCall(node->children[0]->nameId, self);
+        if (mangled != Interner::kNoId) {
+            m_arena.rename(node->children[0], mangled);
+        } else if (!isBuiltin(node->children[0]->value)) {
+            // sinon erreur sémantique (et pas de modification) ; len, list et range, fournies par le
+            // générateur, n'ont pas de définition à trouver
+            m_errorManager.addError({
+                "Call to nonexistent/inaccessible function.",
+                "",
+                "Semantic",
+                node->line
+            });
+        }
+    }
 
     // parcours récursif
-    recurNOW:
     for (auto& child : node->children) {
-        if (child) smallhelpR(child, defnode, parentnode, n, suffixe);
+        if (child) resolveCalls(child, self);
     }
 }
 
-void SemanticAnalyzer::bighelpR(const std::shared_ptr<ASTNode>& defnode, const std::shared_ptr<ASTNode>& parentnode, const int n, std::string suffixe) {
+// Aplatit `defnode` et ses fonctions imbriquées : f imbriquée dans g (dans h) devient hg_f
+void SemanticAnalyzer::flattenDefinition(ASTNode* defnode, const std::string& prefix, const DefinitionContext& self) {
+    Interner& names = m_arena.names();
+    // portée des fonctions imbriquées, toutes visibles depuis le corps
+    std::string nestedPrefix = prefix + std::string(defnode->value);
+    NameScope nested;
+    std::uint32_t order = 0;
+    for (auto& child : defnode->children[1]->children) {
+        nested.emplace(child->nameId, MangledName{names.intern(nestedPrefix + "_" + std::string(child->value)), order++});
+    }
+    m_scopes.push_back(std::move(nested));
+
     // parcours des functioncalls
-    smallhelpR(defnode->children[2], defnode, parentnode, n, suffixe);
+    resolveCalls(defnode->children[2], &self);
     // parcours enfants
-    int i = 0;
+    order = 0;
     for (auto& child : defnode->children[1]->children) {
-        bighelpR(child, defnode, i, suffixe + defnode->value);
-        ++i;
+        Interner::Id mangled = m_scopes.back().at(child->nameId).id;
+        flattenDefinition(child, nestedPrefix, DefinitionContext{child->nameId, mangled, order++});
     }
+    m_scopes.pop_back();
+
     // renommage
-    defnode->value = suffixe + std::string("_") + defnode->value;
+    m_arena.rename(defnode, self.mangled);
     // suppression du noeud definition
-    defnode->children.erase(defnode->children.begin() + 1);
-    // ajout dans NEW_DEF
-    NEW_DEF->children.push_back(defnode);
+    defnode->children.erase(1);
+    // ajout dans la nouvelle liste de définitions
+    m_arena.append(m_flatDefinitions, defnode);
 }
 
-const std::shared_ptr<ASTNode>& SemanticAnalyzer::firstPass(const std::shared_ptr<ASTNode>& root) {
-    NEW_DEF = std::make_shared<ASTNode>("Definitions");
-
-    //std::cout << "HERE 1" << std::endl;
+ASTNode* SemanticAnalyzer::firstPass(ASTNode* root) {
+    Interner& names = m_arena.names();
+    m_flatDefinitions = m_arena.make(NodeKind::Definitions);
+    m_scopes.assign(1, NameScope{});
+    m_visibleGlobals = 0;
 
+    std::uint32_t order = 0;
     for (auto& defnode : root->children[0]->children) {
-        // parcours des functioncalls
-        smallhelpR(defnode->children[2], defnode, nullptr, 0, "");
-        // parcours enfants
-        //std::cout << "HERE 2" << std::endl;
-        int i = 0;
-        for (auto& child : defnode->children[1]->children) {
-            bighelpR(child, defnode, i, defnode->value);
-            ++i;
-        }
-        // ajout dans ACCESSIBLE_GLOB
-        ACCESSIBLE_GLOB.push_back(defnode->value);
-        // renommage
-        defnode->value = "_" + defnode->value;
-        // suppression du noeud definition
-        defnode->children.erase(defnode->children.begin() + 1);
-        // ajout dans NEW_DEF
-        NEW_DEF->children.push_back(defnode);
+        m_scopes.front().emplace(defnode->nameId, MangledName{names.intern("_" + std::string(defnode->value)), order++});
     }
 
-    //std::cout << "HERE 3" << std::endl;
+    for (auto& defnode : root->children[0]->children) {
+        Interner::Id mangled = m_scopes.front().at(defnode->nameId).id;
+        flattenDefinition(defnode, "", DefinitionContext{defnode->nameId, mangled, m_visibleGlobals});
+        // la fonction devient accessible aux définitions suivantes
+        ++m_visibleGlobals;
+    }
 
-    smallhelpR(root->children[1], nullptr, nullptr, 0, "");
-    root->children[0] = NEW_DEF;
+    resolveCalls(root->children[1], nullptr);
+    root->children[0] = m_flatDefinitions;
 
     return root;
 }
 
 // Lance l’analyse sémantique à partir de la racine de l’AST
-void SemanticAnalyzer::checkSemantics(const std::shared_ptr<ASTNode>& root, SymbolTable* globalTable) {
+void SemanticAnalyzer::checkSemantics(ASTNode* root, SymbolTable* globalTable) {
     // Démarre l’analyse depuis la racine de l’arbre syntaxique et la table des symboles globale
     visit(root, globalTable);
 }
 
 // Parcourt récursivement l’AST et déclenche les vérifications sémantiques appropriées
-void SemanticAnalyzer::visit(const std::shared_ptr<ASTNode>& node, SymbolTable* currentScope) {
+void SemanticAnalyzer::visit(ASTNode* node, SymbolTable* currentScope) {
     if (!node) return;
 
     // ---- DÉFINITION DE FONCTION ----
-    if (node->type == "FunctionDefinition") {
+    if (node->kind == NodeKind::FunctionDefinition) {
         checkFunctionRedefinition(node);
 
         // Recherche de la table de symboles locale de la fonction
-        SymbolTable* functionTable = nullptr;
-        for (auto& child : currentScope->children) {
-            if (child->scopeName == "function " + node->value) {
-                functionTable = child.get();
-                break;
-            }
-        }
+        SymbolTable* functionTable = currentScope->findFunctionScope(node->value);
 
         if (!functionTable) {
             return; // Fonction probablement mal construite ou non utilisée, on ignore
@@ -149,57 +130,58 @@ void SemanticAnalyzer::visit(const std::shared_ptr<ASTNode>& node, SymbolTable*
     }
 
     // ---- APPEL DE FONCTION ----
-    if (node->type == "FunctionCall") {
+    if (node->kind == NodeKind::FunctionCall) {
         checkFunctionCall(node, currentScope);
     }
 
     // ---- PRINT PARAMETER CHECK ----
-    if (node->type == "Print") {
+    if (node->kind == NodeKind::Print) {
         if (node->children.empty()) { // Simplified check: direct children are arguments
             m_errorManager.addError({
                 "Print function should be called with at least one parameter.",
                 "",
                 "Semantic",
-                std::stoi(node->line)
+                node->line
             });
         }
     }
 
     // ---- UTILISATION D’IDENTIFICATEUR ----
-    if (node->type == "Identifier") {
+    if (node->kind == NodeKind::Identifier) {
         // Une inférence de types statique n'est pas très efficace ici, mais peut quand même détecter quelques erreurs plus tôt
         // On va préférer la logique dynamique avec "auto" et vérifications directement dans la génération de code
         // TODO : éventuellement faire une fonction de vérification statique de l'utilisation d'une variable avant déclaration
     }
 
     // ---- RETURN PLACEMENT ----
-    if (node->type == "Return") {
+    if (node->kind == NodeKind::Return) {
         checkReturnPlacement(currentScope, node->line);
     }
 
     // ---- FOR LOOP INTERN SHADOWING ----
-    if (node->type == "For") {
-        std::string loopVar = node->children[0]->value;
-        if (std::find(loopVariables.begin(), loopVariables.end(), loopVar) != loopVariables.end()) {
+    if (node->kind == NodeKind::For) {
+        std::string loopVar(node->children[0]->value);
+        if (std::find(m_loopVariables.begin(), m_loopVariables.end(), node->children[0]->nameId) != m_loopVariables.end()) {
             m_errorManager.addError(Error{
                 "Loop variable name already exists in scope: " + currentScope->scopeName + ". Variable shadowing is not allowed: ",
                 loopVar,
                 "semantic",
-                std::stoi(node->line)
+                node->line
             });
         } 
         // Add loop variable to the list of loop variables
-        loopVariables.push_back(loopVar);
+        m_loopVariables.push_back(node->children[0]->nameId);
     }
     // ---- AFFECT IN FOR LOOP ----
-    if (node->type == "Affect") {
-        std::string affectIdent = node->children[0]->value;
-        if (std::find(loopVariables.begin(), loopVariables.end(), affectIdent) != loopVariables.end()) {
+    if (node->kind == NodeKind::Affect) {
+        std::string affectIdent(node->children[0]->value);
+        if (node->children[0]->hasName() &&
+            std::find(m_loopVariables.begin(), m_loopVariables.end(), node->children[0]->nameId) != m_loopVariables.end()) {
             m_errorManager.addError(Error{
                 "You can't affect a variable with this name, shadowing a loop variable is forbidden: ",
                 affectIdent,
                 "Semantic",
-                std::stoi(node->line)
+                node->line
             });
         }
     }
@@ -210,8 +192,8 @@ void SemanticAnalyzer::visit(const std::shared_ptr<ASTNode>& node, SymbolTable*
     }
 
     // ---- SORTIE DU FOR ----
-    if (node->type == "For") {
-        loopVariables.pop_back();
+    if (node->kind == NodeKind::For) {
+        m_loopVariables.pop_back();
     }
 }
 
@@ -219,19 +201,17 @@ void SemanticAnalyzer::visit(const std::shared_ptr<ASTNode>& node, SymbolTable*
 // Vérifie qu’une fonction n’est pas redéfinie ou nommée avec 
 // un mot réservé
 // ────────────────────────────────────────────────────────────────
-void SemanticAnalyzer::checkFunctionRedefinition(const std::shared_ptr<ASTNode>& node) {
+void SemanticAnalyzer::checkFunctionRedefinition(ASTNode* node) {
     // Noms réservés (range, list, len, print) déjà vérifiés dans le parser
 
     // Vérifie si la fonction est déjà définie
-    if (std::find(definedFunctionsNames.begin(), definedFunctionsNames.end(), node->value) != definedFunctionsNames.end()) {
+    if (!m_definedFunctions.insert(node->nameId).second) {
         m_errorManager.addError(Error{
             "Function already defined: ",
-            "A function already exists with the name " + node->value + ".",
+            "A function already exists with the name " + std::string(node->value) + ".",
             "Semantic",
-            std::stoi(node->line)
+            node->line
         });
-    } else {
-        definedFunctionsNames.push_back(node->value);
     }
     return;
 }
@@ -240,41 +220,41 @@ void SemanticAnalyzer::checkFunctionRedefinition(const std::shared_ptr<ASTNode>&
 // Vérifie que l’appel de fonction correspond à une fonction 
 // existante (non encore paramétré pour l’arité)
 // ────────────────────────────────────────────────────────────────
-void SemanticAnalyzer::checkFunctionCall(const std::shared_ptr<ASTNode>& node, SymbolTable* scope){
+void SemanticAnalyzer::checkFunctionCall(ASTNode* node, SymbolTable* scope){
     if (node->children.empty()) return;
     
     auto functionCalled = node->children[0];
     auto paramList = (node->children.size() > 1) ? node->children[1] : nullptr;
 
-    if (kForbiddenNames.count(functionCalled->value)) {
+    if (kForbiddenNames.count(std::string(functionCalled->value))) {
         // Print n'est pas dans un FunctionCall, mais une instruction
         // Verifie que les fonction builtin sont appellées avec le bon nombre de paramètres (1)
         if (paramList && paramList->children.size() != 1) {
             m_errorManager.addError(Error{
-                "Function " + functionCalled->value + " expects exactly one parameter.",
+                "Function " + std::string(functionCalled->value) + " expects exactly one parameter.",
                 "",
                 "Semantic",
-                std::stoi(node->line)
+                node->line
             });
         }
         return;
     }
 
     // vérifie que la fonction appellée a été définie
-    Symbol* sym = findSymbol(functionCalled->value, scope);
-    if (!sym || sym->symCat != "function") {
+    Symbol* sym = findSymbol(std::string(functionCalled->value), scope);
+    if (!sym || sym->kind != SymbolKind::Function) {
         m_errorManager.addError(Error{
             "Function Call Error: ",
-            "Function " + functionCalled->value + " is not defined.",
+            "Function " + std::string(functionCalled->value) + " is not defined.",
             "Semantic", 
-            std::stoi(node->line)
+            node->line
         });
         return;
     }
 
 
     // Vérifie que la fonction est appelée avec le bon nombre de paramètres
-    if (auto fnSym = dynamic_cast<FunctionSymbol*>(sym)) {
+    if (auto fnSym = symbolAs<FunctionSymbol>(sym)) {
         int expected = fnSym->numParams;
         int actual = paramList ? (int)paramList->children.size() : 0;
         if (expected != actual) {
@@ -283,7 +263,7 @@ void SemanticAnalyzer::checkFunctionCall(const std::shared_ptr<ASTNode>& node, S
                         "Function " + fnSym->name + " expects " + std::to_string(expected) + 
                         " arguments, but " + std::to_string(actual) + " were provided.",
                         "Semantic",
-                        std::stoi(node->line)
+                        node->line
                     });
         }
         return;
@@ -293,13 +273,13 @@ void SemanticAnalyzer::checkFunctionCall(const std::shared_ptr<ASTNode>& node, S
 // ────────────────────────────────────────────────────────────────
 // Détecte une instruction return en dehors d’un corps de fonction
 // ────────────────────────────────────────────────────────────────
-void SemanticAnalyzer::checkReturnPlacement(SymbolTable* scope, std::string line){
+void SemanticAnalyzer::checkReturnPlacement(SymbolTable* scope, int line){
     if (!insideFunction(scope)) {
         m_errorManager.addError(Error{
             "Return statement outside of a function.",
             "", 
             "Syntax", 
-            std::stoi(line)
+            line
         });
     }
 }
@@ -313,15 +293,7 @@ void SemanticAnalyzer::checkReturnPlacement(SymbolTable* scope, std::string line
 // et ses parents
 // ────────────────────────────────────────────────────────────────
 Symbol* SemanticAnalyzer::findSymbol(const std::string& name, SymbolTable* table) {
-    for (auto& sPtr : table->symbols) {
-        if (sPtr->name == name) {
-            return sPtr.get();
-        }
-    }
-    if (table->parent) {
-        return findSymbol(name, table->parent);
-    }
-    return nullptr;
+    return table->findSymbol(name);
 }
 
 // ────────────────────────────────────────────────────────────────
@@ -337,16 +309,16 @@ bool SemanticAnalyzer::insideFunction(SymbolTable* tbl){
 // Vérifie qu’un identifiant utilisé est bien défini dans la portée
 // ────────────────────────────────────────────────────────────────
 // Inutilisé
-void SemanticAnalyzer::checkIdentifierInitialization(const std::shared_ptr<ASTNode>& node, SymbolTable* scope) {
-    if (!node || node->type != "Identifier") return;
+void SemanticAnalyzer::checkIdentifierInitialization(ASTNode* node, SymbolTable* scope) {
+    if (!node || node->kind != NodeKind::Identifier) return;
 
-    Symbol* sym = findSymbol(node->value, scope);
+    Symbol* sym = findSymbol(std::string(node->value), scope);
     if (!sym) {
         m_errorManager.addError(Error{
             "Uninitialized identifier: ",
-            node->value,
+            std::string(node->value),
             "Semantic",
-            std::stoi(node->line)
+            node->line
         });
     }
 }
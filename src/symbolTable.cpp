@@ -5,73 +5,98 @@
 #include <set>
 #include <algorithm> 
 #include <functional> 
+#include <chrono>
 
 
 #define RED "\033[31m"
 #define RESET "\033[0m"
 
 
-void SymbolTable::addSymbol(const Symbol& symbol) {
-    for (const auto& symPtr : symbols) {
-        if (symPtr->name == symbol.name) {
-            return;
-        }
-    }
+int frameSizeForLocals(int localsTotalSize) {
+    int callee_saved_bytes = 5 * 8; // rbx, r12, r13, r14, r15
+    int total_stack_usage = localsTotalSize + callee_saved_bytes;
+    int padding_needed = (16 - (total_stack_usage % 16)) % 16;
+    return localsTotalSize + padding_needed;
+}
 
-    std::unique_ptr<Symbol> symClone;
-    if (auto vs = dynamic_cast<const VariableSymbol*>(&symbol)) {
-        symClone = std::make_unique<VariableSymbol>(*vs);
-    } else if (auto fs = dynamic_cast<const FunctionSymbol*>(&symbol)) {
-        symClone = std::make_unique<FunctionSymbol>(*fs);
-    } else if (auto as = dynamic_cast<const ArraySymbol*>(&symbol)) {
-        symClone = std::make_unique<ArraySymbol>(*as);
-    } else {
-        symClone = std::make_unique<Symbol>(symbol);
-    }
-    
+// --- SymbolMap ---
 
+std::size_t SymbolMap::slotOf(Interner::Id id) const {
+    // Hachage de Fibonacci : les ids sont consécutifs, on les disperse sur les bits hauts
+    return static_cast<std::size_t>((static_cast<std::uint64_t>(id) * 0x9E3779B97F4A7C15ull) >> 32) & (m_slots.size() - 1);
+}
 
-    symbols.push_back(std::move(symClone));
+Symbol* SymbolMap::find(Interner::Id id) const {
+    if (m_slots.empty() || id == Interner::kNoId) return nullptr;
+    for (std::size_t i = slotOf(id);; i = (i + 1) & (m_slots.size() - 1)) {
+        const Slot& slot = m_slots[i];
+        if (slot.id == id) return slot.symbol;
+        if (slot.id == Interner::kNoId) return nullptr;
+    }
 }
 
-bool SymbolTable::lookup(const std::string& name) const {
-    for (const auto& s : symbols) {
-        if (s->name == name) return true;
+void SymbolMap::grow() {
+    std::vector<Slot> old = std::move(m_slots);
+    m_slots.assign(old.empty() ? 8 : old.size() * 2, Slot{});
+    for (const Slot& slot : old) {
+        if (slot.id == Interner::kNoId) continue;
+        std::size_t i = slotOf(slot.id);
+        while (m_slots[i].id != Interner::kNoId) i = (i + 1) & (m_slots.size() - 1);
+        m_slots[i] = slot;
     }
-    if (parent) return parent->lookup(name);
-    return false;
 }
 
-Symbol* SymbolTable::findSymbol(const std::string& name) {
-    for (auto& sPtr : symbols) {
-        if (sPtr->name == name) return sPtr.get();
+bool SymbolMap::insert(Interner::Id id, Symbol* symbol) {
+    if ((m_size + 1) * 2 > m_slots.size()) grow();
+    std::size_t i = slotOf(id);
+    while (m_slots[i].id != Interner::kNoId) {
+        if (m_slots[i].id == id) return false;
+        i = (i + 1) & (m_slots.size() - 1);
     }
-    if (parent) return parent->findSymbol(name);
-    return nullptr;
+    m_slots[i] = {id, symbol};
+    ++m_size;
+    return true;
 }
 
-bool SymbolTable::immediateLookup(const std::string& name) const {
-    for (const auto& s : symbols) {
-        if (s->name == name) return true;
+// --- SymbolTable ---
+
+// Un nom jamais interné ne peut désigner aucun symbole
+bool SymbolTable::lookup(std::string_view name) const {
+    Interner::Id id = names->find(name);
+    for (const SymbolTable* table = this; table; table = table->parent) {
+        if (table->index.find(id)) return true;
     }
     return false;
 }
 
-Symbol* SymbolTable::findImmediateSymbol(const std::string& name) {
-    for (auto& sPtr : symbols) {
-        if (sPtr->name == name) return sPtr.get();
+Symbol* SymbolTable::findSymbol(Interner::Id id) const {
+    for (const SymbolTable* table = this; table; table = table->parent) {
+        if (Symbol* s = table->index.find(id)) return s;
     }
     return nullptr;
 }
 
+Symbol* SymbolTable::findSymbol(std::string_view name) const {
+    return findSymbol(names->find(name));
+}
 
-bool SymbolTable::isShadowingParameter(const std::string& name) const {
-    for (const auto& s : symbols) {
-        // Check if 's->symCat' (preferred) or 's->category' is "parameter"
-        if (s->name == name && s->symCat == "parameter")
-            return true;
-    }
-    return false;
+SymbolTable* SymbolTable::findFunctionScope(std::string_view funcName) const {
+    auto* fs = symbolAs<FunctionSymbol>(findSymbol(funcName));
+    return fs ? fs->scope : nullptr;
+}
+
+bool SymbolTable::immediateLookup(std::string_view name) const {
+    return index.find(names->find(name)) != nullptr;
+}
+
+Symbol* SymbolTable::findImmediateSymbol(std::string_view name) const {
+    return findImmediateSymbol(names->find(name));
+}
+
+
+bool SymbolTable::isShadowingParameter(std::string_view name) const {
+    const Symbol* s = index.find(names->find(name));
+    return s && s->kind == SymbolKind::Variable && s->category == "parameter";
 }
 
 void SymbolTable::print(std::ostream& out, int indent) const {
@@ -79,21 +104,28 @@ void SymbolTable::print(std::ostream& out, int indent) const {
     out << indentStr << RED << "Scope: " << RESET << scopeName << ", " << RED <<"id = " << tableID 
         << ", nextDataOffset = " << nextDataOffset << RESET << "\n";
 
-    for (const auto& sPtr : symbols) {
-        Symbol* s = sPtr.get();
+    for (const Symbol* s : symbols) {
         out << indentStr << "  " << s->category << " : " << s->name;
-        if (auto vs = dynamic_cast<VariableSymbol*>(s)) {
-            out << " (type=" << vs->type << ", global=" << (vs->isGlobal ? "true" : "false") 
-                << ", offset: " << vs->offset << ")";
-        } else if (auto fs = dynamic_cast<FunctionSymbol*>(s)) {
-            out << " (returnType=" << fs->returnType << ", numParams=" << fs->numParams
-                << ", frameSize: " << fs->frameSize << ", offset: " << fs->offset 
-                << ", table ID: " << fs->tableID << ")";
-        } else if (auto as = dynamic_cast<ArraySymbol*>(s)) {
-            out << " (elementType=" << as->elementType << ", size=" << as->size 
-                << ", global=" << (as->isGlobal ? "true" : "false") << ", offset: " << as->offset << ")";
-        } else {
-             out << " (offset: " << s->offset << ")";
+        switch (s->kind) {
+            case SymbolKind::Variable: {
+                auto vs = static_cast<const VariableSymbol*>(s);
+                out << " (type=" << vs->type << ", global=" << (vs->isGlobal ? "true" : "false") 
+                    << ", offset: " << vs->offset << ")";
+                break;
+            }
+            case SymbolKind::Function: {
+                auto fs = static_cast<const FunctionSymbol*>(s);
+                out << " (returnType=" << fs->returnType << ", numParams=" << fs->numParams
+                    << ", frameSize: " << fs->frameSize << ", offset: " << fs->offset 
+                    << ", table ID: " << fs->tableID << ")";
+                break;
+            }
+            case SymbolKind::Array: {
+                auto as = static_cast<const ArraySymbol*>(s);
+                out << " (elementType=" << as->elementType << ", size=" << as->size 
+                    << ", global=" << (as->isGlobal ? "true" : "false") << ", offset: " << as->offset << ")";
+                break;
+            }
         }
         out << std::endl;
     }
@@ -105,12 +137,39 @@ void SymbolTable::print(std::ostream& out, int indent) const {
 
 // --- SymbolTableGenerator Implementation ---
 
-SymbolTableGenerator::SymbolTableGenerator(ErrorManager& em) : m_errorManager(em), nextTableIdCounter(0) {}
+namespace {
+// Enfant i, ou nullptr si l'AST est incomplet (récupération d'erreur du parser)
+ASTNode* childAt(const ASTNode* node, std::size_t i) {
+    return i < node->children.size() ? node->children[i] : nullptr;
+}
+
+const NodeList& argsOf(const ASTNode* parameterList) {
+    static const NodeList kNone;
+    return parameterList ? parameterList->children : kNone;
+}
+
+// Nom décoré d'une spécialisation : nom générique, "__", une lettre par type d'argument
+// (i Integer, s String, l List, b Boolean, a auto), par exemple _add__is
+std::string specializationName(std::string_view generic, const std::vector<std::string>& argTypes) {
+    std::string name(generic);
+    name += "__";
+    for (const std::string& type : argTypes) {
+        if (type == "Integer") name += 'i';
+        else if (type == "String") name += 's';
+        else if (type == "List") name += 'l';
+        else if (type == "Boolean") name += 'b';
+        else name += 'a';
+    }
+    return name;
+}
+}
+
+SymbolTableGenerator::SymbolTableGenerator(ErrorManager& em, ASTArena& arena) : m_errorManager(em), m_arena(arena), nextTableIdCounter(0) {}
 
-std::unique_ptr<SymbolTable> SymbolTableGenerator::generate(const std::shared_ptr<ASTNode>& root) {
+std::unique_ptr<SymbolTable> SymbolTableGenerator::generate(ASTNode* root) {
     nextTableIdCounter = 0; 
     processedFunctionNames.clear();
-    auto globalTable = std::make_unique<SymbolTable>("global", nullptr, nextTableIdCounter++);
+    auto globalTable = std::make_unique<SymbolTable>("global", nullptr, nextTableIdCounter++, &m_arena.names());
     
     if (root) { 
         for (const auto& childNode : root->children) {
@@ -118,25 +177,25 @@ std::unique_ptr<SymbolTable> SymbolTableGenerator::generate(const std::shared_pt
         }
     }
 
-    // inferTypes(root, globalTable.get());
+    inferTypes(root, globalTable.get());
 
     return globalTable;
 }
 
-void SymbolTableGenerator::buildScopesAndSymbols(const std::shared_ptr<ASTNode>& node, SymbolTable* globalTable, SymbolTable* currentScopeTable) {
+void SymbolTableGenerator::buildScopesAndSymbols(ASTNode* node, SymbolTable* globalTable, SymbolTable* currentScopeTable) {
     if (!node) return;
 
-    if (node->type == "FunctionDefinition") {
-    std::string funcName = node->value;
+    if (node->kind == NodeKind::FunctionDefinition) {
+    std::string funcName(node->value);
     
     if (processedFunctionNames.count(funcName)) {
-        m_errorManager.addError({"Function already defined: ", funcName, "Semantic", std::stoi(node->line)});
+        m_errorManager.addError({"Function already defined: ", funcName, "Semantic", node->line});
         return; 
     }
     processedFunctionNames.insert(funcName);
     
     int numParams = 0;
-    if (node->children.size() > 0 && node->children[0]->type == "FormalParameterList") {
+    if (node->children.size() > 0 && node->children[0]->kind == NodeKind::FormalParameterList) {
         numParams = node->children[0]->children.size();
     }
     
@@ -146,16 +205,15 @@ void SymbolTableGenerator::buildScopesAndSymbols(const std::shared_ptr<ASTNode>&
     
     // Traiter les paramètres
     int paramOffset = 16; // First parameter at [RBP+16]
-    if (node->children.size() > 0 && node->children[0]->type == "FormalParameterList") {
+    if (node->children.size() > 0 && node->children[0]->kind == NodeKind::FormalParameterList) {
         for (const auto& paramNode : node->children[0]->children) {
-            VariableSymbol param(paramNode->value, "auto", "parameter", false, paramOffset); 
-            funcScopePtr->addSymbol(param);
+            funcScopePtr->addSymbol<VariableSymbol>(std::string(paramNode->value), "auto", "parameter", false, paramOffset);
             paramOffset += 8; 
         }
     }
     // Trouver les variables locales et leur attribuer des offsets
     int localStartOffset = -8;
-    if (node->children.size() > 1 && node->children[1]->type == "FunctionBody") {
+    if (node->children.size() > 1 && node->children[1]->kind == NodeKind::FunctionBody) {
         discoverLocalsAndAssignOffsets(node->children[1], funcScopePtr, localStartOffset);
     }
     
@@ -163,44 +221,40 @@ void SymbolTableGenerator::buildScopesAndSymbols(const std::shared_ptr<ASTNode>&
     std::string returnType = inferFunctionReturnType(node, funcScopePtr);
     
     // Créer le symbole de fonction avec le type de retour inféré
-    FunctionSymbol funcSym(funcName, returnType, numParams, 0, 0, 0);
-    globalTable->addSymbol(funcSym);
-    FunctionSymbol* addedFuncSym = dynamic_cast<FunctionSymbol*>(globalTable->findImmediateSymbol(funcName));
+    FunctionSymbol* addedFuncSym = globalTable->addSymbol<FunctionSymbol>(funcName, returnType, numParams, 0, 0, 0);
     
     if (!addedFuncSym) { return; }
     
     addedFuncSym->tableID = functionScope->tableID;
+    addedFuncSym->scope = funcScopePtr;
     
     // Calcul de la taille du frame
     int localsTotalSize = (localStartOffset == -8) ? 0 : -(localStartOffset + 8);
-    int callee_saved_bytes = 5 * 8; // rbx, r12, r13, r14, r15
-    int total_stack_usage = localsTotalSize + callee_saved_bytes;
-    int padding_needed = (16 - (total_stack_usage % 16)) % 16;
-    addedFuncSym->frameSize = localsTotalSize + padding_needed;
+    addedFuncSym->frameSize = frameSizeForLocals(localsTotalSize);
     
     globalTable->children.push_back(std::move(functionScope));
-} else if (node->type == "Affect") {
-        if (node->children.size() >= 2 && node->children[0]->type == "Identifier") {
-            std::string varName = node->children[0]->value;
-            std::shared_ptr<ASTNode> rhsNode = node->children[1];
+} else if (node->kind == NodeKind::Affect) {
+        if (node->children.size() >= 2 && node->children[0]->kind == NodeKind::Identifier) {
+            std::string varName(node->children[0]->value);
+            ASTNode* rhsNode = node->children[1];
             
             std::string rhsInferredType = "auto"; // Default
-            if (rhsNode->type == "List") {
+            if (rhsNode->kind == NodeKind::List) {
                 rhsInferredType = "List";
-            } else if (rhsNode->type == "String") { 
+            } else if (rhsNode->kind == NodeKind::String) { 
                 rhsInferredType = "String";
-            } else if (rhsNode->type == "Integer") {
+            } else if (rhsNode->kind == NodeKind::Integer) {
                 rhsInferredType = "Integer";
-            } else if (rhsNode->type == "True" || rhsNode->type == "False") {
+            } else if (rhsNode->kind == NodeKind::True || rhsNode->kind == NodeKind::False) {
                 rhsInferredType = "Boolean";
-            } else if (rhsNode->type == "Identifier") {
+            } else if (rhsNode->kind == NodeKind::Identifier) {
                 Symbol* s = currentScopeTable->findSymbol(rhsNode->value);
                 if (s) {
-                    if(auto vs = dynamic_cast<VariableSymbol*>(s)) rhsInferredType = vs->type;
-                    else if(auto fs = dynamic_cast<FunctionSymbol*>(s)) rhsInferredType = fs->returnType; 
+                    if(auto vs = symbolAs<VariableSymbol>(s)) rhsInferredType = vs->type;
+                    else if(auto fs = symbolAs<FunctionSymbol>(s)) rhsInferredType = fs->returnType; 
                 }
-            } else if (rhsNode->type == "FunctionCall") {
-                if (!rhsNode->children.empty() && rhsNode->children[0]->type == "Identifier") {
+            } else if (rhsNode->kind == NodeKind::FunctionCall) {
+                if (!rhsNode->children.empty() && rhsNode->children[0]->kind == NodeKind::Identifier) {
                     if (rhsNode->children[0]->value == "list") {
                         rhsInferredType = "List"; 
                     }
@@ -209,54 +263,54 @@ void SymbolTableGenerator::buildScopesAndSymbols(const std::shared_ptr<ASTNode>&
                     }
                     else{
                         Symbol* s = globalTable->findSymbol(rhsNode->children[0]->value); 
-                        if (s && dynamic_cast<FunctionSymbol*>(s)) {
-                            rhsInferredType = dynamic_cast<FunctionSymbol*>(s)->returnType;
+                        if (s && symbolAs<FunctionSymbol>(s)) {
+                            rhsInferredType = symbolAs<FunctionSymbol>(s)->returnType;
                         } else {
 
                             rhsInferredType = "auto"; 
                         }
                     }
                 }
-            } else if (rhsNode->type == "ArithOp" || rhsNode->type == "TermOp" || rhsNode->type == "Compare" || rhsNode->type == "And" || rhsNode->type == "Or" || rhsNode->type == "Not" || rhsNode->type == "UnaryOp") {
+            } else if (rhsNode->kind == NodeKind::ArithOp || rhsNode->kind == NodeKind::TermOp || rhsNode->kind == NodeKind::Compare || rhsNode->kind == NodeKind::And || rhsNode->kind == NodeKind::Or || rhsNode->kind == NodeKind::Not || rhsNode->kind == NodeKind::UnaryOp) {
 
-                if (rhsNode->type == "Compare" || rhsNode->type == "And" || rhsNode->type == "Or" || rhsNode->type == "Not") {
+                if (rhsNode->kind == NodeKind::Compare || rhsNode->kind == NodeKind::And || rhsNode->kind == NodeKind::Or || rhsNode->kind == NodeKind::Not) {
                     rhsInferredType = "Boolean";
                 } else {
                     // Pour ArithOp et TermOp, déterminer le type en fonction des opérandes
                     rhsInferredType = "Integer"; // Type par défaut
                     
                     // Fonction récursive pour déterminer le type d'une expression
-                    std::function<std::string(const std::shared_ptr<ASTNode>&)> inferExprType = 
-                        [&](const std::shared_ptr<ASTNode>& expr) -> std::string {
+                    std::function<std::string(ASTNode*)> inferExprType = 
+                        [&](ASTNode* expr) -> std::string {
                             if (!expr) return "auto";
                             
-                            if (expr->type == "Integer") return "Integer";
-                            if (expr->type == "String") return "String";
-                            if (expr->type == "List") return "List";
-                            if (expr->type == "True" || expr->type == "False") return "Boolean";
+                            if (expr->kind == NodeKind::Integer) return "Integer";
+                            if (expr->kind == NodeKind::String) return "String";
+                            if (expr->kind == NodeKind::List) return "List";
+                            if (expr->kind == NodeKind::True || expr->kind == NodeKind::False) return "Boolean";
                             
-                            if (expr->type == "Identifier") {
+                            if (expr->kind == NodeKind::Identifier) {
                                 Symbol* s = currentScopeTable->findSymbol(expr->value);
-                                if (s && dynamic_cast<VariableSymbol*>(s)) {
-                                    return dynamic_cast<VariableSymbol*>(s)->type;
+                                if (s && symbolAs<VariableSymbol>(s)) {
+                                    return symbolAs<VariableSymbol>(s)->type;
                                 }
                                 return "auto";
                             }
                             
-                            if (expr->type == "FunctionCall" && !expr->children.empty() && 
-                                expr->children[0]->type == "Identifier") {
-                                std::string funcName = expr->children[0]->value;
+                            if (expr->kind == NodeKind::FunctionCall && !expr->children.empty() && 
+                                expr->children[0]->kind == NodeKind::Identifier) {
+                                std::string funcName(expr->children[0]->value);
                                 if (funcName == "list") return "List";
                                 if (funcName == "len") return "Integer";
                                 
                                 Symbol* s = globalTable->findSymbol(funcName);
-                                if (s && dynamic_cast<FunctionSymbol*>(s)) {
-                                    return dynamic_cast<FunctionSymbol*>(s)->returnType;
+                                if (s && symbolAs<FunctionSymbol>(s)) {
+                                    return symbolAs<FunctionSymbol>(s)->returnType;
                                 }
                             }
                             
                             // Cas récursifs pour les expressions
-                            if ((expr->type == "ArithOp" || expr->type == "TermOp") && !expr->children.empty()) {
+                            if ((expr->kind == NodeKind::ArithOp || expr->kind == NodeKind::TermOp) && !expr->children.empty()) {
                                 std::string leftType = "auto", rightType = "auto";
                                 if (expr->children.size() > 0) leftType = inferExprType(expr->children[0]);
                                 if (expr->children.size() > 1) rightType = inferExprType(expr->children[1]);
@@ -275,7 +329,7 @@ void SymbolTableGenerator::buildScopesAndSymbols(const std::shared_ptr<ASTNode>&
                                 return "Integer"; // Par défaut, on suppose que c'est un entier
                             }
                             
-                            if (expr->type == "UnaryOp" && !expr->children.empty()) {
+                            if (expr->kind == NodeKind::UnaryOp && !expr->children.empty()) {
                                 // Pour les opérations unaires, le type est généralement conservé
                                 return inferExprType(expr->children[0]);
                             }
@@ -291,7 +345,7 @@ void SymbolTableGenerator::buildScopesAndSymbols(const std::shared_ptr<ASTNode>&
 
             Symbol* symToUpdate = currentScopeTable->findSymbol(varName);
             if (symToUpdate) {
-                if (auto vs = dynamic_cast<VariableSymbol*>(symToUpdate)) {
+                if (auto vs = symbolAs<VariableSymbol>(symToUpdate)) {
                     // Update type if current is 'auto' or if new type is more specific than 'auto'
                     if ((vs->type == "auto" && rhsInferredType != "auto") || (rhsInferredType != "auto")) {
                         vs->type = rhsInferredType;
@@ -300,43 +354,37 @@ void SymbolTableGenerator::buildScopesAndSymbols(const std::shared_ptr<ASTNode>&
             } else {
                 if (currentScopeTable->scopeName == "global") {
                     std::string newGlobalType = (rhsInferredType != "auto") ? rhsInferredType : "Integer";
-                    VariableSymbol globalVar(varName, newGlobalType, "global", true, 0); 
-                    currentScopeTable->addSymbol(globalVar);
+                    currentScopeTable->addSymbol<VariableSymbol>(varName, newGlobalType, "global", true, 0);
                 } else {
-                     m_errorManager.addError({"Assignment to undeclared local variable (should be pre-declared by discoverLocals): ", varName, "Semantic", std::stoi(node->line)});
+                     m_errorManager.addError({"Assignment to undeclared local variable (should be pre-declared by discoverLocals): ", varName, "Semantic", node->line});
                 }
             }
         }
-    }else if (node->type == "For") {
-    if (node->children.size() >= 1 && node->children[0]->type == "Identifier") {
-        std::string loopVarName = node->children[0]->value;
+    }else if (node->kind == NodeKind::For) {
+    if (node->children.size() >= 1 && node->children[0]->kind == NodeKind::Identifier) {
+        std::string loopVarName(node->children[0]->value);
         
-        for (const auto& sym : currentScopeTable->symbols) {
-            if (sym->name == loopVarName) {
-                m_errorManager.addError({"Variable de boucle for masque une variable existante: ", 
-                                         loopVarName, "Semantic", std::stoi(node->line)});
-                break;
-            }
+        if (currentScopeTable->findImmediateSymbol(loopVarName)) {
+            m_errorManager.addError({"Variable de boucle for masque une variable existante: ", 
+                                     loopVarName, "Semantic", node->line});
         }
 
         bool isGlobal = (currentScopeTable->scopeName == "global");
         
         if (isGlobal) {
             int offset = currentScopeTable->nextDataOffset;
-            VariableSymbol loopVar(loopVarName, "Integer", "variable", offset, true);
-            currentScopeTable->addSymbol(loopVar);
+            currentScopeTable->addSymbol<VariableSymbol>(loopVarName, "Integer", "variable", offset, true);
             currentScopeTable->nextDataOffset += 8; 
         } else {
             int offset = -8; 
-            for (const auto& sym : currentScopeTable->symbols) {
-                if (auto vs = dynamic_cast<VariableSymbol*>(sym.get())) {
+            for (Symbol* sym : currentScopeTable->symbols) {
+                if (auto vs = symbolAs<VariableSymbol>(sym)) {
                     if (!vs->isGlobal && vs->offset <= offset) {
                         offset = vs->offset - 8;
                     }
                 }
             }
-            VariableSymbol loopVar(loopVarName, "Integer", "variable", offset, false);
-            currentScopeTable->addSymbol(loopVar);
+            currentScopeTable->addSymbol<VariableSymbol>(loopVarName, "Integer", "variable", offset, false);
         }
         
         if (node->children.size() >= 2) {
@@ -346,16 +394,16 @@ void SymbolTableGenerator::buildScopesAndSymbols(const std::shared_ptr<ASTNode>&
         if (node->children.size() >= 3) {
             buildScopesAndSymbols(node->children[2], globalTable, currentScopeTable);
         }
-    }else if (node->type == "ListCall") {
-    const std::string& listName = node->children[0]->value;      // L in  L[i]
+    }else if (node->kind == NodeKind::ListCall) {
+    std::string_view listName = node->children[0]->value;      // L in  L[i]
     if (Symbol* s = currentScopeTable->findSymbol(listName)) {
-        if (auto *vs = dynamic_cast<VariableSymbol*>(s)) {
+        if (auto *vs = symbolAs<VariableSymbol>(s)) {
             vs->type = "List";                                    
         }
     }
 } else {
         m_errorManager.addError({"Boucle for mal formée, identificateur attendu: ", 
-                                 "", "Semantic", std::stoi(node->line)});
+                                 "", "Semantic", node->line});
     }
 } 
     else { 
@@ -365,31 +413,31 @@ void SymbolTableGenerator::buildScopesAndSymbols(const std::shared_ptr<ASTNode>&
     }
 }
 
-void SymbolTableGenerator::discoverLocalsAndAssignOffsets(const std::shared_ptr<ASTNode>& bodyNode, SymbolTable* functionScopeTable, int& currentLocalOffset) {
+void SymbolTableGenerator::discoverLocalsAndAssignOffsets(ASTNode* bodyNode, SymbolTable* functionScopeTable, int& currentLocalOffset) {
     if (!bodyNode) return;
 
-    if (bodyNode->type == "Affect") {
-        if (bodyNode->children.size() >= 1 && bodyNode->children[0]->type == "Identifier") {
-            std::string varName = bodyNode->children[0]->value;
-            std::shared_ptr<ASTNode> rhsNode = bodyNode->children[1];
+    if (bodyNode->kind == NodeKind::Affect) {
+        if (bodyNode->children.size() >= 1 && bodyNode->children[0]->kind == NodeKind::Identifier) {
+            std::string varName(bodyNode->children[0]->value);
+            ASTNode* rhsNode = bodyNode->children[1];
             
             std::string rhsInferredType = "auto";
-            if (rhsNode->type == "List") {
+            if (rhsNode->kind == NodeKind::List) {
                 rhsInferredType = "List";
-            } else if (rhsNode->type == "String") { 
+            } else if (rhsNode->kind == NodeKind::String) { 
                 rhsInferredType = "String";
-            } else if (rhsNode->type == "Integer") {
+            } else if (rhsNode->kind == NodeKind::Integer) {
                 rhsInferredType = "Integer";
-            } else if (rhsNode->type == "True" || rhsNode->type == "False") {
+            } else if (rhsNode->kind == NodeKind::True || rhsNode->kind == NodeKind::False) {
                 rhsInferredType = "Boolean";
-            } else if (rhsNode->type == "Identifier") {
+            } else if (rhsNode->kind == NodeKind::Identifier) {
                 Symbol* s = functionScopeTable->findSymbol(rhsNode->value);
                 if (s) {
-                    if(auto vs = dynamic_cast<VariableSymbol*>(s)) rhsInferredType = vs->type;
-                    else if(auto fs = dynamic_cast<FunctionSymbol*>(s)) rhsInferredType = fs->returnType; 
+                    if(auto vs = symbolAs<VariableSymbol>(s)) rhsInferredType = vs->type;
+                    else if(auto fs = symbolAs<FunctionSymbol>(s)) rhsInferredType = fs->returnType; 
                 }
-            } else if (rhsNode->type == "FunctionCall") {
-                if (!rhsNode->children.empty() && rhsNode->children[0]->type == "Identifier") {
+            } else if (rhsNode->kind == NodeKind::FunctionCall) {
+                if (!rhsNode->children.empty() && rhsNode->children[0]->kind == NodeKind::Identifier) {
                     if (rhsNode->children[0]->value == "list") {
                         rhsInferredType = "List"; 
                     }
@@ -398,16 +446,16 @@ void SymbolTableGenerator::discoverLocalsAndAssignOffsets(const std::shared_ptr<
                     }
                     else{
                         Symbol* s = functionScopeTable->parent->findSymbol(rhsNode->children[0]->value); 
-                        if (s && dynamic_cast<FunctionSymbol*>(s)) {
-                            rhsInferredType = dynamic_cast<FunctionSymbol*>(s)->returnType;
+                        if (s && symbolAs<FunctionSymbol>(s)) {
+                            rhsInferredType = symbolAs<FunctionSymbol>(s)->returnType;
                         } else {
                             rhsInferredType = "auto"; 
                         }
                     }
                 }
-            } else if (rhsNode->type == "ArithOp" || rhsNode->type == "TermOp" || rhsNode->type == "Compare" || rhsNode->type == "And" || rhsNode->type == "Or" || rhsNode->type == "Not" || rhsNode->type == "UnaryOp") {
+            } else if (rhsNode->kind == NodeKind::ArithOp || rhsNode->kind == NodeKind::TermOp || rhsNode->kind == NodeKind::Compare || rhsNode->kind == NodeKind::And || rhsNode->kind == NodeKind::Or || rhsNode->kind == NodeKind::Not || rhsNode->kind == NodeKind::UnaryOp) {
 
-                if (rhsNode->type == "Compare" || rhsNode->type == "And" || rhsNode->type == "Or" || rhsNode->type == "Not") {
+                if (rhsNode->kind == NodeKind::Compare || rhsNode->kind == NodeKind::And || rhsNode->kind == NodeKind::Or || rhsNode->kind == NodeKind::Not) {
                     rhsInferredType = "Boolean";
                 } else {
                     rhsInferredType = "Integer"; 
@@ -415,18 +463,16 @@ void SymbolTableGenerator::discoverLocalsAndAssignOffsets(const std::shared_ptr<
             }
 
             if (!functionScopeTable->findImmediateSymbol(varName)) {
-                VariableSymbol localVar(varName, rhsInferredType, "variable", false, currentLocalOffset); 
-                functionScopeTable->addSymbol(localVar);
+                functionScopeTable->addSymbol<VariableSymbol>(varName, rhsInferredType, "variable", false, currentLocalOffset);
                 currentLocalOffset -= 8; // Next local goes further down the stack
             }
         }
-    } else if (bodyNode->type == "For") { 
-        if (bodyNode->children.size() >= 1 && bodyNode->children[0]->type == "Identifier") {
-            std::string loopVarName = bodyNode->children[0]->value;
+    } else if (bodyNode->kind == NodeKind::For) { 
+        if (bodyNode->children.size() >= 1 && bodyNode->children[0]->kind == NodeKind::Identifier) {
+            std::string loopVarName(bodyNode->children[0]->value);
             if (!functionScopeTable->findImmediateSymbol(loopVarName)) {
 
-                 VariableSymbol lv(loopVarName, "Integer", "variable", false, currentLocalOffset);
-                 functionScopeTable->addSymbol(lv);
+                 functionScopeTable->addSymbol<VariableSymbol>(loopVarName, "Integer", "variable", false, currentLocalOffset);
                  currentLocalOffset -= 8;
             }
         }
@@ -444,25 +490,25 @@ void SymbolTableGenerator::discoverLocalsAndAssignOffsets(const std::shared_ptr<
 }
 
 
-std::shared_ptr<ASTNode> SymbolTableGenerator::findFunctionDefNode(const std::shared_ptr<ASTNode>& astRoot, const std::string& funcName) {
+ASTNode* SymbolTableGenerator::findFunctionDefNode(ASTNode* astRoot, const std::string& funcName) {
     if (!astRoot) return nullptr;
     for (const auto& node : astRoot->children) {
-        if (node->type == "FunctionDefinition" && node->value == funcName) {
+        if (node->kind == NodeKind::FunctionDefinition && node->value == funcName) {
             return node;
         }
     }
     return nullptr;
 }
 
-std::string SymbolTableGenerator::inferFunctionReturnType(const std::shared_ptr<ASTNode>& funcDefNode, SymbolTable* functionScope) {
+std::string SymbolTableGenerator::inferFunctionReturnType(ASTNode* funcDefNode, SymbolTable* functionScope) {
     std::string inferredType = "autoFun"; 
     
 
-    std::function<void(const std::shared_ptr<ASTNode>&)> findReturns = 
-        [&](const std::shared_ptr<ASTNode>& node) {
+    std::function<void(ASTNode*)> findReturns = 
+        [&](ASTNode* node) {
             if (!node) return;
             
-            if (node->type == "Return") {
+            if (node->kind == NodeKind::Return) {
 
                 if (node->children.empty()) {
                     inferredType = "void";
@@ -470,45 +516,45 @@ std::string SymbolTableGenerator::inferFunctionReturnType(const std::shared_ptr<
                 }
             
 
-                std::shared_ptr<ASTNode> returnExpr = node->children[0];
+                ASTNode* returnExpr = node->children[0];
                 std::string exprType = "auto";
 
-                if (returnExpr->type == "List") {
+                if (returnExpr->kind == NodeKind::List) {
                     exprType = "List";
-                } else if (returnExpr->type == "String") {
+                } else if (returnExpr->kind == NodeKind::String) {
                     exprType = "String";
-                } else if (returnExpr->type == "Integer") {
+                } else if (returnExpr->kind == NodeKind::Integer) {
                     exprType = "Integer";
-                } else if (returnExpr->type == "True" || returnExpr->type == "False") {
+                } else if (returnExpr->kind == NodeKind::True || returnExpr->kind == NodeKind::False) {
                     exprType = "Boolean";
-                } else if (returnExpr->type == "Identifier") {
+                } else if (returnExpr->kind == NodeKind::Identifier) {
 
                     Symbol* s = functionScope->findSymbol(returnExpr->value);
                     if (s) {
-                        if (auto vs = dynamic_cast<VariableSymbol*>(s))
+                        if (auto vs = symbolAs<VariableSymbol>(s))
                             exprType = vs->type;
-                        else if (auto fs = dynamic_cast<FunctionSymbol*>(s))
+                        else if (auto fs = symbolAs<FunctionSymbol>(s))
                             exprType = fs->returnType;
                     }
-                } else if (returnExpr->type == "FunctionCall") {
-                    if (!returnExpr->children.empty() && returnExpr->children[0]->type == "Identifier") {
+                } else if (returnExpr->kind == NodeKind::FunctionCall) {
+                    if (!returnExpr->children.empty() && returnExpr->children[0]->kind == NodeKind::Identifier) {
 
-                        std::string funcName = returnExpr->children[0]->value;
+                        std::string funcName(returnExpr->children[0]->value);
                         if (funcName == "list") {
                             exprType = "List";
                         } else if (funcName == "len") {
                             exprType = "Integer";
                         } else {
                             Symbol* s = functionScope->parent->findSymbol(funcName);
-                            if (s && dynamic_cast<FunctionSymbol*>(s)) {
-                                exprType = dynamic_cast<FunctionSymbol*>(s)->returnType;
+                            if (s && symbolAs<FunctionSymbol>(s)) {
+                                exprType = symbolAs<FunctionSymbol>(s)->returnType;
                             }
                         }
                     }
-                } else if (returnExpr->type == "ArithOp" || returnExpr->type == "TermOp") {
+                } else if (returnExpr->kind == NodeKind::ArithOp || returnExpr->kind == NodeKind::TermOp) {
                     exprType = "Integer"; 
-                } else if (returnExpr->type == "Compare" || returnExpr->type == "And" || 
-                           returnExpr->type == "Or" || returnExpr->type == "Not") {
+                } else if (returnExpr->kind == NodeKind::Compare || returnExpr->kind == NodeKind::And || 
+                           returnExpr->kind == NodeKind::Or || returnExpr->kind == NodeKind::Not) {
                     exprType = "Boolean";
                 }
                 
@@ -526,7 +572,7 @@ std::string SymbolTableGenerator::inferFunctionReturnType(const std::shared_ptr<
         };
     
     // Start the recursive search for return statements in the function body
-    if (funcDefNode->children.size() > 1 && funcDefNode->children[1]->type == "FunctionBody") {
+    if (funcDefNode->children.size() > 1 && funcDefNode->children[1]->kind == NodeKind::FunctionBody) {
         findReturns(funcDefNode->children[1]);
     }
     
@@ -534,206 +580,218 @@ std::string SymbolTableGenerator::inferFunctionReturnType(const std::shared_ptr<
 }
 
 
-std::string SymbolTableGenerator::statementInference(const std::shared_ptr<ASTNode>& def, SymbolTable* globalTable, const std::shared_ptr<ASTNode>& node, SymbolTable* currentTable, std::string type) {
-    if (node->type == "Integer") return "Integer";
-    else if (node->type == "String") return "String";
-    else if (node->type == "List") {
+std::string SymbolTableGenerator::statementInference(ASTNode* def, SymbolTable* globalTable, ASTNode* node, SymbolTable* currentTable, std::string type) {
+    if (!node) return "auto"; // AST partiel après une erreur de syntaxe
+    if (node->kind == NodeKind::Integer) return "Integer";
+    else if (node->kind == NodeKind::String) return "String";
+    else if (node->kind == NodeKind::List) {
         for (const auto& c : node->children) {
             if (c)
                 statementInference(def, globalTable, c, currentTable, "auto");
         }
         return "List";
     }
-    else if (node->type == "True" or node->type == "False") return "Boolean";
+    else if (node->kind == NodeKind::True or node->kind == NodeKind::False) return "Boolean";
     // todo : Compare pourrait être plus informatif (mais on n'a pas les routines assembleurs pour comparer string/list donc pour l'instant...)
-    else if (node->type == "Or" or node->type == "And" or node->type == "Compare") {
-        statementInference(def, globalTable, node->children[0], currentTable, "auto");
-        statementInference(def, globalTable, node->children[1], currentTable, "auto");
+    else if (node->kind == NodeKind::Or or node->kind == NodeKind::And or node->kind == NodeKind::Compare) {
+        statementInference(def, globalTable, childAt(node, 0), currentTable, "auto");
+        statementInference(def, globalTable, childAt(node, 1), currentTable, "auto");
         return "Boolean";
     }
-    else if (node->type == "Or" or node->type == "Not") {
-        statementInference(def, globalTable, node->children[0], currentTable, "auto");
+    else if (node->kind == NodeKind::Or or node->kind == NodeKind::Not) {
+        statementInference(def, globalTable, childAt(node, 0), currentTable, "auto");
         return "Boolean";
     }
-    else if (node->type == "None") return "auto";
-    else if (node->type == "Identifier") {
-        auto symb = dynamic_cast<VariableSymbol*>(currentTable->findSymbol(node->value));
-        if (symb->type == "auto") symb->type = type;
+    else if (node->kind == NodeKind::None) return "auto";
+    else if (node->kind == NodeKind::Identifier) {
+        auto symb = symbolAs<VariableSymbol>(currentTable->findSymbol(node->value));
+        if (!symb) return "auto"; // nom inconnu ou fonction : signalé par l'analyse sémantique
+        dependsOn(symb);
+        if (symb->type == "auto" && type != "auto") {
+            symb->type = type;
+            typeChanged(symb);
+        }
         return symb->type;
     }
-    else if (node->type == "TermOp") {
-        statementInference(def, globalTable, node->children[0], currentTable, "Integer");
-        statementInference(def, globalTable, node->children[1], currentTable, "Integer");
+    else if (node->kind == NodeKind::TermOp) {
+        statementInference(def, globalTable, childAt(node, 0), currentTable, "Integer");
+        statementInference(def, globalTable, childAt(node, 1), currentTable, "Integer");
         return "Integer";
     }
-    else if (node->type == "UnaryOp") {
-        statementInference(def, globalTable, node->children[0], currentTable, "Integer");
+    else if (node->kind == NodeKind::UnaryOp) {
+        statementInference(def, globalTable, childAt(node, 0), currentTable, "Integer");
         return "Integer";
     }
-    else if (node->type == "ArithOp") {
+    else if (node->kind == NodeKind::ArithOp) {
         if (node->value == "+") {
-            std::string ret1 = statementInference(def, globalTable, node->children[0], currentTable, type);
-            std::string ret2 = statementInference(def, globalTable, node->children[1], currentTable, type);
+            std::string ret1 = statementInference(def, globalTable, childAt(node, 0), currentTable, type);
+            std::string ret2 = statementInference(def, globalTable, childAt(node, 1), currentTable, type);
             if (ret1 == "auto" and ret2 != "auto") {
-                statementInference(def, globalTable, node->children[0], currentTable, ret2);
+                statementInference(def, globalTable, childAt(node, 0), currentTable, ret2);
                 return ret2;
             }
             else if (ret1 != "auto" and ret2 == "auto") {
-                statementInference(def, globalTable, node->children[1], currentTable, ret1);
+                statementInference(def, globalTable, childAt(node, 1), currentTable, ret1);
                 return ret1;
             }
             else return ret1;
         }
         else {
-            statementInference(def, globalTable, node->children[0], currentTable, "Integer");
-            statementInference(def, globalTable, node->children[1], currentTable, "Integer");
+            statementInference(def, globalTable, childAt(node, 0), currentTable, "Integer");
+            statementInference(def, globalTable, childAt(node, 1), currentTable, "Integer");
             return "Integer";
         }
     }
-    else if (node->type == "ListCall") {
-        statementInference(def, globalTable, node->children[0], currentTable, "List");
-        statementInference(def, globalTable, node->children[1], currentTable, "Integer");
+    else if (node->kind == NodeKind::ListCall) {
+        statementInference(def, globalTable, childAt(node, 0), currentTable, "List");
+        statementInference(def, globalTable, childAt(node, 1), currentTable, "Integer");
         return "Integer";
     }
-    else if (node->type == "Return") {
+    else if (node->kind == NodeKind::Return) {
         if (!node->children.empty() and node->children[0]) {
-            std::string v = statementInference(def, globalTable, node->children[0], currentTable, "auto");
-            if (v != "auto") {
-                dynamic_cast<FunctionSymbol*>(globalTable->findSymbol(currentTable->scopeName.substr(9)))->returnType = v;
+            std::string v = statementInference(def, globalTable, childAt(node, 0), currentTable, "auto");
+            FunctionSymbol* fs = nullptr;
+            if (currentTable->scopeName.rfind("function ", 0) == 0) {
+                fs = symbolAs<FunctionSymbol>(globalTable->findSymbol(currentTable->scopeName.substr(9)));
+            }
+            // le premier type connu l'emporte : chaque type ne change qu'une fois, le point fixe termine
+            if (fs && v != "auto" && fs->returnType == "auto") {
+                fs->returnType = v;
+                typeChanged(fs);
             }
         }
         return "auto";
     }
-    else if (node->type == "Affect") {
-        auto v = statementInference(def, globalTable, node->children[1], currentTable, "auto");
-        statementInference(def, globalTable, node->children[0], currentTable, v);
+    else if (node->kind == NodeKind::For) {
+        // comme buildScopesAndSymbols : on itère sur une liste, la variable de boucle est un entier
+        statementInference(def, globalTable, childAt(node, 1), currentTable, "List");
+        statementInference(def, globalTable, childAt(node, 0), currentTable, "Integer");
+        statementInference(def, globalTable, childAt(node, 2), currentTable, "auto");
+        return "auto";
+    }
+    else if (node->kind == NodeKind::Affect) {
+        auto v = statementInference(def, globalTable, childAt(node, 1), currentTable, "auto");
+        statementInference(def, globalTable, childAt(node, 0), currentTable, v);
         return v;
     }
-    else if (node->type == "FunctionCall") {
-        if (node->children[0]->value == "list") {
-            for (const auto& param : node->children[1]->children) {
+    else if (node->kind == NodeKind::FunctionCall) {
+        ASTNode* callee = childAt(node, 0);
+        ASTNode* args = childAt(node, 1);
+        if (!callee) return "auto";
+        if (callee->value == "list") {
+            for (const auto& param : argsOf(args)) {
                 if (param)
                     statementInference(def, globalTable, param, currentTable, "auto");
             }
             return "List";
         }
-        else if (node->children[0]->value == "range") {
-            for (const auto& param : node->children[1]->children) {
+        else if (callee->value == "range") {
+            for (const auto& param : argsOf(args)) {
                 if (param)
                     statementInference(def, globalTable, param, currentTable, "Integer");
             }
             return "List";
         }
-        else if (node->children[0]->value == "len") {
-            for (const auto& param : node->children[1]->children) {
+        else if (callee->value == "len") {
+            for (const auto& param : argsOf(args)) {
                 if (param)
                     statementInference(def, globalTable, param, currentTable, "List");
             }
             return "Integer";
         }
         else {
-            // obtention TDS de fonction
-            SymbolTable* TDS;
-            for (const auto& tds : globalTable->children) {
-                if (tds->scopeName == "function " + node->children[0]->value) {
-                    TDS = tds.get();
-                    break;
-                }
-            }
-            // obtention FunctionDefinition
-            std::shared_ptr<ASTNode> FDEF;
-            for (const auto& fdef : def->children) {
-                if (fdef->value == node->children[0]->value) {
-                    FDEF = fdef;
-                    break;
+            // obtention de la FunctionDefinition et de sa TDS ; un appel déjà renommé vers une
+            // spécialisation repart de la définition générique, ses arguments ont pu changer de type
+            auto defIt = m_definitions.find(callee->nameId);
+            ASTNode* FDEF = defIt != m_definitions.end() ? defIt->second : nullptr;
+            if (auto genericIt = m_genericOf.find(callee->nameId); genericIt != m_genericOf.end()) FDEF = genericIt->second;
+            SymbolTable* TDS = FDEF ? globalTable->findFunctionScope(FDEF->value) : nullptr;
+            if (!TDS || !FDEF || !childAt(FDEF, 1) || !childAt(FDEF, 0)
+                || argsOf(args).size() != FDEF->children[0]->children.size()) {
+                // fonction inconnue ou mauvais nombre d'arguments : signalé par l'analyse sémantique
+                for (const auto& p : argsOf(args)) {
+                    if (p) statementInference(def, globalTable, p, currentTable, "auto");
                 }
+                return "auto";
             }
             // parcours paramètres
             std::vector<std::string> param_types;
             bool CREATE_NEW = false;
             int i = 0;
-            for (const auto& p : node->children[1]->children) {
+            for (const auto& p : argsOf(args)) {
                 // évaluation
                 if (p) {
                     std::string v = statementInference(def, globalTable, p, currentTable, "auto");
                     param_types.push_back(v);
 
-                    if (dynamic_cast<VariableSymbol*>(TDS->findSymbol(FDEF->children[0]->children[i]->value))->type == "auto" and v != "auto")
-                        CREATE_NEW = true;
+                    auto param = symbolAs<VariableSymbol>(TDS->findImmediateSymbol(FDEF->children[0]->children[i]->value));
+                    if (param) {
+                        dependsOn(param);
+                        if (param->type == "auto" and v != "auto")
+                            CREATE_NEW = true;
+                    }
 
                     i++;
                 }
             }
             // si AU MOINS UN param auto obtient qqch de mieux après résolution
             if (CREATE_NEW) {
-                // check if function already created
-                // parcours des fonctions
-                for (const auto& fdef : def->children) {
-                    // si même "lignée" de fonctions
-                    if (fdef->children[0] == FDEF->children[0]) {
-                        // obtenir la tds de fdef
-                        SymbolTable* fdef_tds;
-                        for (const auto& tds : globalTable->children) {
-                            if (tds->scopeName == "function " + fdef->value) {
-                                fdef_tds = tds.get();
-                                break;
-                            }
-                        }
-                        // comparer les types des paramètres
-                        int i = 0;
-                        bool all_good = true;
-                        for (const auto& param_ident : fdef->children[0]->children) {
-                            if ( dynamic_cast<VariableSymbol*>(fdef_tds->findSymbol(param_ident->value))->type != param_types[i]) {
-                                all_good = false;
-                                break;
-                            }
-
-                            i++;
-                        }
-
-                        if (all_good) {
-                            // ça y est, on peut utiliser cette fonction directement (early return)
-                            // simplement modifier l'appel actuel pour qu'il appelle cette fonction déjà existante
-                            node->children[0]->value = fdef->value;
-                            return dynamic_cast<FunctionSymbol*>(globalTable->findSymbol(fdef->value))->returnType;
-                        }
-                    }
+                // une seule spécialisation par signature de types : nom décoré, retrouvé dans le cache
+                std::string signature = specializationName(FDEF->value, param_types);
+                if (auto cached = m_specializations.find(signature); cached != m_specializations.end()) {
+                    m_arena.rename(callee, cached->second->nameId);
+                    auto fs = symbolAs<FunctionSymbol>(globalTable->findSymbol(cached->second->nameId));
+                    dependsOn(fs);
+                    return fs ? fs->returnType : "auto";
                 }
                 // sinon création nouvelle fonction : modif AST
-                // ajout FunctionDefinition
-                std::string NEW_F_NAME = FDEF->value + std::to_string(nextTableIdCounter);
-                auto new_def = std::make_shared<ASTNode>("FunctionDefinition", NEW_F_NAME);
-                new_def->children.push_back(FDEF->children[0]);
-                new_def->children.push_back(FDEF->children[1]);
-                def->children.push_back(new_def);
+                // ajout FunctionDefinition (le nom décoré ne doit masquer aucun nom du programme)
+                std::string NEW_F_NAME = signature;
+                for (int n = 2; globalTable->lookup(NEW_F_NAME); ++n) NEW_F_NAME = signature + "_" + std::to_string(n);
+                auto new_def = m_arena.makeName(NodeKind::FunctionDefinition, NEW_F_NAME, FDEF->line);
+                m_arena.append(new_def, FDEF->children[0]);
+                // corps copié : les appels qu'il contient seront renommés selon les types de cette version
+                m_arena.append(new_def, m_arena.clone(FDEF->children[1]));
+                m_arena.append(def, new_def);
+                m_definitions[new_def->nameId] = new_def;
+                m_specializations.emplace(std::move(signature), new_def);
+                m_genericOf.emplace(new_def->nameId, FDEF);
                 // modif FunctionCall
-                node->children[0]->value = NEW_F_NAME;
+                m_arena.rename(callee, NEW_F_NAME);
                 // copie TDS
                 auto TDS_copy = std::make_unique<SymbolTable>("function " + NEW_F_NAME, globalTable, nextTableIdCounter++);
-                for (const auto& symb : TDS->symbols) {
-                    TDS_copy->symbols.push_back(dynamic_cast<VariableSymbol*>(symb.get())->clone());
+                for (Symbol* symb : TDS->symbols) {
+                    if (auto vs = symbolAs<VariableSymbol>(symb)) TDS_copy->addSymbol<VariableSymbol>(*vs);
                 }
                 // upgrade les types
-                int i = 0;
+                std::size_t i = 0;
                 for (const auto& param : FDEF->children[0]->children) {
-                    dynamic_cast<VariableSymbol*>(TDS_copy->findSymbol(param->value))->type = param_types[i];
+                    if (auto vs = symbolAs<VariableSymbol>(TDS_copy->findImmediateSymbol(param->value)); vs && i < param_types.size())
+                        vs->type = param_types[i];
                     i++;
                 }
+                // le corps de la spécialisation est analysé avec ses propres types
+                enqueueBody(new_def->children[1], TDS_copy.get());
+                ++m_inferenceStats.specializations;
                 // modifie la globalTable
+                FunctionSymbol funcSymb = *symbolAs<FunctionSymbol>(globalTable->findSymbol(FDEF->value));
+                funcSymb.name = NEW_F_NAME;
+                funcSymb.scope = TDS_copy.get();
+                funcSymb.tableID = TDS_copy->tableID;
                 globalTable->children.push_back(std::move(TDS_copy));
+                globalTable->addSymbol<FunctionSymbol>(std::move(funcSymb));
+                // la spécialisation passe devant la fonction d'origine
+                std::rotate(globalTable->symbols.begin(), globalTable->symbols.end() - 1, globalTable->symbols.end());
 
-
-                auto& tmp = globalTable->symbols;
-
-
-                auto funcSymb = dynamic_cast<FunctionSymbol*>(globalTable->findSymbol(FDEF->value))->clone();
-                funcSymb->name = NEW_F_NAME;
-                tmp.insert(tmp.begin(), std::move(funcSymb)); // std::move à vérifier ?
-
-                return dynamic_cast<FunctionSymbol*>(globalTable->findSymbol(NEW_F_NAME))->returnType;
+                auto fs = symbolAs<FunctionSymbol>(globalTable->findSymbol(NEW_F_NAME));
+                dependsOn(fs);
+                return fs->returnType;
             }
             else {
-                return dynamic_cast<FunctionSymbol*>(globalTable->findSymbol(FDEF->value))->returnType;
+                if (callee->nameId != FDEF->nameId) m_arena.rename(callee, FDEF->nameId); // plus rien à spécialiser
+                auto fs = symbolAs<FunctionSymbol>(globalTable->findSymbol(FDEF->value));
+                dependsOn(fs);
+                return fs ? fs->returnType : "auto";
             }
         }
     }
@@ -747,50 +805,91 @@ std::string SymbolTableGenerator::statementInference(const std::shared_ptr<ASTNo
 
 }
 
-// TODO penser à vérifier l'existence des enfants avant d'y accéder (pour graceful shutdown si l'input est incorrect)
+void SymbolTableGenerator::enqueueBody(ASTNode* body, SymbolTable* scope) {
+    if (!body) return;
+    for (const auto& statement : body->children) {
+        if (!statement) continue;
+        m_items.push_back({statement, scope});
+        m_queued.push_back(true);
+        m_worklist.push_back(m_items.size() - 1);
+        ++m_inferenceStats.statements;
+    }
+}
 
-void SymbolTableGenerator::inferTypes(const std::shared_ptr<ASTNode>& root, SymbolTable* globalTable) {
+void SymbolTableGenerator::dependsOn(const Symbol* symbol) {
+    if (!symbol) return;
+    auto& readers = m_readers[symbol];
+    if (readers.empty() || readers.back() != m_currentItem) readers.push_back(m_currentItem);
+}
 
-    // réinitialise les types
-    for (const auto& symb : globalTable->symbols) {
-        if (FunctionSymbol* v = dynamic_cast<FunctionSymbol*>(symb.get())) {
-            v->returnType = "auto";
-        }
-        else {
-            dynamic_cast<VariableSymbol*>(symb.get())->type = "auto";
+void SymbolTableGenerator::typeChanged(const Symbol* symbol) {
+    auto it = m_readers.find(symbol);
+    if (it == m_readers.end()) return;
+    for (std::size_t item : it->second) {
+        if (!m_queued[item]) {
+            m_queued[item] = true;
+            m_worklist.push_back(item);
         }
     }
+}
 
-    for (const auto& tds : globalTable->children) {
-        for (const auto& symb : tds->symbols) {
-            dynamic_cast<VariableSymbol*>(symb.get())->type = "auto";
+void SymbolTableGenerator::inferTypes(ASTNode* root, SymbolTable* globalTable) {
+    auto start = std::chrono::steady_clock::now();
+    m_inferenceStats = {};
+    m_items.clear();
+    m_worklist.clear();
+    m_queued.clear();
+    m_readers.clear();
+    m_definitions.clear();
+    m_specializations.clear();
+    m_genericOf.clear();
+    if (!root || root->children.size() < 2) return;
+
+    // réinitialise les types
+    for (Symbol* symb : globalTable->symbols) {
+        switch (symb->kind) {
+            case SymbolKind::Function: static_cast<FunctionSymbol*>(symb)->returnType = "auto"; break;
+            case SymbolKind::Variable: static_cast<VariableSymbol*>(symb)->type = "auto"; break;
+            case SymbolKind::Array: break;
         }
     }
 
-    // 5 hard codé, peut être augmenté si nécessaire
-    for (auto i = 0; i<5; ++i) {
-
-        for (const auto& node : root->children[0]->children) {
-            if (node)
-                for (const auto& tds : globalTable->children) {
-                    if (tds->scopeName == "function " + node->value) {
-                        statementInference(root->children[0], globalTable, node->children[1], tds.get(), "auto");
-                        break;
-                    }
-                }
+    for (const auto& tds : globalTable->children) {
+        for (Symbol* symb : tds->symbols) {
+            if (auto vs = symbolAs<VariableSymbol>(symb)) vs->type = "auto";
         }
+    }
 
-        statementInference(root->children[0], globalTable, root->children[1], globalTable, "auto");
+    // Toutes les instructions sont analysées une fois (fonctions puis programme principal) ;
+    // ensuite seules celles qui ont lu un type modifié depuis sont réanalysées
+    ASTNode* definitions = root->children[0];
+    for (const auto& node : definitions->children) {
+        if (node && node->kind == NodeKind::FunctionDefinition) m_definitions.emplace(node->nameId, node);
+    }
+    for (const auto& node : definitions->children) {
+        if (!node || node->children.size() < 2) continue;
+        if (SymbolTable* tds = globalTable->findFunctionScope(node->value)) enqueueBody(node->children[1], tds);
+    }
+    enqueueBody(root->children[1], globalTable);
 
+    while (!m_worklist.empty()) {
+        m_currentItem = m_worklist.front();
+        m_worklist.pop_front();
+        m_queued[m_currentItem] = false;
+        ++m_inferenceStats.iterations;
+        // copie : statementInference peut agrandir m_items (spécialisations)
+        InferenceItem item = m_items[m_currentItem];
+        statementInference(definitions, globalTable, item.statement, item.scope, "auto");
     }
 
     // remplace les auto par autoFun
-    for (const auto& symb : globalTable->symbols) {
-        auto v = dynamic_cast<FunctionSymbol*>(symb.get());
+    for (Symbol* symb : globalTable->symbols) {
+        auto v = symbolAs<FunctionSymbol>(symb);
         if (v and v->returnType == "auto") {
             v->returnType = "autoFun";
         }
     }
 
+    m_inferenceStats.milliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 }
-
@@ -0,0 +1,68 @@
+#include "threadPool.h"
+
+ThreadPool::ThreadPool(unsigned threads) {
+    for (unsigned i = 1; i < threads; ++i) m_workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) worker.join();
+}
+
+unsigned ThreadPool::defaultThreads() {
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores ? cores : 1;
+}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& task) {
+    if (count == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_count = count;
+        m_next.store(0);
+        m_error = nullptr;
+        m_busy = static_cast<unsigned>(m_workers.size());
+        ++m_batch;
+    }
+    m_wake.notify_all();
+    drain();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_task = nullptr;
+    if (m_error) std::rethrow_exception(std::exchange(m_error, nullptr));
+}
+
+void ThreadPool::workerLoop() {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_batch != seen; });
+            if (m_stop) return;
+            seen = m_batch;
+        }
+        drain();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_busy;
+        }
+        m_done.notify_one();
+    }
+}
+
+void ThreadPool::drain() {
+    for (std::size_t i = m_next.fetch_add(1); i < m_count; i = m_next.fetch_add(1)) {
+        try {
+            (*m_task)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) m_error = std::current_exception();
+        }
+    }
+}
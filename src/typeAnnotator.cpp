@@ -0,0 +1,181 @@
+#include "typeAnnotator.h"
+#include "astQueries.h"
+
+namespace {
+
+bool isResolved(ValueType type) {
+    return type != ValueType::Auto && type != ValueType::AutoFun;
+}
+
+ValueType childType(const ASTNode* node, std::size_t i) {
+    return i < node->children.size() && node->children[i] ? node->children[i]->type : ValueType::Auto;
+}
+
+} // namespace
+
+void TypeAnnotator::annotate(ASTNode* root, const SymbolTable* globalTable) {
+    m_global = globalTable;
+    m_scope = globalTable;
+    m_function = Interner::kNoId;
+    m_types.clear();
+    m_firstReturn.clear();
+    m_annotated = 0;
+    if (root && globalTable) visit(root);
+}
+
+void TypeAnnotator::visit(ASTNode* node) {
+    if (!node) return;
+
+    switch (node->kind) {
+    case NodeKind::FunctionDefinition: {
+        const SymbolTable* previousScope = m_scope;
+        Interner::Id previousFunction = m_function;
+        if (const SymbolTable* scope = m_global->findFunctionScope(node->value)) m_scope = scope;
+        m_function = idOf(node);
+        for (ASTNode* child : node->children) visit(child);
+        m_scope = previousScope;
+        m_function = previousFunction;
+        break;
+    }
+    case NodeKind::Affect: {
+        if (node->children.size() < 2) break;
+        ASTNode* target = node->children[0];
+        visit(node->children[1]);
+        if (target && target->kind == NodeKind::ListCall) {
+            visit(target);
+        } else if (target) {
+            assign(target, node->children[1] ? node->children[1]->type : ValueType::Auto);
+            visit(target);
+        }
+        break;
+    }
+    case NodeKind::Return:
+        for (ASTNode* child : node->children) visit(child);
+        if (m_function != Interner::kNoId && !node->children.empty() && node->children[0]) {
+            m_firstReturn.emplace(m_function, node->children[0]->type);
+        }
+        break;
+    case NodeKind::FunctionCall:
+        visitCall(node);
+        break;
+    case NodeKind::None:
+    case NodeKind::Negative:
+        m_errorManager.addError({"Cannot determine expression type for node type: ", nodeKindName(node->kind), "Typing", node->line});
+        for (ASTNode* child : node->children) visit(child);
+        break;
+    default:
+        for (ASTNode* child : node->children) visit(child);
+        break;
+    }
+
+    node->type = expressionType(node);
+    ++m_annotated;
+}
+
+// Arguments évalués de droite à gauche comme dans le code émis, puis typage des paramètres de l'appelé
+void TypeAnnotator::visitCall(ASTNode* node) {
+    if (node->children.empty()) return;
+    ASTNode* callee = node->children[0];
+    visit(callee);
+    if (node->children.size() < 2 || !node->children[1]) return;
+
+    ASTNode* args = node->children[1];
+    for (auto it = args->children.rbegin(); it != args->children.rend(); ++it) visit(*it);
+
+    if (callee && callee->kind == NodeKind::Identifier && !isBuiltin(callee->value)) {
+        bindArguments(symbolAs<FunctionSymbol>(m_global->findSymbol(idOf(callee))), args->children);
+    }
+}
+
+ValueType TypeAnnotator::expressionType(const ASTNode* node) {
+    switch (node->kind) {
+    case NodeKind::Integer: return ValueType::Integer;
+    case NodeKind::String: return ValueType::String;
+    case NodeKind::True:
+    case NodeKind::False: return ValueType::Boolean;
+    case NodeKind::Identifier: return identifierType(node);
+    case NodeKind::FunctionCall:
+        if (!node->children.empty() && node->children[0] && node->children[0]->kind == NodeKind::Identifier) {
+            return returnType(node->children[0]);
+        }
+        return ValueType::AutoFun;
+    case NodeKind::List: return ValueType::List;
+    case NodeKind::ListCall: return ValueType::Integer;
+    case NodeKind::ArithOp:
+    case NodeKind::TermOp: {
+        ValueType left = childType(node, 0);
+        if (node->children.size() > 1 && node->value == "+") {
+            ValueType right = childType(node, 1);
+            if (left == ValueType::String || right == ValueType::String) return ValueType::String;
+            if (left == ValueType::List || right == ValueType::List) return ValueType::List;
+        }
+        return left != ValueType::Auto ? left : ValueType::Integer;
+    }
+    case NodeKind::Compare:
+    case NodeKind::And:
+    case NodeKind::Or:
+    case NodeKind::Not: return ValueType::Boolean;
+    case NodeKind::UnaryOp: return node->children.empty() ? ValueType::Integer : childType(node, 0);
+    default: return ValueType::Auto;
+    }
+}
+
+ValueType TypeAnnotator::identifierType(const ASTNode* node) {
+    const Symbol* sym = m_scope->findSymbol(idOf(node));
+    if (!sym) return ValueType::Auto;
+    switch (sym->kind) {
+    case SymbolKind::Variable: return variableType(static_cast<const VariableSymbol*>(sym));
+    case SymbolKind::Function: return valueTypeOf(static_cast<const FunctionSymbol*>(sym)->returnType);
+    case SymbolKind::Array: return ValueType::List;
+    }
+    return ValueType::Auto;
+}
+
+// Type de retour d'un appel : celui inféré par la table des symboles, sinon celui du premier return de l'appelé
+ValueType TypeAnnotator::returnType(const ASTNode* callee) {
+    if (callee->value == "len") return ValueType::Integer;
+    if (callee->value == "print") return ValueType::Void;
+    if (callee->value == "list" || callee->value == "range") return ValueType::List;
+
+    Interner::Id id = idOf(callee);
+    if (auto fs = symbolAs<FunctionSymbol>(m_global->findSymbol(id))) {
+        if (fs->returnType != "autoFun" && !fs->returnType.empty()) return valueTypeOf(fs->returnType);
+    }
+    auto it = m_firstReturn.find(id);
+    return it != m_firstReturn.end() ? it->second : ValueType::Integer;
+}
+
+ValueType TypeAnnotator::variableType(const VariableSymbol* var) const {
+    auto it = m_types.find(var);
+    return it != m_types.end() ? it->second : valueTypeOf(var->type);
+}
+
+Interner::Id TypeAnnotator::idOf(const ASTNode* node) const {
+    return node->hasName() ? node->nameId : m_global->names->find(node->value);
+}
+
+// Une variable encore sans type prend celui de sa première affectation
+void TypeAnnotator::assign(const ASTNode* target, ValueType type) {
+    if (!isResolved(type)) return;
+    Interner::Id id = idOf(target);
+    for (const SymbolTable* table = m_scope; table; table = table->parent) {
+        if (const VariableSymbol* var = symbolAs<VariableSymbol>(table->findImmediateSymbol(id))) {
+            if (!isResolved(variableType(var))) m_types[var] = type;
+            return;
+        }
+    }
+}
+
+// Les paramètres encore sans type prennent celui des arguments du premier appel rencontré
+void TypeAnnotator::bindArguments(const FunctionSymbol* callee, const NodeList& args) {
+    if (!callee || !callee->scope) return;
+    std::size_t argIdx = 0;
+    for (const Symbol* sym : callee->scope->symbols) {
+        if (argIdx >= args.size()) break;
+        auto param = symbolAs<VariableSymbol>(sym);
+        if (!param) continue;
+        ValueType argType = args[argIdx] ? args[argIdx]->type : ValueType::Auto;
+        if (variableType(param) == ValueType::Auto && argType != ValueType::Auto) m_types[param] = argType;
+        ++argIdx;
+    }
+}
@@ -0,0 +1,217 @@
+#include "valueNumbering.h"
+#include <algorithm>
+
+namespace {
+
+bool mentions(const ASTNode* node, Interner::Id name) {
+    if (!node) return false;
+    if (node->kind == NodeKind::Identifier && node->nameId == name) return true;
+    return std::any_of(node->children.begin(), node->children.end(), [name](const ASTNode* child) { return mentions(child, name); });
+}
+
+} // namespace
+
+void ValueNumbering::run(ASTNode* root) {
+    m_reused = 0;
+    m_temporaries = 0;
+    if (!root) return;
+    m_pure = analysePurity(m_globals, m_callGraph);
+
+    Unit mainUnit;
+    mainUnit.scope = &m_globals;
+    for (ASTNode* child : root->children) {
+        if (!child) continue;
+        if (child->kind != NodeKind::Definitions) {
+            if (!isBlock(child)) continue;
+            m_values.clear();
+            Available available;
+            numberBlock(child, available, mainUnit);
+            continue;
+        }
+        for (ASTNode* def : child->children) {
+            if (!def || def->kind != NodeKind::FunctionDefinition || def->children.size() < 2 || !def->children[1]) continue;
+            if (!m_callGraph.reachable(def->nameId)) continue; // ne sera pas générée
+            Unit unit;
+            if (!enterFunction(unit, m_globals, def)) continue;
+            m_values.clear();
+            Available available;
+            numberBlock(def->children[1], available, unit);
+        }
+    }
+}
+
+void ValueNumbering::numberBlock(ASTNode* block, Available& available, Unit& unit) {
+    for (std::size_t i = 0; i < block->children.size(); ++i) {
+        ASTNode* statement = block->children[i];
+        if (!statement) continue;
+        numberStatement(statement, block, available, unit);
+        // Les temporaires affectées avant l'instruction l'ont décalée
+        while (block->children[i] != statement) ++i;
+    }
+}
+
+void ValueNumbering::numberStatement(ASTNode* statement, ASTNode* block, Available& available, Unit& unit) {
+    if (isBlock(statement)) {
+        numberBlock(statement, available, unit);
+        return;
+    }
+    Context context;
+    context.block = block;
+    context.anchor = statement;
+    NodeList& children = statement->children;
+    Kills kills;
+
+    switch (statement->kind) {
+    case NodeKind::Affect:
+        // La cible n'est pas visitée : pendant l'évaluation de l'indice, le générateur garde
+        // l'adresse de la liste dans rbx
+        if (children.size() < 2) return;
+        numberExpression(children[1], context, available, unit);
+        collectWrites(statement, m_callGraph, m_pure, kills);
+        kill(available, kills);
+        return;
+    case NodeKind::Print:
+        for (ASTNode*& arg : children) {
+            if (!arg) continue;
+            numberExpression(arg, context, available, unit);
+            context.clean = false; // l'argument est déjà affiché
+        }
+        return;
+    case NodeKind::If:
+        if (children.empty()) return;
+        numberExpression(children[0], context, available, unit);
+        for (std::size_t b = 1; b < children.size(); ++b) {
+            if (!children[b]) continue;
+            Available inner = available;
+            numberBlock(children[b], inner, unit);
+            collectWrites(children[b], m_callGraph, m_pure, kills);
+        }
+        kill(available, kills);
+        return;
+    case NodeKind::While:
+        // La condition est réévaluée à chaque tour : elle réutilise, mais ne se sort pas de la boucle
+        collectWrites(statement, m_callGraph, m_pure, kills);
+        kill(available, kills);
+        context.hoistable = false;
+        if (!children.empty()) numberExpression(children[0], context, available, unit);
+        if (children.size() > 1 && children[1]) {
+            Available inner = available;
+            numberBlock(children[1], inner, unit);
+        }
+        return;
+    case NodeKind::For: {
+        if (children.size() < 3 || !children[0] || !children[1]) return;
+        ASTNode* iterable = children[1];
+        const NodeList* rangeArgs = isCallTo(iterable, "range") ? argumentsOf(iterable) : nullptr;
+        if (rangeArgs && rangeArgs->size() == 1) {
+            // range(n) : la variable vaut déjà 0 quand n est évalué
+            Kills loopVar;
+            loopVar.variables.push_back(children[0]->nameId);
+            kill(available, loopVar);
+            context.hoistable = !mentions((*rangeArgs)[0], children[0]->nameId);
+            if (!isIndexRange(iterable)) numberExpression((*rangeArgs)[0], context, available, unit);
+        } else {
+            numberExpression(children[1], context, available, unit);
+        }
+        collectWrites(statement, m_callGraph, m_pure, kills);
+        kill(available, kills);
+        if (children[2]) {
+            Available inner = available;
+            numberBlock(children[2], inner, unit);
+        }
+        return;
+    }
+    case NodeKind::Return:
+        if (!children.empty()) numberExpression(children[0], context, available, unit);
+        return;
+    default: {
+        // Expression utilisée comme instruction (appel) : seuls ses opérandes peuvent resservir
+        if (isReusableExpression(statement)) return;
+        ASTNode* expression = statement;
+        numberExpression(expression, context, available, unit);
+        return;
+    }
+    }
+}
+
+void ValueNumbering::numberExpression(ASTNode*& slot, Context& context, Available& available, Unit& unit) {
+    ASTNode* node = slot;
+    if (!node) return;
+
+    bool registered = false;
+    if (isReusableExpression(node)) {
+        std::string key;
+        Value value;
+        structureKey(node, key, &value.reads);
+        auto it = available.find(key);
+        if (it != available.end()) {
+            reuse(slot, it->second, unit);
+            return;
+        }
+        // Sortie avant l'instruction, elle s'évaluerait au même moment par rapport à ses effets
+        if (context.clean && !context.conditional && context.hoistable) {
+            std::size_t v = m_values.size();
+            for (std::size_t open : m_open) m_values[open].inner.push_back(v);
+            value.slot = &slot;
+            value.block = context.block;
+            value.anchor = context.anchor;
+            m_values.push_back(std::move(value));
+            available.emplace(std::move(key), v);
+            m_open.push_back(v);
+            registered = true;
+        }
+    }
+
+    forEachOperand(node, [&](ASTNode*& operand, bool conditional) {
+        bool outer = context.conditional;
+        context.conditional = outer || conditional;
+        numberExpression(operand, context, available, unit);
+        context.conditional = outer;
+    });
+    if (registered) m_open.pop_back();
+
+    if (mayPrintOrStop(node)) context.clean = false;
+    if (isImpureCall(node, m_callGraph, m_pure)) {
+        Kills kills;
+        kills.lists = true;
+        kill(available, kills);
+    }
+}
+
+// La première occurrence passe dans une temporaire, affectée juste avant son instruction
+void ValueNumbering::reuse(ASTNode*& slot, std::size_t v, Unit& unit) {
+    Value& value = m_values[v];
+    if (value.temporary == Interner::kNoId) {
+        value.temporary = addTemporary(unit, m_arena.names(), "cse", m_nextTemporary);
+        ASTNode* expression = *value.slot;
+        ASTNode* read = m_arena.makeName(NodeKind::Identifier, value.temporary, expression->line);
+        read->type = expression->type;
+        *value.slot = read;
+
+        ASTNode* target = m_arena.makeName(NodeKind::Identifier, value.temporary, expression->line);
+        target->type = expression->type;
+        ASTNode* assign = m_arena.make(NodeKind::Affect, expression->line);
+        m_arena.append(assign, target);
+        m_arena.append(assign, expression);
+        const NodeList& statements = value.block->children;
+        std::size_t index = static_cast<std::size_t>(std::find(statements.begin(), statements.end(), value.anchor) - statements.begin());
+        m_arena.insert(value.block, index, assign);
+        // Ce qui était calculé dans l'expression l'est désormais dans l'affectation
+        for (std::size_t inner : value.inner) {
+            m_values[inner].block = value.block;
+            m_values[inner].anchor = assign;
+        }
+        ++m_temporaries;
+    }
+    ASTNode* read = m_arena.makeName(NodeKind::Identifier, value.temporary, slot->line);
+    read->type = slot->type;
+    slot = read;
+    ++m_reused;
+}
+
+void ValueNumbering::kill(Available& available, const Kills& kills) const {
+    if (kills.variables.empty() && !kills.lists) return;
+    std::erase_if(available, [&](const auto& entry) {
+        return changes(kills, m_values[entry.second].reads);
+    });
+}